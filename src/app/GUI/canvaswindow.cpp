@@ -45,6 +45,9 @@
 #include "eevent.h"
 #include "glhelpers.h"
 #include "themesupport.h"
+#include "Tasks/metricsregistry.h"
+
+bool CanvasWindow::sShowMetrics = false;
 
 CanvasWindow::CanvasWindow(Document &document,
                            QWidget * const parent)
@@ -87,6 +90,7 @@ void CanvasWindow::setCurrentCanvas(const int id)
 void CanvasWindow::setCurrentCanvas(Canvas * const canvas)
 {
     if (mCurrentCanvas == canvas) { return; }
+    if (canvas) { canvas->loadDeferredContent(); }
     if (mCurrentCanvas) {
         if (isVisible()) { mDocument.removeVisibleScene(mCurrentCanvas); }
     }
@@ -194,6 +198,141 @@ void CanvasWindow::renderSk(SkCanvas * const canvas)
                                         height() * pixelRatio),
                          paint);
     }
+
+    if (sShowMetrics) { drawMetrics(canvas); }
+}
+
+void CanvasWindow::sSetMetricsVisible(const bool visible)
+{
+    sShowMetrics = visible;
+}
+
+static QString percent(const qreal value)
+{
+    return QString("%1%").arg(qRound(100*value));
+}
+
+static QString accPreferenceName(const AccPreference preference)
+{
+    switch (preference) {
+    case AccPreference::cpuStrongPreference: return "strong cpu";
+    case AccPreference::cpuSoftPreference: return "soft cpu";
+    case AccPreference::gpuSoftPreference: return "soft gpu";
+    case AccPreference::gpuStrongPreference: return "strong gpu";
+    default: return "default";
+    }
+}
+
+static QString utilization(const MetricsRegistry::Snapshot& metrics,
+                           const QString& executor,
+                           const int threads)
+{
+    const QString prefix = "executor." + executor;
+    const qreal busy = metrics.rate(prefix + ".busy_us")/1000000.;
+    const auto step = metrics.find(prefix + ".step_us");
+    QString result = QString("%1 %2 busy, %3 tasks/s, %4 waiting").
+            arg(executor.toUpper(),
+                percent(busy/qMax(1, threads)),
+                QString::number(metrics.rate(prefix + ".tasks"), 'f', 1),
+                QString::number(metrics.value(prefix + ".waiting")));
+    if (step && step->fCount > 0) {
+        result += QString(", step p95 %1 ms").
+                arg(step->fP95/1000., 0, 'f', 1);
+    }
+    return result;
+}
+
+void CanvasWindow::drawMetrics(SkCanvas * const canvas)
+{
+    const auto metrics = MetricsRegistry::sLatest();
+    const auto& settings = eSettings::instance();
+    QStringList lines;
+
+    const int cpuThreads = metrics.value("executor.cpu.threads");
+    lines << utilization(metrics, "cpu", cpuThreads) +
+             QString(", %1 threads").arg(cpuThreads);
+    lines << utilization(metrics, "gpu", 1);
+    lines << utilization(metrics, "hdd", 1) +
+             QString(", spill %1 MB/s, reload %2 MB/s").
+             arg(metrics.rate("hdd.spill_bytes")/1048576., 0, 'f', 1).
+             arg(metrics.rate("hdd.reload_bytes")/1048576., 0, 'f', 1);
+
+    QStringList ques;
+    const int queSlots = metrics.value("scheduler.que_slots");
+    for (int i = 0; i < queSlots; i++) {
+        const int qued = metrics.value(QString("scheduler.que%1.qued").arg(i));
+        if (qued > 0) { ques << QString::number(qued); }
+    }
+    lines << QString("Ques %1 [%2], hdd qued %3").
+             arg(metrics.value("scheduler.ques")).
+             arg(ques.join(' ')).
+             arg(metrics.value("scheduler.hdd_qued"));
+
+    QStringList caches;
+    for (const auto& sample : metrics.fSamples) {
+        if (!sample.fName.startsWith("cache.") ||
+            !sample.fName.endsWith(".hits")) { continue; }
+        const QString cache = sample.fName.chopped(5);
+        const qreal hits = sample.fRate;
+        const qreal misses = metrics.rate(cache + ".misses");
+        if (hits + misses <= 0) { continue; }
+        caches << QString("%1 %2").arg(cache.mid(6),
+                                       percent(hits/(hits + misses)));
+    }
+    if (!caches.isEmpty()) { lines << "Cache hits " + caches.join(", "); }
+
+    const int ramCap = settings.fRamMBCap.fValue;
+    lines << QString("Memory %1 MB used, %2 MB free, cap %3, "
+                     "%4 evictions/s").
+             arg(metrics.value("memory.used_mb")).
+             arg(metrics.value("memory.free_mb")).
+             arg(ramCap > 0 ? QString("%1 MB").arg(ramCap) : QString("80%")).
+             arg(metrics.rate("memory.evictions"), 0, 'f', 1);
+
+    const qreal fps = metrics.rate("preview.frames");
+    const qreal dropped = metrics.rate("preview.dropped");
+    if (fps + dropped > 0) {
+        lines << QString("Preview %1 fps, %2 dropped/s").
+                 arg(fps, 0, 'f', 1).arg(dropped, 0, 'f', 1);
+    }
+
+    const int threadsCap = settings.fCpuThreadsCap;
+    lines << QString("Threads cap %1, acceleration preference %2").
+             arg(threadsCap > 0 ? QString::number(threadsCap) : QString("off"),
+                 accPreferenceName(settings.fAccPreference));
+
+    const qreal pixelRatio = devicePixelRatioF();
+    SkFont font;
+    font.setSize(eSizesUI::font*pixelRatio);
+    const auto fontStyle = SkFontStyle(SkFontStyle::kNormal_Weight,
+                                       SkFontStyle::kNormal_Width,
+                                       SkFontStyle::kUpright_Slant);
+    font.setTypeface(SkTypeface::MakeFromName(nullptr, fontStyle));
+
+    const float lineHeight = font.getSpacing();
+    const float margin = eSizesUI::widget*0.25f*pixelRatio;
+    float textWidth = 0;
+    QList<std::string> texts;
+    for (const auto& line : lines) {
+        texts << line.toStdString();
+        const auto& text = texts.last();
+        textWidth = qMax(textWidth, font.measureText(text.c_str(), text.size(),
+                                                     SkTextEncoding::kUTF8));
+    }
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(SkColorSetARGB(180, 0, 0, 0));
+    canvas->drawRect(SkRect::MakeXYWH(margin, margin,
+                                      textWidth + 2*margin,
+                                      lines.count()*lineHeight + 2*margin),
+                     paint);
+    paint.setColor(SK_ColorWHITE);
+    float y = 2*margin;
+    for (const auto& text : texts) {
+        y += lineHeight;
+        canvas->drawString(text.c_str(), 2*margin, y - margin, font, paint);
+    }
 }
 
 void CanvasWindow::tabletEvent(QTabletEvent *e)
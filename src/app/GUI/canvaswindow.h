@@ -99,6 +99,9 @@ public:
     void writeStateXEV(QDomElement& ele,
                        QDomDocument& doc) const;
 
+    static bool sMetricsVisible() { return sShowMetrics; }
+    static void sSetMetricsVisible(const bool visible);
+
 protected:
     bool event(QEvent *e);
 
@@ -148,8 +151,11 @@ private:
     //void paintEvent(QPaintEvent *);
 
     void renderSk(SkCanvas * const canvas);
+    void drawMetrics(SkCanvas * const canvas);
     void tabletEvent(QTabletEvent *e);
 
+    static bool sShowMetrics;
+
     bool handleCanvasModeChangeKeyPress(QKeyEvent *event);
     bool handleCutCopyPasteKeyPress(QKeyEvent *event);
     bool handleTransformationKeyPress(QKeyEvent *event);
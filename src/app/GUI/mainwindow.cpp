@@ -44,6 +44,7 @@
 
 #include "dialogs/applyexpressiondialog.h"
 #include "dialogs/markereditordialog.h"
+#include "dialogs/renderprofilerdialog.h"
 #include "timelinedockwidget.h"
 #include "canvaswindow.h"
 #include "GUI/BoxesList/boxscrollwidget.h"
@@ -69,7 +70,9 @@
 #include "efiltersettings.h"
 #include "Settings/settingsdialog.h"
 #include "appsupport.h"
+#include "Tasks/metricsregistry.h"
 #include "themesupport.h"
+#include "ReadWrite/projectsaver.h"
 
 #include "widgets/assetswidget.h"
 #include "dialogs/adjustscenedialog.h"
@@ -127,6 +130,7 @@ MainWindow::MainWindow(Document& document,
     , mLayoutHandler(nullptr)
     , mFillStrokeSettings(nullptr)
     , mChangedSinceSaving(false)
+    , mDocumentChangeId(0)
     , mEventFilterDisabled(false)
     , mGrayOutWidget(nullptr)
     , mDisplayedFillStrokeSettingsUpdateNeeded(false)
@@ -189,6 +193,7 @@ MainWindow::~MainWindow()
     disconnect();
     mShutdown = true;
     if (mAutoSaveTimer->isActive()) { mAutoSaveTimer->stop(); }
+    ProjectSaver::sFinishAll();
     writeSettings();
     sInstance = nullptr;
 }
@@ -495,6 +500,7 @@ void MainWindow::setupDocument()
             this, &MainWindow::handleNewVideoClip);
     connect(&mDocument, &Document::documentChanged,
             this, [this]() {
+        mDocumentChangeId++;
         setFileChangedSinceSaving(true);
         if (mTimeline) { mTimeline->stopPreview(); }
     });
@@ -702,7 +708,10 @@ bool MainWindow::eventFilter(QObject *obj, QEvent *e)
 void MainWindow::closeEvent(QCloseEvent *e)
 {
     if (!closeProject()) { e->ignore(); }
-    else { mShutdown = true; }
+    else {
+        mShutdown = true;
+        ProjectSaver::sFinishAll();
+    }
 }
 
 bool MainWindow::processKeyEvent(QKeyEvent *event)
@@ -900,6 +909,33 @@ void MainWindow::setupMemoryWidgets()
     const auto handler = MemoryHandler::sInstance;
     connect(handler, &MemoryHandler::memoryUsed,
             this, [this](intMB used) { mMemoryUsed = used; });
+
+    const auto metricsTimer = new QTimer(this);
+    connect(metricsTimer, &QTimer::timeout,
+            this, [this]() {
+        MetricsRegistry::sTick();
+        if (mShutdown || !CanvasWindow::sMetricsVisible()) { return; }
+        for (const auto& it : mDocument.fVisibleScenes) {
+            emit it.first->requestUpdate();
+        }
+    });
+    metricsTimer->start(1000);
+}
+
+void MainWindow::saveMetrics()
+{
+    const QString path = AppSupport::getSaveFile(this,
+                                                 tr("Save Performance Metrics"),
+                                                 QDir::homePath() +
+                                                 "/friction-metrics.csv",
+                                                 tr("CSV (*.csv)"),
+                                                 "csv");
+    if (path.isEmpty()) { return; }
+    if (!MetricsRegistry::sDump(path)) {
+        QMessageBox::warning(this,
+                             tr("Save failed"),
+                             tr("Could not write %1").arg(path));
+    }
 }
 
 void MainWindow::setupPropertiesWidgets()
@@ -1101,19 +1137,21 @@ void MainWindow::saveFile(const QString& path,
         QFileInfo fi(path);
         const QString suffix = fi.suffix();
         if (suffix == "friction") {
-            saveToFile(path);
+            // the backup is written with the same data
+            QStringList copies;
+            if (mBackupOnSave) {
+                qDebug() << "auto backup";
+                const QString backup = nextBackupPath(setPath ? path : mDocument.fEvFile);
+                if (!backup.isEmpty()) { copies << backup; }
+            }
+            saveToFile(path, true, true, copies);
         } /*else if (suffix == "xev") {
             saveToFileXEV(path);
             const auto& inst = DialogsInterface::instance();
             inst.displayMessageToUser("Please note that the XEV format is still in the testing phase.");
         }*/ else { RuntimeThrow("Unrecognized file extension " + suffix); }
         if (setPath) mDocument.setPath(path);
-        setFileChangedSinceSaving(false);
         updateLastSaveDir(path);
-        if (mBackupOnSave) {
-            qDebug() << "auto backup";
-            saveBackup();
-        }
     } catch(const std::exception& e) {
         gPrintExceptionCritical(e);
     }
@@ -1137,23 +1175,27 @@ void MainWindow::saveFileAs(const bool setPath)
 
 void MainWindow::saveBackup()
 {
-    const QString defPath = mDocument.fEvFile;
-    QFileInfo defInfo(defPath);
-    if (defPath.isEmpty() || defInfo.isDir())  { return; }
-    const QString backupPath = defPath + "_backup/backup_%1.friction";
-    int id = 1;
-    QFile backupFile(backupPath.arg(id));
-    while (backupFile.exists()) {
-        id++;
-        backupFile.setFileName(backupPath.arg(id) );
-    }
+    const QString backupPath = nextBackupPath(mDocument.fEvFile);
+    if (backupPath.isEmpty()) { return; }
     try {
-        saveToFile(backupPath.arg(id), false);
+        saveToFile(backupPath, false);
     } catch(const std::exception& e) {
         gPrintExceptionCritical(e);
     }
 }
 
+const QString MainWindow::nextBackupPath(const QString &projectPath) const
+{
+    QFileInfo info(projectPath);
+    if (projectPath.isEmpty() || info.isDir())  { return QString(); }
+    const QString backupPath = projectPath + "_backup/backup_%1.friction";
+    int id = 1;
+    // ids of backups still being written are taken as well
+    while (QFile::exists(backupPath.arg(id)) ||
+           ProjectSaver::sIsPending(backupPath.arg(id))) { id++; }
+    return backupPath.arg(id);
+}
+
 const QString MainWindow::checkBeforeExportSVG()
 {
     QStringList result;
@@ -1384,6 +1426,13 @@ void MainWindow::openMarkerEditor()
     dialog->show();
 }
 
+void MainWindow::openRenderProfiler()
+{
+    const auto dialog = new Ui::RenderProfilerDialog(this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->show();
+}
+
 void MainWindow::openExpressionDialog(QrealAnimator * const target)
 {
     if (!target) { return; }
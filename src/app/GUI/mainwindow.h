@@ -102,7 +102,9 @@ public:
 
     FillStrokeSettingsWidget *getFillStrokeSettings();
     void saveToFile(const QString &path,
-                    const bool addRecent = true);
+                    const bool addRecent = true,
+                    const bool markSaved = false,
+                    const QStringList &copies = QStringList());
     void saveToFileXEV(const QString& path);
     void loadEVFile(const QString &path);
     void loadXevFile(const QString &path);
@@ -165,6 +167,7 @@ public:
                   const bool setPath = true);
     void saveFileAs(const bool setPath = true);
     void saveBackup();
+    const QString nextBackupPath(const QString &projectPath) const;
     const QString checkBeforeExportSVG();
     void exportSVG(const bool &preview = false);
     void updateLastOpenDir(const QString &path);
@@ -184,6 +187,8 @@ public:
     void focusFontWidget(const bool focus = true);
     void focusColorWidget();
     void openMarkerEditor();
+    void openRenderProfiler();
+    void saveMetrics();
     void openExpressionDialog(QrealAnimator* const target);
     void openApplyExpressionDialog(QrealAnimator* const target);
 
@@ -303,6 +308,7 @@ private:
     FillStrokeSettingsWidget *mFillStrokeSettings;
 
     bool mChangedSinceSaving;
+    uint mDocumentChangeId;
     bool mEventFilterDisabled;
     bool isEnabled();
     QWidget *mGrayOutWidget;
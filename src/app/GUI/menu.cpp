@@ -25,6 +25,7 @@
 #include "GUI/Settings/settingsdialog.h"
 #include "GUI/timelinedockwidget.h"
 #include "dialogs/commandpalette.h"
+#include "canvaswindow.h"
 #include "memoryhandler.h"
 #include "misc/noshortcutaction.h"
 #include "dialogs/scenesettingsdialog.h"
@@ -679,6 +680,58 @@ void MainWindow::setupMenuBar()
             });
     cmdAddAction(previewCacheAct);
 
+    const auto adaptivePreviewAct = mViewMenu->addAction(tr("Adaptive Preview Resolution"));
+    adaptivePreviewAct->setCheckable(true);
+    adaptivePreviewAct->setChecked(eSettings::instance().fAdaptivePreview);
+    connect(adaptivePreviewAct, &QAction::triggered,
+            this, [this, adaptivePreviewAct]() {
+                const bool checked = adaptivePreviewAct->isChecked();
+                eSettings::sInstance->fAdaptivePreview = checked;
+                eSettings::sInstance->saveKeyToFile("AdaptivePreview");
+                statusBar()->showMessage(tr("%1 Adaptive Preview Resolution").arg(checked ?
+                                                                                      tr("Enabled") :
+                                                                                      tr("Disabled")),
+                                         5000);
+            });
+    cmdAddAction(adaptivePreviewAct);
+
+    const auto streamingPreviewAct = mViewMenu->addAction(tr("Streaming Preview"));
+    streamingPreviewAct->setCheckable(true);
+    streamingPreviewAct->setChecked(eSettings::instance().fStreamingPreview);
+    connect(streamingPreviewAct, &QAction::triggered,
+            this, [this, streamingPreviewAct]() {
+                const bool checked = streamingPreviewAct->isChecked();
+                eSettings::sInstance->fStreamingPreview = checked;
+                eSettings::sInstance->saveKeyToFile("StreamingPreview");
+                statusBar()->showMessage(tr("%1 Streaming Preview").arg(checked ?
+                                                                        tr("Enabled") :
+                                                                        tr("Disabled")),
+                                         5000);
+            });
+    cmdAddAction(streamingPreviewAct);
+
+    const auto renderProfilerAct = mViewMenu->addAction(tr("Render Profiler"));
+    connect(renderProfilerAct, &QAction::triggered,
+            this, &MainWindow::openRenderProfiler);
+    cmdAddAction(renderProfilerAct);
+
+    const auto metricsOverlayAct = mViewMenu->addAction(tr("Performance Overlay"));
+    metricsOverlayAct->setCheckable(true);
+    metricsOverlayAct->setChecked(CanvasWindow::sMetricsVisible());
+    connect(metricsOverlayAct, &QAction::triggered,
+            this, [this](const bool checked) {
+                CanvasWindow::sSetMetricsVisible(checked);
+                for (const auto& it : mDocument.fVisibleScenes) {
+                    emit it.first->requestUpdate();
+                }
+            });
+    cmdAddAction(metricsOverlayAct);
+
+    const auto saveMetricsAct = mViewMenu->addAction(tr("Save Performance Metrics ..."));
+    connect(saveMetricsAct, &QAction::triggered,
+            this, &MainWindow::saveMetrics);
+    cmdAddAction(saveMetricsAct);
+
     mViewMenu->addSeparator();
 
     mRasterEffectsVisible = mViewMenu->addAction(
@@ -313,6 +313,7 @@ TimelineWidget::~TimelineWidget()
 
 void TimelineWidget::setCurrentScene(Canvas * const scene) {
     if(scene == mCurrentScene) return;
+    if(scene) scene->loadDeferredContent();
     if(mCurrentScene) {
         disconnect(mCurrentScene, nullptr, mFrameScrollBar, nullptr);
         disconnect(mCurrentScene, nullptr, this, nullptr);
@@ -56,6 +56,7 @@
 #include "GUI/canvaswindow.h"
 #include "gradientwidgets/gradientwidget.h"
 #include <QMessageBox>
+#include <QBuffer>
 #include "PathEffects/patheffectsinclude.h"
 #include "Boxes/internallinkcanvas.h"
 #include "Boxes/smartvectorpath.h"
@@ -68,11 +69,16 @@
 #include "ReadWrite/evformat.h"
 #include "ReadWrite/ereadstream.h"
 #include "ReadWrite/ewritestream.h"
+#include "ReadWrite/projectsaver.h"
+#include "ReadWrite/projectwriter.h"
 #include "XML/runtimewriteid.h"
 #include "dialogs/askdialog.h"
 
 void MainWindow::loadEVFile(const QString &path)
 {
+    // a save of this very file might still be pending
+    ProjectSaver::sFinishAll();
+
     QFile file(path);
     if (!file.exists()) { RuntimeThrow("File does not exist " + path); }
     if (!file.open(QIODevice::ReadOnly)) {
@@ -104,36 +110,21 @@ void MainWindow::loadEVFile(const QString &path)
                                          false);
         }
 
-        eReadStream readStream(evVersion, &file);
-        readStream.setPath(path);
-
+        // read from memory, so that scenes deferred by
+        // Document::readScenes can be read later without the file
         const qint64 savedPos = file.pos();
-        const qint64 pos = file.size() - FileFooter::sSize(evVersion) -
-                qint64(sizeof(int));
-        file.seek(pos);
-        readStream.readFutureTable();
-        file.seek(savedPos);
-        readStream.readCheckpoint("File beginning pos mismatch");
-        if(evVersion >= EvFormat::betterSWTAbsReadWrite) {
-            int nScenes; readStream >> nScenes;
-            for(int i = 0; i < nScenes; i++) {
-                const bool beforeContent = (evVersion >= EvFormat::readSceneSettingsBeforeContent);
-                const auto scene = mDocument.createNewScene(!beforeContent);
-                if (beforeContent) {
-                    scene->readSettings(readStream);
-                    mDocument.sceneCreated(scene);
-                }
-            }
-            mLayoutHandler->read(readStream);
-            readStream.readCheckpoint("Error reading Layout");
-        }
-        mDocument.readScenes(readStream);
-        readStream.readCheckpoint("Error reading Document");
-        if(evVersion >= EvFormat::betterSWTAbsReadWrite) {
-            //const auto renderWidget = mTimeline->getRenderWidget();
-            mRenderWidget->read(readStream);
-            readStream.readCheckpoint("Error reading Render Widget");
-        }
+        file.seek(0);
+        QBuffer buffer;
+        buffer.setData(file.readAll());
+        buffer.open(QIODevice::ReadOnly);
+        buffer.seek(savedPos);
+
+        mDocument.readProject(buffer, evVersion, path,
+                              [this](eReadStream& src) {
+            mLayoutHandler->read(src);
+        }, [this](eReadStream& src) {
+            mRenderWidget->read(src);
+        });
     } catch(...) {
         file.close();
         RuntimeThrow("Error while reading from file " + path);
@@ -144,52 +135,44 @@ void MainWindow::loadEVFile(const QString &path)
 }
 
 void MainWindow::saveToFile(const QString &path,
-                            const bool addRecent)
+                            const bool addRecent,
+                            const bool markSaved,
+                            const QStringList &copies)
 {
-    QFile file(path);
-
     if (!AppSupport::isFlatpak()) {
-        if (file.exists()) { file.remove(); }
-
-        // check if folder exists first
-        QFileInfo info(path);
-        QDir dir = info.absoluteDir();
-        if (!dir.exists()) {
-            if (!dir.mkpath(dir.absolutePath())) {
-                RuntimeThrow(tr("Unable to create directory: %1").arg(dir.absolutePath()));
+        // check if folders exist first
+        for (const auto &dst : QStringList(path) + copies) {
+            QFileInfo info(dst);
+            QDir dir = info.absoluteDir();
+            if (!dir.exists()) {
+                if (!dir.mkpath(dir.absolutePath())) {
+                    RuntimeThrow(tr("Unable to create directory: %1").arg(dir.absolutePath()));
+                }
             }
         }
     }
 
-    if (!file.open(QIODevice::WriteOnly)) {
-        RuntimeThrow("Could not open file for writing " + path + ".");
-    }
-    eWriteStream writeStream(&file);
-    writeStream.setPath(path);
-    try {
-        writeStream.writeCheckpoint();
-        const auto& scenes = mDocument.fScenes;
-        writeStream << scenes.count();
-        for (const auto& scene : scenes) {
-            scene->writeSettings(writeStream);
+    // serialized to memory one scene per event loop pass,
+    // the file itself is written on the hdd thread
+    const qptr<MainWindow> window = this;
+    const uint changeId = mDocumentChangeId;
+    const auto finished = [window, markSaved, changeId](const bool success) {
+        if (!markSaved || !window) { return; }
+        // edits made while the file was written still need saving
+        if (!success) { window->setFileChangedSinceSaving(true); }
+        else if (changeId == window->mDocumentChangeId) {
+            window->setFileChangedSinceSaving(false);
         }
-        mLayoutHandler->write(writeStream);
-        writeStream.writeCheckpoint();
-        mDocument.writeScenes(writeStream);
-        writeStream.writeCheckpoint();
-        //const auto renderWidget = mTimeline->getRenderWidget();
-        mRenderWidget->write(writeStream);
-        writeStream.writeCheckpoint();
-
-        writeStream.writeFutureTable();
-        FileFooter::sWrite(writeStream);
+    };
+    try {
+        ProjectWriter::sSave(mDocument, path, [window](eWriteStream& dst) {
+            if (window) { window->mLayoutHandler->write(dst); }
+        }, [window](eWriteStream& dst) {
+            if (window) { window->mRenderWidget->write(dst); }
+        }, finished, copies);
     } catch(...) {
-        file.close();
         RuntimeThrow("Error while writing to file " + path);
     }
-    file.close();
-
-    BoundingBox::sClearWriteBoxes();
     if (addRecent) { addRecentFile(path); }
 }
 
@@ -25,6 +25,9 @@
 
 #include "memoryhandler.h"
 #include "Boxes/boxrendercontainer.h"
+#include "smartPointers/ememorypool.h"
+#include "skia/pixelbufferpool.h"
+#include "Tasks/metricsregistry.h"
 #include "GUI/mainwindow.h"
 #include <QMetaType>
 
@@ -97,10 +100,14 @@ void MemoryHandler::freeMemory(const MemoryState newState,
     }
 
     if(minFreeBytes.fValue <= 0) return;
+    eMemoryPool::sTrimAll();
+    PixelBufferPool::sTrim();
+    static auto& evictions = MetricsRegistry::sCounter("memory.evictions");
     qint64 memToFree = minFreeBytes.fValue;
     while(memToFree > 0 && !mDataHandler.isEmpty()) {
         const auto cont = mDataHandler.takeFirst();
         memToFree -= cont->free_RAM_k();
+        evictions.add();
     }
     if(newState == CRITICAL_MEMORY_STATE ||
        memToFree > 0) {
@@ -115,7 +122,13 @@ void MemoryHandler::memoryChecked(const intKB memKb,
                                   const intKB totMemKb,
                                   const intKB usedKb)
 {
-    Q_UNUSED(memKb)
-    Q_UNUSED(totMemKb)
+    static auto& used = MetricsRegistry::sGauge("memory.used_mb");
+    static auto& available = MetricsRegistry::sGauge("memory.free_mb");
+    static auto& total = MetricsRegistry::sGauge("memory.total_mb");
+    static auto& state = MetricsRegistry::sGauge("memory.state");
+    used.set(intMB(usedKb).fValue);
+    available.set(intMB(memKb).fValue);
+    total.set(intMB(totMemKb).fValue);
+    state.set(mMemoryState);
     emit memoryUsed(intMB(usedKb));
 }
@@ -32,6 +32,45 @@
 #include "CacheHandlers/soundcachecontainer.h"
 #include "CacheHandlers/sceneframecontainer.h"
 #include "Private/document.h"
+#include "Tasks/metricsregistry.h"
+#include "Private/esettings.h"
+
+// adaptive preview resolutions, relative to the scene resolution
+static const qreal sAdaptiveScales[] = {1., 0.75, 0.5, 0.35, 0.25};
+#define ADAPTIVE_STEPS int(sizeof(sAdaptiveScales)/sizeof(qreal))
+// the render speed is averaged over at least this many frames and ms
+#define ADAPTIVE_MIN_FRAMES 3
+#define ADAPTIVE_MIN_MS 250
+// streaming preview renders this many seconds, at least
+// STREAM_MIN_LOOK_AHEAD frames, ahead of the displayed frame
+#define STREAM_LOOK_AHEAD 1.
+#define STREAM_MIN_LOOK_AHEAD 8
+// audio further off the displayed frame (in seconds) is restarted
+#define STREAM_MAX_AUDIO_DRIFT 0.2
+
+// frames kept from a reduced resolution preview are rendered again
+static bool isRefined(const SceneFrameContainer * const cont,
+                      const qreal resolution)
+{
+    return cont->fResolution >= resolution - 0.0001;
+}
+
+static int firstFrameToRender(const HddCachableCacheHandler& handler,
+                              int frame, const qreal resolution)
+{
+    while(true) {
+        const auto cont = handler.atFrame<SceneFrameContainer>(frame);
+        if(!cont || !isRefined(cont, resolution)) return frame;
+        frame = cont->getRangeMax() + 1;
+    }
+}
+
+static bool isFrameReady(const HddCachableCacheHandler& handler,
+                         const int frame)
+{
+    const auto cont = handler.atFrame(frame);
+    return cont && cont->storesDataInMemory();
+}
 
 RenderHandler* RenderHandler::sInstance = nullptr;
 
@@ -75,6 +114,7 @@ void RenderHandler::renderFromSettings(RenderInstanceSettings * const settings)
     if(VideoEncoder::sStartEncoding(settings)) {
         mSavedCurrentFrame = mCurrentScene->getCurrentFrame();
         mSavedResolutionFraction = mCurrentScene->getResolution();
+        mCurrentScene->setPreviewResolutionScale(1);
 
         mCurrentRenderSettings = settings;
         const auto &renderSettings = settings->getRenderSettings();
@@ -135,14 +175,16 @@ void RenderHandler::setFrameAction(const int frame) {
 }
 
 void RenderHandler::setCurrentScene(Canvas * const scene) {
+    if(scene) scene->loadDeferredContent();
     mCurrentScene = scene;
     mCurrentSoundComposition = scene ? scene->getSoundComposition() : nullptr;
 }
 
 void RenderHandler::nextCurrentRenderFrame() {
-    auto& cacheHandler = mCurrentScene->getSceneFramesHandler();
-    int newCurrentRenderFrame = cacheHandler.
-            firstEmptyFrameAtOrAfter(mCurrentRenderFrame + 1);
+    const auto& cacheHandler = mCurrentScene->getSceneFramesHandler();
+    int newCurrentRenderFrame = firstFrameToRender(
+                cacheHandler, mCurrentRenderFrame + 1,
+                mCurrentScene->getRenderResolution());
     const bool allDone = newCurrentRenderFrame > mMaxRenderFrame;
     newCurrentRenderFrame = qMin(mMaxRenderFrame, newCurrentRenderFrame);
     const FrameRange newSoundRange = {mCurrentRenderFrame, newCurrentRenderFrame};
@@ -173,6 +215,7 @@ void RenderHandler::setPreviewState(const PreviewState state)
 void RenderHandler::renderPreview() {
     setCurrentScene(mDocument.fActiveScene);
     if(!mCurrentScene) return;
+    if(eSettings::instance().fStreamingPreview) return streamPreview();
     const auto nextFrameFunc = [this]() {
         nextPreviewRenderFrame();
     };
@@ -194,6 +237,8 @@ void RenderHandler::renderPreview() {
     mCurrentScene->setMinFrameUseRange(mCurrentRenderFrame);
     mCurrentSoundComposition->setMinFrameUseRange(mCurrentRenderFrame);
 
+    resetAdaptivePreview();
+
     setPreviewState(PreviewState::rendering);
 
     emit previewBeingRendered();
@@ -203,13 +248,64 @@ void RenderHandler::renderPreview() {
     }
 }
 
+void RenderHandler::streamPreview() {
+    mSavedCurrentFrame = mCurrentScene->getCurrentFrame();
+
+    const auto fIn = mCurrentScene->getFrameIn();
+    const auto fOut = mCurrentScene->getFrameOut();
+
+    mMinPreviewFrame = fIn.enabled ? fIn.frame :
+                       (mLoop ? mCurrentScene->getMinFrame() : mSavedCurrentFrame);
+    mMaxPreviewFrame = fOut.enabled ? fOut.frame : mCurrentScene->getMaxFrame();
+    if(mMinPreviewFrame >= mMaxPreviewFrame) return;
+
+    const auto nextFrameFunc = [this]() {
+        nextStreamRenderFrame();
+    };
+    TaskScheduler::sSetTaskUnderflowFunc(nextFrameFunc);
+    TaskScheduler::sSetAllTasksFinishedFunc(nextFrameFunc);
+
+    const qreal fps = mCurrentScene->getFps();
+    mStreamLookAhead = qMax(STREAM_MIN_LOOK_AHEAD, qCeil(STREAM_LOOK_AHEAD*fps));
+    resetAdaptivePreview();
+
+    mStreaming = true;
+    setPreviewState(PreviewState::rendering);
+    setPreviewState(PreviewState::playing);
+    // frames keep rendering while the preview plays
+    setRenderingPreview(true);
+    restartStream(mMinPreviewFrame);
+
+    // the playhead follows a clock, sample it twice per frame
+    mPreviewFPSTimer->setInterval(qMax(1, qRound(500/fps)));
+    mPreviewFPSTimer->start();
+    emit previewBeingPlayed();
+
+    if(TaskScheduler::sAllQuedCpuTasksFinished()) {
+        nextStreamRenderFrame();
+    }
+}
+
+void RenderHandler::restartStream(const int frame) {
+    stopAudio();
+    // the clock starts once the first frame is available
+    mStreamClock.invalidate();
+    mStreamStartFrame = frame;
+    mCurrentPreviewFrame = frame - 1;
+    mCurrentRenderFrame = frame - 1;
+    mCurrRenderRange = {frame, frame};
+    mCurrentScene->setMinFrameUseRange(frame);
+    mCurrentSoundComposition->setMinFrameUseRange(frame);
+}
+
 void RenderHandler::interruptPreview() {
     if(mRenderingPreview) interruptPreviewRendering();
     else if(mPreviewing) stopPreview();
 }
 
 void RenderHandler::outOfMemory() {
-    if(mRenderingPreview) {
+    // streaming keeps only the look-ahead window in use
+    if(mRenderingPreview && !mStreaming) {
         playPreview();
     }
 }
@@ -238,8 +334,18 @@ void RenderHandler::interruptOutputRendering() {
 }
 
 void RenderHandler::stopPreview() {
+    // frames cached at a reduced resolution during this preview
+    const FrameRange previewRange = mStreaming ?
+                FrameRange{mMinPreviewFrame, mMaxPreviewFrame} :
+                FrameRange{mMinRenderFrame, mCurrentRenderFrame};
+    if(mStreaming) {
+        mStreaming = false;
+        TaskScheduler::sClearAllFinishedFuncs();
+        setRenderingPreview(false);
+    }
     if(mCurrentScene) {
         mCurrentScene->clearUseRange();
+        mCurrentScene->setPreviewResolutionScale(1);
         setFrameAction(mSavedCurrentFrame);
         mCurrentScene->setSceneFrame(mSavedCurrentFrame);
         emit mCurrentScene->currentFrameChanged(mSavedCurrentFrame);
@@ -250,10 +356,35 @@ void RenderHandler::stopPreview() {
     stopAudio();
     emit previewFinished();
     setPreviewState(PreviewState::stopped);
+    // a reduced resolution frame left on screen is rendered again
+    if(mCurrentScene && mCurrentScene->refineSceneFrame()) {
+        mDocument.actionFinished();
+    }
+    if(mAdaptivePreview) startRefining(previewRange);
+}
+
+void RenderHandler::startRefining(const FrameRange& range) {
+    mRefineRange = range;
+    TaskScheduler::sSetAllTasksFinishedFunc([this]() {
+        refineNextFrame();
+    });
+    if(TaskScheduler::sAllTasksFinished()) refineNextFrame();
+}
+
+// renders one reduced resolution frame at a time, whenever the
+// scheduler runs out of work, until the range is refined
+void RenderHandler::refineNextFrame() {
+    const bool idle = mPreviewState == PreviewState::stopped &&
+                      !mCurrentRenderSettings;
+    if(!idle || !mCurrentScene ||
+       !mCurrentScene->refineNextSceneFrame(mRefineRange)) {
+        TaskScheduler::sClearAllFinishedFuncs();
+    }
 }
 
 void RenderHandler::pausePreview() {
     if(mPreviewing) {
+        if(mStreaming) setRenderingPreview(false);
         mAudioHandler.pauseAudio();
         mPreviewFPSTimer->stop();
         emit previewPaused();
@@ -263,10 +394,14 @@ void RenderHandler::pausePreview() {
 
 void RenderHandler::resumePreview() {
     if(mPreviewing) {
-        mAudioHandler.resumeAudio();
+        if(mStreaming) {
+            setRenderingPreview(true);
+            restartStream(mCurrentPreviewFrame);
+        } else mAudioHandler.resumeAudio();
         mPreviewFPSTimer->start();
         emit previewBeingPlayed();
         setPreviewState(PreviewState::playing);
+        if(mStreaming) nextStreamRenderFrame();
     }
 }
 
@@ -314,15 +449,135 @@ void RenderHandler::nextPreviewRenderFrame() {
     if(mCurrentRenderFrame >= mMaxRenderFrame) {
         playPreviewAfterAllTasksCompleted();
     } else {
+        adaptPreviewResolution();
         nextCurrentRenderFrame();
+        mAdaptiveFrames++;
         if(TaskScheduler::sAllTasksFinished()) {
             nextPreviewRenderFrame();
         }
     }
 }
 
+void RenderHandler::resetAdaptivePreview() {
+    mAdaptivePreview = eSettings::instance().fAdaptivePreview;
+    mAdaptiveStep = 0;
+    mAdaptiveFrames = 0;
+    mAdaptiveBusyNs = 0;
+    mAdaptiveTimer.start();
+    mCurrentScene->setPreviewResolutionScale(1);
+}
+
+void RenderHandler::adaptPreviewResolution() {
+    if(!mAdaptivePreview || !mCurrentScene) return;
+    const qint64 elapsed = mAdaptiveBusyNs +
+            (mAdaptiveTimer.isValid() ? mAdaptiveTimer.nsecsElapsed() : 0);
+    if(mAdaptiveFrames < ADAPTIVE_MIN_FRAMES ||
+       elapsed < ADAPTIVE_MIN_MS*qint64(1000000)) return;
+    const qreal frameMs = elapsed/(1e6*mAdaptiveFrames);
+    static auto& frameTime = MetricsRegistry::sHistogram("preview.frame_us");
+    frameTime.record(qRound64(1000*frameMs));
+
+    // render time roughly follows the pixel count,
+    // go up only if the larger frames would still keep up
+    const qreal targetMs = 1000/mCurrentScene->getFps();
+    const qreal scale = sAdaptiveScales[mAdaptiveStep];
+    if(frameMs > 1.1*targetMs) {
+        mAdaptiveStep = qMin(mAdaptiveStep + 1, ADAPTIVE_STEPS - 1);
+    } else if(mAdaptiveStep > 0) {
+        const qreal up = sAdaptiveScales[mAdaptiveStep - 1]/scale;
+        if(frameMs*up*up < 0.9*targetMs) mAdaptiveStep--;
+    }
+    mCurrentScene->setPreviewResolutionScale(sAdaptiveScales[mAdaptiveStep]);
+
+    static auto& resolution = MetricsRegistry::sGauge("preview.resolution_pct");
+    resolution.set(qRound(100*mCurrentScene->getRenderResolution()));
+    mAdaptiveFrames = 0;
+    mAdaptiveBusyNs = 0;
+    mAdaptiveTimer.start();
+}
+
+void RenderHandler::nextStreamRenderFrame() {
+    if(!mStreaming || !mRenderingPreview) return;
+    // frames the playhead already passed are not rendered
+    mCurrentRenderFrame = qMax(mCurrentRenderFrame, mCurrentPreviewFrame);
+    mMaxRenderFrame = qMin(mMaxPreviewFrame,
+                           mCurrentPreviewFrame + mStreamLookAhead);
+    if(mCurrentRenderFrame >= mMaxRenderFrame) {
+        // waiting for the playhead does not count as render time
+        if(mAdaptiveTimer.isValid()) {
+            mAdaptiveBusyNs += mAdaptiveTimer.nsecsElapsed();
+            mAdaptiveTimer.invalidate();
+        }
+        return;
+    }
+    if(!mAdaptiveTimer.isValid()) mAdaptiveTimer.start();
+    adaptPreviewResolution();
+    nextCurrentRenderFrame();
+    mAdaptiveFrames++;
+    if(TaskScheduler::sAllTasksFinished()) {
+        nextStreamRenderFrame();
+    }
+}
+
+void RenderHandler::nextStreamFrame() {
+    const auto& handler = mCurrentScene->getSceneFramesHandler();
+    const bool started = mStreamClock.isValid();
+    int frame = mStreamStartFrame;
+    if(started) {
+        const qreal fps = mCurrentScene->getFps();
+        frame += qFloor(mStreamClock.nsecsElapsed()*fps/1e9);
+    } else if(isFrameReady(handler, frame)) {
+        mStreamClock.start();
+    } else return;
+
+    if(frame > mMaxPreviewFrame) {
+        if(!mLoop) return stopPreview();
+        restartStream(mMinPreviewFrame);
+        return nextStreamRenderFrame();
+    }
+    if(frame <= mCurrentPreviewFrame) return;
+
+    static auto& shown = MetricsRegistry::sCounter("preview.frames");
+    static auto& dropped = MetricsRegistry::sCounter("preview.dropped");
+    // frames the clock moved past were never displayed
+    const int skipped = frame - mCurrentPreviewFrame - 1;
+    if(skipped > 0) dropped.add(skipped);
+    mCurrentPreviewFrame = frame;
+    // a frame not rendered in time leaves the previous one on screen
+    if(isFrameReady(handler, frame)) {
+        shown.add();
+        mCurrentScene->setSceneFrame(frame);
+    } else dropped.add();
+
+    mCurrentScene->setMinFrameUseRange(frame);
+    mCurrentSoundComposition->setMinFrameUseRange(frame);
+    if(started) syncStreamAudio();
+    else startAudio();
+    emit mCurrentScene->currentFrameChanged(frame);
+    emit mCurrentScene->requestUpdate();
+
+    nextStreamRenderFrame();
+}
+
+void RenderHandler::syncStreamAudio() {
+    if(!mCurrentSoundComposition->hasAnySounds()) return;
+    const auto output = mAudioHandler.audioOutput();
+    if(!output || output->state() == QAudio::StoppedState) return;
+    // samples still queued in the output were not heard yet
+    const int queued = output->bufferSize() - output->bytesFree();
+    const qreal queuedSec = output->format().durationForBytes(queued)/1e6;
+    const qreal fps = mCurrentScene->getFps();
+    const qreal heard = mCurrentSoundComposition->currentFrame() - queuedSec*fps;
+    if(qAbs(heard - mCurrentPreviewFrame) < STREAM_MAX_AUDIO_DRIFT*fps) return;
+    static auto& resyncs = MetricsRegistry::sCounter("preview.audio_resyncs");
+    resyncs.add();
+    stopAudio();
+    startAudio();
+}
+
 void RenderHandler::nextPreviewFrame() {
     if(!mCurrentScene) return;
+    if(mStreaming) return nextStreamFrame();
     mCurrentPreviewFrame++;
     if(mCurrentPreviewFrame > mMaxPreviewFrame) {
         if(mLoop) {
@@ -332,6 +587,12 @@ void RenderHandler::nextPreviewFrame() {
             startAudio();
         } else stopPreview();
     } else {
+        static auto& shown = MetricsRegistry::sCounter("preview.frames");
+        static auto& dropped = MetricsRegistry::sCounter("preview.dropped");
+        const auto& handler = mCurrentScene->getSceneFramesHandler();
+        // frames cached on the hdd are loaded and shown as well
+        if(handler.atFrame(mCurrentPreviewFrame)) shown.add();
+        else dropped.add();
         mCurrentScene->setSceneFrame(mCurrentPreviewFrame);
         if(!mLoop) mCurrentScene->setMinFrameUseRange(mCurrentPreviewFrame);
         emit mCurrentScene->currentFrameChanged(mCurrentPreviewFrame);
@@ -375,9 +636,10 @@ void RenderHandler::nextSaveOutputFrame() {
     if(mCurrentEncodeSoundSecond > mMaxSoundSec) VideoEncoder::sAllAudioProvided();
 
     const auto& cacheHandler = mCurrentScene->getSceneFramesHandler();
+    const qreal resolution = mCurrentScene->getRenderResolution();
     while(mCurrentEncodeFrame <= mMaxRenderFrame) {
-        const auto cont = cacheHandler.atFrame(mCurrentEncodeFrame);
-        if(!cont) break;
+        const auto cont = cacheHandler.atFrame<SceneFrameContainer>(mCurrentEncodeFrame);
+        if(!cont || !isRefined(cont, resolution)) break;
         VideoEncoder::sAddCacheContainerToEncoder(cont->ref<SceneFrameContainer>());
         mCurrentEncodeFrame = cont->getRangeMax() + 1;
     }
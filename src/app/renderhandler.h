@@ -31,6 +31,8 @@
 #include "CacheHandlers/usepointer.h"
 #include "CacheHandlers/cachecontainer.h"
 
+#include <QElapsedTimer>
+
 class Canvas;
 class RenderInstanceSettings;
 class SoundComposition;
@@ -86,6 +88,16 @@ private:
     void nextPreviewRenderFrame();
     void nextPreviewFrame();
     void nextCurrentRenderFrame();
+    void resetAdaptivePreview();
+    void adaptPreviewResolution();
+    void startRefining(const FrameRange& range);
+    void refineNextFrame();
+
+    void streamPreview();
+    void restartStream(const int frame);
+    void nextStreamRenderFrame();
+    void nextStreamFrame();
+    void syncStreamAudio();
 
     void setPreviewState(const PreviewState state);
     void setRenderingPreview(const bool rendering);
@@ -118,6 +130,19 @@ private:
     bool mPreviewing = false;
     //! @brief true if currently preview is being rendered
     bool mRenderingPreview = false;
+    //! @brief true if the preview resolution follows the render speed
+    bool mAdaptivePreview = false;
+    int mAdaptiveStep = 0;
+    int mAdaptiveFrames = 0;
+    qint64 mAdaptiveBusyNs = 0;
+    QElapsedTimer mAdaptiveTimer;
+    //! @brief Frames the idle pass renders again at full resolution
+    FrameRange mRefineRange{0, -1};
+    //! @brief true if the preview plays while frames ahead are rendered
+    bool mStreaming = false;
+    int mStreamLookAhead = 0;
+    int mStreamStartFrame = 0;
+    QElapsedTimer mStreamClock;
 
     int mCurrentEncodeFrame;
     int mCurrentEncodeSoundSecond;
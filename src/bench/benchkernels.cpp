@@ -0,0 +1,371 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "benchkernels.h"
+
+#include "skia/pixelkernels.h"
+#include "RasterEffects/effectkernels.h"
+#include "colorhelpers.h"
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+// one 4K UHD frame per run
+#define TILE_WIDTH 3840
+#define TILE_HEIGHT 2160
+#define TILE_SEED 4096
+// largest difference to the scalar reference a kernel may produce
+#define KERNEL_TOLERANCE 1
+// effect settings, away from the identity so every term contributes
+#define BRIGHTNESS 0.15
+#define CONTRAST 0.4
+#define HUE 200.
+#define SATURATION 0.6
+#define LIGHTNESS 0.1
+#define INFLUENCE 0.75
+
+using Pixels = std::vector<uint8_t>;
+using RowKernel = std::function<void(const uint8_t*, uint8_t*, int)>;
+
+// deterministic RGBA with every alpha class the kernels special case,
+// premultiplied tiles never have a color above the alpha
+static Pixels randomTile(const bool premultiplied)
+{
+    std::mt19937 gen(TILE_SEED);
+    Pixels tile(4*TILE_WIDTH*TILE_HEIGHT);
+    for (size_t i = 0; i < tile.size(); i += 4) {
+        const uint32_t kind = gen() % 8;
+        const uint32_t a = kind == 0 ? 0 : kind < 3 ? 255 : gen() % 256;
+        const uint32_t max = premultiplied ? a : 255;
+        for (int c = 0; c < 3; c++) { tile[i + c] = gen() % (max + 1); }
+        tile[i + 3] = static_cast<uint8_t>(a);
+    }
+    return tile;
+}
+
+// truncates like the effects did when assigning to uchar
+static inline uint8_t toByte(const double value)
+{
+    return static_cast<uint8_t>(std::min(255., std::max(0., value)));
+}
+
+static inline uint8_t roundToByte(const double value)
+{
+    return static_cast<uint8_t>(std::lround(std::min(255., std::max(0., value))));
+}
+
+// fastest of the runs in ms, after one warm-up run
+static qreal bestTime(const int iterations,
+                      const std::function<void()>& func)
+{
+    func();
+    qreal best = std::numeric_limits<qreal>::max();
+    for (int i = 0; i < iterations; i++) {
+        QElapsedTimer timer;
+        timer.start();
+        func();
+        best = std::min(best, timer.nsecsElapsed()/1e6);
+    }
+    return best;
+}
+
+static void forEachRow(const Pixels& src, Pixels& dst,
+                       const RowKernel& kernel)
+{
+    const int stride = 4*TILE_WIDTH;
+    for (int y = 0; y < TILE_HEIGHT; y++) {
+        kernel(src.data() + y*stride, dst.data() + y*stride, TILE_WIDTH);
+    }
+}
+
+static int maxDiff(const Pixels& a, const Pixels& b)
+{
+    int result = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        result = std::max(result, std::abs(int(a[i]) - int(b[i])));
+    }
+    return result;
+}
+
+static QJsonObject compare(const QString& name,
+                           const qreal kernelMs,
+                           const qreal referenceMs,
+                           const int diff)
+{
+    const qreal mpix = TILE_WIDTH*TILE_HEIGHT/1e6;
+    QJsonObject result;
+    result["name"] = name;
+    result["kernel_mpix_s"] = kernelMs > 0 ? 1000*mpix/kernelMs : 0.;
+    result["scalar_mpix_s"] = referenceMs > 0 ? 1000*mpix/referenceMs : 0.;
+    result["speedup"] = kernelMs > 0 ? referenceMs/kernelMs : 0.;
+    result["max_diff"] = diff;
+    result["passed"] = diff <= KERNEL_TOLERANCE;
+    return result;
+}
+
+static QJsonObject compareRows(const QString& name,
+                               const int iterations,
+                               const Pixels& src,
+                               const RowKernel& kernel,
+                               const RowKernel& reference)
+{
+    Pixels kernelDst(src.size());
+    Pixels referenceDst(src.size());
+    const qreal kernelMs = bestTime(iterations, [&]() {
+        forEachRow(src, kernelDst, kernel);
+    });
+    const qreal referenceMs = bestTime(iterations, [&]() {
+        forEachRow(src, referenceDst, reference);
+    });
+    return compare(name, kernelMs, referenceMs,
+                   maxDiff(kernelDst, referenceDst));
+}
+
+static void premultiplyReference(const uint8_t* src, uint8_t* dst,
+                                 const int count)
+{
+    for (int i = 0; i < count; i++, src += 4, dst += 4) {
+        const double a = src[3]/255.;
+        for (int c = 0; c < 3; c++) { dst[c] = roundToByte(src[c]*a); }
+        dst[3] = src[3];
+    }
+}
+
+static void unpremultiplyReference(const uint8_t* src, uint8_t* dst,
+                                   const int count)
+{
+    for (int i = 0; i < count; i++, src += 4, dst += 4) {
+        const int a = src[3];
+        for (int c = 0; c < 3; c++) {
+            dst[c] = a == 0 ? 0 : roundToByte(src[c]*255./a);
+        }
+        dst[3] = src[3];
+    }
+}
+
+static void swapRedBlueReference(const uint8_t* src, uint8_t* dst,
+                                 const int count)
+{
+    for (int i = 0; i < count; i++, src += 4, dst += 4) {
+        const uint8_t r = src[0];
+        dst[0] = src[2];
+        dst[1] = src[1];
+        dst[2] = r;
+        dst[3] = src[3];
+    }
+}
+
+// BT.601 limited range with the exact coefficients
+static void yuv420pReference(const uint8_t* src, uint8_t* const planes[3])
+{
+    const int stride = 4*TILE_WIDTH;
+    for (int y = 0; y < TILE_HEIGHT; y++) {
+        const uint8_t* p = src + y*stride;
+        for (int x = 0; x < TILE_WIDTH; x++, p += 4) {
+            planes[0][y*TILE_WIDTH + x] = roundToByte(
+                        16 + (65.481*p[0] + 128.553*p[1] + 24.966*p[2])/255);
+        }
+    }
+    for (int y = 0; y < TILE_HEIGHT; y += 2) {
+        for (int x = 0; x < TILE_WIDTH; x += 2) {
+            double rgb[3] = {0, 0, 0};
+            for (int i = 0; i < 4; i++) {
+                const uint8_t* p = src + (y + i/2)*stride + 4*(x + i%2);
+                for (int c = 0; c < 3; c++) { rgb[c] += p[c]/4.; }
+            }
+            const int id = (y/2)*(TILE_WIDTH/2) + x/2;
+            planes[1][id] = roundToByte(
+                        128 + (-37.797*rgb[0] - 74.203*rgb[1] + 112*rgb[2])/255);
+            planes[2][id] = roundToByte(
+                        128 + (112*rgb[0] - 93.786*rgb[1] - 18.214*rgb[2])/255);
+        }
+    }
+}
+
+static QJsonObject compareYuv420p(const int iterations, const Pixels& src)
+{
+    const int lumaSize = TILE_WIDTH*TILE_HEIGHT;
+    const int chromaSize = lumaSize/4;
+    Pixels kernelDst(lumaSize + 2*chromaSize);
+    Pixels referenceDst(kernelDst.size());
+    const auto planesOf = [&](Pixels& data, uint8_t* planes[3]) {
+        planes[0] = data.data();
+        planes[1] = planes[0] + lumaSize;
+        planes[2] = planes[1] + chromaSize;
+    };
+    uint8_t* kernelPlanes[3];
+    uint8_t* referencePlanes[3];
+    planesOf(kernelDst, kernelPlanes);
+    planesOf(referenceDst, referencePlanes);
+    const int strides[3] = {TILE_WIDTH, TILE_WIDTH/2, TILE_WIDTH/2};
+
+    const qreal kernelMs = bestTime(iterations, [&]() {
+        PixelKernels::rgbaToYuv420p(src.data(), 4*TILE_WIDTH,
+                                    TILE_WIDTH, TILE_HEIGHT,
+                                    kernelPlanes, strides);
+    });
+    const qreal referenceMs = bestTime(iterations, [&]() {
+        yuv420pReference(src.data(), referencePlanes);
+    });
+    return compare("yuv420p", kernelMs, referenceMs,
+                   maxDiff(kernelDst, referenceDst));
+}
+
+static void brightnessContrastReference(const uint8_t* src, uint8_t* dst,
+                                        const int count)
+{
+    for (int i = 0; i < count; i++, src += 4, dst += 4) {
+        const uint8_t a = src[3];
+        for (int c = 0; c < 3; c++) {
+            dst[c] = toByte((src[c] - 0.5*a)*(CONTRAST + 1.) +
+                            a*(0.5 + BRIGHTNESS));
+        }
+        dst[3] = a;
+    }
+}
+
+static void colorizeReference(const uint8_t* src, uint8_t* dst,
+                              const int count)
+{
+    for (int i = 0; i < count; i++, src += 4, dst += 4) {
+        if (src[3] == 0) {
+            std::fill(dst, dst + 4, 0);
+            continue;
+        }
+        const qreal rF = src[0]/255.;
+        const qreal gF = src[1]/255.;
+        const qreal bF = src[2]/255.;
+        const qreal aF = src[3]/255.;
+        qreal h = rF/aF;
+        qreal s = gF/aF;
+        qreal l = bF/aF;
+        qrgb_to_hsl(h, s, l);
+        h = HUE/360.;
+        s = SATURATION;
+        l = std::min(1., std::max(0., l + LIGHTNESS));
+        qhsl_to_rgb(h, s, l);
+
+        dst[0] = toByte(255*(h*aF*INFLUENCE + rF*(1 - INFLUENCE)));
+        dst[1] = toByte(255*(s*aF*INFLUENCE + gF*(1 - INFLUENCE)));
+        dst[2] = toByte(255*(l*aF*INFLUENCE + bF*(1 - INFLUENCE)));
+        dst[3] = src[3];
+    }
+}
+
+// factors of one row, as produced by the wipe and noise fade effects
+static std::vector<float> randomFactors()
+{
+    std::mt19937 gen(TILE_SEED);
+    std::uniform_real_distribution<float> dist(0.f, 1.f);
+    std::vector<float> factors(TILE_WIDTH);
+    for (auto& factor : factors) { factor = dist(gen); }
+    return factors;
+}
+
+QJsonObject BenchKernels::sRun(const int iterations)
+{
+    QJsonObject result;
+    result["tile_width"] = TILE_WIDTH;
+    result["tile_height"] = TILE_HEIGHT;
+    result["iterations"] = iterations;
+    result["tolerance"] = KERNEL_TOLERANCE;
+    result["pixel"] = sPixelKernels(iterations);
+    result["effect"] = sEffectKernels(iterations);
+    return result;
+}
+
+bool BenchKernels::sPassed(const QJsonObject& results)
+{
+    for (const auto& group : results) {
+        if (!group.isObject()) { continue; }
+        const auto kernels = group.toObject()["kernels"].toArray();
+        for (const auto& kernel : kernels) {
+            if (!kernel.toObject()["passed"].toBool()) { return false; }
+        }
+    }
+    return true;
+}
+
+QJsonObject BenchKernels::sPixelKernels(const int iterations)
+{
+    const Pixels straight = randomTile(false);
+    const Pixels premultiplied = randomTile(true);
+
+    QJsonArray kernels;
+    kernels.append(compareRows("premultiply", iterations, straight,
+                               PixelKernels::premultiply,
+                               premultiplyReference));
+    kernels.append(compareRows("unpremultiply", iterations, premultiplied,
+                               PixelKernels::unpremultiply,
+                               unpremultiplyReference));
+    kernels.append(compareRows("swap_red_blue", iterations, straight,
+                               PixelKernels::swapRedBlue,
+                               swapRedBlueReference));
+    kernels.append(compareYuv420p(iterations, straight));
+
+    QJsonObject result;
+    result["instruction_set"] = QString(PixelKernels::instructionSet());
+    result["kernels"] = kernels;
+    return result;
+}
+
+QJsonObject BenchKernels::sEffectKernels(const int iterations)
+{
+    const Pixels premultiplied = randomTile(true);
+
+    qreal r = HUE/360.;
+    qreal g = SATURATION;
+    qreal b = 0.5;
+    qhsl_to_rgb(r, g, b);
+    const float rgbHalf[3] = {float(r), float(g), float(b)};
+    const std::vector<float> factors = randomFactors();
+
+    QJsonArray kernels;
+    kernels.append(compareRows("brightness_contrast", iterations, premultiplied,
+                               [](const uint8_t* src, uint8_t* dst, const int count) {
+        EffectKernels::brightnessContrast(src, dst, count, BRIGHTNESS, CONTRAST);
+    }, brightnessContrastReference));
+    kernels.append(compareRows("colorize", iterations, premultiplied,
+                               [&rgbHalf](const uint8_t* src, uint8_t* dst, const int count) {
+        EffectKernels::colorize(src, dst, count, rgbHalf, LIGHTNESS, INFLUENCE);
+    }, colorizeReference));
+    kernels.append(compareRows("scale", iterations, premultiplied,
+                               [&factors](const uint8_t* src, uint8_t* dst, const int count) {
+        EffectKernels::scale(src, dst, factors.data(), count);
+    }, [&factors](const uint8_t* src, uint8_t* dst, const int count) {
+        for (int i = 0; i < count; i++, src += 4, dst += 4) {
+            for (int c = 0; c < 4; c++) { dst[c] = toByte(src[c]*double(factors[i])); }
+        }
+    }));
+
+    QJsonObject result;
+    result["instruction_set"] = QString(EffectKernels::instructionSet());
+    result["kernels"] = kernels;
+    return result;
+}
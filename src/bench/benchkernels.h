@@ -0,0 +1,45 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef BENCHKERNELS_H
+#define BENCHKERNELS_H
+
+#include <QJsonObject>
+
+//! @brief Times the CPU pixel and effect kernels on 4K tiles against
+//! plain scalar references and checks that their results stay within tolerance
+class BenchKernels
+{
+public:
+    static QJsonObject sRun(const int iterations);
+    //! @brief False if any kernel in the results exceeded its tolerance
+    static bool sPassed(const QJsonObject& results);
+private:
+    //! @brief Conversions used by the image loaders and the video encoder
+    static QJsonObject sPixelKernels(const int iterations);
+    //! @brief Point-wise raster effects, compared to the per-pixel
+    //! double code they replaced
+    static QJsonObject sEffectKernels(const int iterations);
+};
+
+#endif // BENCHKERNELS_H
@@ -0,0 +1,283 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "benchrunner.h"
+#include "benchkernels.h"
+
+#include "canvas.h"
+#include "exceptions.h"
+#include "hardwareinfo.h"
+#include "Private/document.h"
+#include "Private/Tasks/taskscheduler.h"
+#include "CacheHandlers/sceneframecontainer.h"
+#include "ReadWrite/filefooter.h"
+#include "ReadWrite/ewritestream.h"
+
+#include <QBuffer>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QSet>
+#include <QtMath>
+#include <algorithm>
+
+#if defined(Q_OS_WIN)
+#include "windowsincludes.h"
+#elif defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+// give up on a frame that is still not rendered after this long
+#define FRAME_TIMEOUT_MS 60000
+
+BenchRunner::BenchRunner(Document& document,
+                         const Options& options) :
+    mDocument(document), mOptions(options) {}
+
+QJsonObject BenchRunner::run()
+{
+    QJsonObject result;
+    result["version"] = QString(PROJECT_VERSION);
+    result["cpu_threads"] = HardwareInfo::sCpuThreads();
+    result["gpu_vendor"] = HardwareInfo::sGpuVendorString();
+    result["width"] = mOptions.fWidth;
+    result["height"] = mOptions.fHeight;
+    result["fps"] = mOptions.fFps;
+    result["resolution"] = mOptions.fResolution;
+    result["frames"] = mOptions.fConfig.fFrames;
+    result["scale"] = mOptions.fConfig.fScale;
+
+    const QStringList names = mOptions.fScenes.isEmpty() ?
+                BenchScenes::sNames() : mOptions.fScenes;
+    QJsonArray scenes;
+    for (const auto& name : names) { scenes.append(runScene(name)); }
+    result["scenes"] = scenes;
+    // before the kernels, their tiles are not part of the scenes
+    result["peak_memory_mb"] = sPeakMemory()/1048576.;
+    result["kernels"] = BenchKernels::sRun(mOptions.fKernelIterations);
+    return result;
+}
+
+qint64 BenchRunner::sPeakMemory()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return qint64(pmc.PeakWorkingSetSize);
+    }
+    return 0;
+#elif defined(Q_OS_UNIX)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) { return 0; }
+#if defined(Q_OS_DARWIN)
+    return qint64(usage.ru_maxrss);
+#else
+    return qint64(usage.ru_maxrss)*1024;
+#endif
+#else
+    return 0;
+#endif
+}
+
+Canvas* BenchRunner::createScene(const QString& name)
+{
+    const auto scene = mDocument.createNewScene();
+    scene->prp_setName(name);
+    scene->setCanvasSize(mOptions.fWidth, mOptions.fHeight);
+    scene->setFps(mOptions.fFps);
+    scene->setFrameRange({0, mOptions.fConfig.fFrames - 1}, false);
+    scene->setResolution(mOptions.fResolution);
+    return scene;
+}
+
+void BenchRunner::removeScene(Canvas * const scene)
+{
+    mDocument.removeVisibleScene(scene);
+    mDocument.removeScene(scene->ref<Canvas>());
+    TaskScheduler::instance()->waitTillFinished();
+}
+
+QJsonObject BenchRunner::runScene(const QString& name)
+{
+    QJsonObject result;
+    result["name"] = name;
+
+    QElapsedTimer timer;
+    timer.start();
+    const auto scene = createScene(name);
+    if (!BenchScenes::sBuild(name, scene, mOptions.fConfig)) {
+        mDocument.removeScene(scene->ref<Canvas>());
+        result["skipped"] = true;
+        return result;
+    }
+    result["boxes"] = scene->getContainedBoxes().count();
+    result["build_ms"] = timer.nsecsElapsed()/1e6;
+
+    mDocument.addVisibleScene(scene);
+    QVector<qreal> times;
+    int failed = 0;
+    for (int frame = 0; frame < mOptions.fConfig.fFrames; frame++) {
+        const qreal time = renderFrame(scene, frame);
+        if (time < 0) { failed++; }
+        else { times << time; }
+    }
+    result["render"] = sFrameStats(times);
+    result["failed_frames"] = failed;
+
+    result["export"] = exportFrames(scene);
+    result["save_load"] = saveAndLoad();
+    result["peak_memory_mb"] = sPeakMemory()/1048576.;
+
+    removeScene(scene);
+    return result;
+}
+
+static bool frameInMemory(Canvas * const scene)
+{
+    const int relFrame = scene->anim_getCurrentRelFrame();
+    auto& frames = scene->getSceneFramesHandler();
+    const auto cont = frames.atFrame<SceneFrameContainer>(relFrame);
+    return cont && cont->storesDataInMemory();
+}
+
+qreal BenchRunner::renderFrame(Canvas * const scene,
+                               const int frame)
+{
+    const auto scheduler = TaskScheduler::instance();
+    QElapsedTimer timer;
+    timer.start();
+    if (frame == scene->anim_getCurrentAbsFrame()) {
+        scene->planUpdate(UpdateReason::userChange);
+    } else { scene->anim_setAbsFrame(frame); }
+    mDocument.actionFinished();
+    // media and cache loading may need several task rounds,
+    // the scheduler requeues through Document::updateScenes
+    while (!frameInMemory(scene)) {
+        scheduler->waitTillFinished();
+        if (frameInMemory(scene)) { break; }
+        if (timer.elapsed() > FRAME_TIMEOUT_MS) { return -1; }
+        mDocument.actionFinished();
+    }
+    return timer.nsecsElapsed()/1e6;
+}
+
+QJsonObject BenchRunner::sFrameStats(QVector<qreal> times)
+{
+    QJsonObject result;
+    result["frames"] = times.count();
+    if (times.isEmpty()) { return result; }
+    // the first frame also pays for the initial caches
+    result["first_ms"] = times.first();
+    std::sort(times.begin(), times.end());
+    qreal total = 0;
+    for (const qreal time : times) { total += time; }
+    const auto percentile = [&times](const qreal p) {
+        const int id = qBound(0, qCeil(p*times.count()) - 1,
+                              times.count() - 1);
+        return times.at(id);
+    };
+    result["total_ms"] = total;
+    result["mean_ms"] = total/times.count();
+    result["p50_ms"] = percentile(0.5);
+    result["p95_ms"] = percentile(0.95);
+    result["max_ms"] = times.last();
+    result["fps"] = total > 0 ? 1000*times.count()/total : 0.;
+    return result;
+}
+
+QJsonObject BenchRunner::exportFrames(Canvas * const scene)
+{
+    QJsonObject result;
+    auto& frames = scene->getSceneFramesHandler();
+    QSet<SceneFrameContainer*> conts;
+    qint64 bytes = 0;
+    qint64 cacheBytes = 0;
+    int encoded = 0;
+    QElapsedTimer timer;
+    timer.start();
+    for (int frame = 0; frame < mOptions.fConfig.fFrames; frame++) {
+        const int relFrame = scene->prp_absFrameToRelFrame(frame);
+        const auto cont = frames.atFrame<SceneFrameContainer>(relFrame);
+        if (!cont || !cont->storesDataInMemory()) { continue; }
+        if (!conts.contains(cont)) {
+            conts << cont;
+            cacheBytes += cont->getByteCount();
+        }
+        const auto image = cont->getImage();
+        if (!image || image->isTextureBacked()) { continue; }
+        const auto data = image->encodeToData(SkEncodedImageFormat::kPNG, 100);
+        if (!data) { continue; }
+        bytes += qint64(data->size());
+        encoded++;
+    }
+    const qreal ms = timer.nsecsElapsed()/1e6;
+    result["frames"] = encoded;
+    result["total_ms"] = ms;
+    result["fps"] = ms > 0 ? 1000*encoded/ms : 0.;
+    result["bytes"] = bytes;
+    result["cache_mb"] = cacheBytes/1048576.;
+    return result;
+}
+
+QJsonObject BenchRunner::saveAndLoad()
+{
+    QJsonObject result;
+    const QString path = QDir::temp().filePath("friction-bench.friction");
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    QElapsedTimer timer;
+    timer.start();
+    try {
+        eWriteStream writeStream(&buffer);
+        writeStream.setPath(path);
+        mDocument.writeProject(writeStream, nullptr, nullptr);
+    } catch (const std::exception& e) {
+        result["error"] = QString(e.what());
+        return result;
+    }
+    buffer.close();
+    result["save_ms"] = timer.nsecsElapsed()/1e6;
+    result["bytes"] = buffer.size();
+
+    const int nScenes = mDocument.fScenes.count();
+    buffer.open(QIODevice::ReadOnly);
+    timer.restart();
+    try {
+        const int evVersion = FileFooter::sReadEvFileVersion(&buffer);
+        if (evVersion <= 0) { RuntimeThrow("Incompatible or incomplete data"); }
+        mDocument.readProject(buffer, evVersion, path, nullptr, nullptr);
+        mDocument.loadDeferredScenes();
+        result["load_ms"] = timer.nsecsElapsed()/1e6;
+    } catch (const std::exception& e) {
+        result["error"] = QString(e.what());
+    }
+    buffer.close();
+
+    QList<Canvas*> loaded;
+    for (int i = nScenes; i < mDocument.fScenes.count(); i++) {
+        loaded << mDocument.fScenes.at(i).get();
+    }
+    for (const auto scene : loaded) { removeScene(scene); }
+    return result;
+}
@@ -0,0 +1,74 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef BENCHRUNNER_H
+#define BENCHRUNNER_H
+
+#include "benchscenes.h"
+
+#include <QJsonObject>
+#include <QVector>
+
+class Canvas;
+class Document;
+
+//! @brief Builds, renders, exports and round-trips the synthetic
+//! scenes headlessly and times the CPU kernels, collecting the results as json
+class BenchRunner
+{
+public:
+    struct Options {
+        int fWidth = 1280;
+        int fHeight = 720;
+        qreal fFps = 30;
+        qreal fResolution = 1;
+        int fKernelIterations = 10;
+        QStringList fScenes;
+        BenchScenes::Config fConfig;
+    };
+
+    BenchRunner(Document& document,
+                const Options& options);
+
+    QJsonObject run();
+
+    //! @brief Peak resident set size of the process in bytes
+    static qint64 sPeakMemory();
+private:
+    QJsonObject runScene(const QString& name);
+    Canvas* createScene(const QString& name);
+    //! @brief Returns the time in ms it took to render the frame
+    qreal renderFrame(Canvas * const scene,
+                      const int frame);
+    QJsonObject exportFrames(Canvas * const scene);
+    //! @brief Round-trips the document through the project format
+    QJsonObject saveAndLoad();
+    void removeScene(Canvas * const scene);
+
+    static QJsonObject sFrameStats(QVector<qreal> times);
+
+    Document& mDocument;
+    const Options mOptions;
+};
+
+#endif // BENCHRUNNER_H
@@ -0,0 +1,308 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "benchscenes.h"
+
+#include "canvas.h"
+#include "Private/document.h"
+#include "Boxes/rectangle.h"
+#include "Boxes/circle.h"
+#include "Boxes/textbox.h"
+#include "Boxes/videobox.h"
+#include "Boxes/containerbox.h"
+#include "Animators/qrealkey.h"
+#include "Animators/transformanimator.h"
+#include "Animators/paintsettingsanimator.h"
+#include "Expressions/expression.h"
+#include "RasterEffects/blureffect.h"
+#include "RasterEffects/shadoweffect.h"
+#include "PathEffects/displacepatheffect.h"
+#include "PathEffects/zigzagpatheffect.h"
+
+#include <QtMath>
+#include <QDebug>
+
+#define PATH_BOXES 400
+#define GROUP_DEPTH 16
+#define GROUP_CHILDREN 8
+#define TEXT_BOXES 40
+#define RASTER_EFFECT_BOXES 40
+#define PATH_EFFECT_BOXES 100
+#define EXPRESSION_BOXES 200
+#define VIDEO_BOXES 4
+
+// golden ratio hue steps, distinct but stable colors
+static QColor boxColor(const int id)
+{
+    const qreal hue = std::fmod(id*0.618033988749895, 1.);
+    return QColor::fromHsvF(hue, 0.6, 0.9);
+}
+
+// cell centers of a roughly square grid covering the scene
+static QList<QPointF> gridPositions(const Canvas * const scene,
+                                    const int count)
+{
+    QList<QPointF> result;
+    const int columns = qMax(1, qCeil(std::sqrt(qreal(count))));
+    const int rows = qMax(1, qCeil(qreal(count)/columns));
+    const qreal cellWidth = qreal(scene->getCanvasWidth())/columns;
+    const qreal cellHeight = qreal(scene->getCanvasHeight())/rows;
+    for (int i = 0; i < count; i++) {
+        const int column = i % columns;
+        const int row = i / columns;
+        result << QPointF((column + 0.5)*cellWidth, (row + 0.5)*cellHeight);
+    }
+    return result;
+}
+
+static void setFlatFill(PathBox * const box,
+                        const QColor& color)
+{
+    const auto fill = box->getFillSettings();
+    fill->setPaintType(FLATPAINT);
+    fill->setCurrentColor(color);
+}
+
+// rotation around the box position over the whole frame range
+static void keyRotation(BoundingBox * const box,
+                        const int frames,
+                        const qreal degrees)
+{
+    const auto rot = box->getTransformAnimator()->getRotAnimator();
+    rot->anim_appendKey(enve::make_shared<QrealKey>(0, 0, rot));
+    rot->anim_appendKey(enve::make_shared<QrealKey>(degrees,
+                                                    qMax(1, frames - 1),
+                                                    rot));
+}
+
+static qsptr<RectangleBox> createRectangle(const QPointF& pos,
+                                           const QSizeF& size,
+                                           const QColor& color)
+{
+    const auto box = enve::make_shared<RectangleBox>();
+    box->setTopLeftPos(QPointF(-0.5*size.width(), -0.5*size.height()));
+    box->setBottomRightPos(QPointF(0.5*size.width(), 0.5*size.height()));
+    box->setRelativePos(pos);
+    setFlatFill(box.get(), color);
+    return box;
+}
+
+static qsptr<Circle> createCircle(const QPointF& pos,
+                                  const qreal radius,
+                                  const QColor& color)
+{
+    const auto box = enve::make_shared<Circle>();
+    box->setCenter(QPointF(0, 0));
+    box->setRadius(radius);
+    box->setRelativePos(pos);
+    setFlatFill(box.get(), color);
+    return box;
+}
+
+static qreal cellRadius(const Canvas * const scene,
+                        const int count)
+{
+    const int columns = qMax(1, qCeil(std::sqrt(qreal(count))));
+    return 0.4*qMin(scene->getCanvasWidth(), scene->getCanvasHeight())/columns;
+}
+
+static void buildPaths(Canvas * const scene,
+                       const BenchScenes::Config& config)
+{
+    const int count = PATH_BOXES*config.fScale;
+    const qreal radius = cellRadius(scene, count);
+    const auto positions = gridPositions(scene, count);
+    for (int i = 0; i < count; i++) {
+        const QColor color = boxColor(i);
+        qsptr<BoundingBox> box;
+        if (i % 2) {
+            box = createCircle(positions.at(i), radius, color);
+        } else {
+            box = createRectangle(positions.at(i),
+                                  QSizeF(2*radius, radius), color);
+        }
+        keyRotation(box.get(), config.fFrames, i % 3 ? 360 : -180);
+        scene->addContained(box);
+    }
+}
+
+static void buildGroups(Canvas * const scene,
+                        const BenchScenes::Config& config)
+{
+    const int depth = GROUP_DEPTH*config.fScale;
+    const QPointF center(0.5*scene->getCanvasWidth(),
+                         0.5*scene->getCanvasHeight());
+    qreal extent = 0.45*qMin(scene->getCanvasWidth(),
+                             scene->getCanvasHeight());
+
+    ContainerBox* parent = scene;
+    QPointF parentPos = center;
+    for (int level = 0; level < depth; level++) {
+        const auto group = enve::make_shared<ContainerBox>(eBoxType::group);
+        group->prp_setName(QString("Group %1").arg(level));
+        group->setRelativePos(parentPos);
+        keyRotation(group.get(), config.fFrames, level % 2 ? 45 : -45);
+        parent->addContained(group);
+
+        for (int i = 0; i < GROUP_CHILDREN; i++) {
+            const qreal angle = 2*M_PI*i/GROUP_CHILDREN;
+            const QPointF pos(extent*std::cos(angle), extent*std::sin(angle));
+            const qreal size = qMax(2., 0.15*extent);
+            const auto box = createRectangle(pos, QSizeF(size, size),
+                                             boxColor(level*GROUP_CHILDREN + i));
+            group->addContained(box);
+        }
+
+        parent = group.get();
+        parentPos = QPointF(0, 0);
+        extent *= 0.85;
+    }
+}
+
+static void buildText(Canvas * const scene,
+                      const BenchScenes::Config& config)
+{
+    const auto document = Document::sInstance;
+    const int count = TEXT_BOXES*config.fScale;
+    const auto positions = gridPositions(scene, count);
+    const qreal fontSize = qMax(8., 2*cellRadius(scene, count)/3);
+    for (int i = 0; i < count; i++) {
+        const auto box = enve::make_shared<TextBox>();
+        box->setFontFamilyAndStyle(document->fFontFamily,
+                                   document->fFontStyle);
+        box->setFontSize(fontSize);
+        box->setCurrentValue(QString("Friction %1\nbench").arg(i));
+        box->setRelativePos(positions.at(i));
+        setFlatFill(box.get(), boxColor(i));
+        keyRotation(box.get(), config.fFrames, 90);
+        scene->addContained(box);
+    }
+}
+
+static void buildRasterEffects(Canvas * const scene,
+                               const BenchScenes::Config& config)
+{
+    const int count = RASTER_EFFECT_BOXES*config.fScale;
+    const qreal radius = cellRadius(scene, count);
+    const auto positions = gridPositions(scene, count);
+    for (int i = 0; i < count; i++) {
+        const auto box = createRectangle(positions.at(i),
+                                         QSizeF(2*radius, 2*radius),
+                                         boxColor(i));
+        box->addRasterEffect(enve::make_shared<BlurEffect>());
+        box->addRasterEffect(enve::make_shared<ShadowEffect>());
+        keyRotation(box.get(), config.fFrames, 180);
+        scene->addContained(box);
+    }
+}
+
+static void buildPathEffects(Canvas * const scene,
+                             const BenchScenes::Config& config)
+{
+    const int count = PATH_EFFECT_BOXES*config.fScale;
+    const qreal radius = cellRadius(scene, count);
+    const auto positions = gridPositions(scene, count);
+    for (int i = 0; i < count; i++) {
+        const auto box = createCircle(positions.at(i), radius, boxColor(i));
+        box->addPathEffect(enve::make_shared<DisplacePathEffect>());
+        box->addPathEffect(enve::make_shared<ZigZagPathEffect>());
+        keyRotation(box.get(), config.fFrames, 360);
+        scene->addContained(box);
+    }
+}
+
+static void setExpression(QrealAnimator * const anim,
+                          const QString& script)
+{
+    try {
+        const auto expr = Expression::sCreate("frame = $frame;\n"
+                                              "value = $value;",
+                                              "", script, anim,
+                                              Expression::sQrealAnimatorTester);
+        if (expr && expr->isValid()) { anim->setExpression(expr); }
+    } catch (const std::exception& e) {
+        qWarning() << "Invalid bench expression" << e.what();
+    }
+}
+
+static void buildExpressions(Canvas * const scene,
+                             const BenchScenes::Config& config)
+{
+    const int count = EXPRESSION_BOXES*config.fScale;
+    const qreal radius = cellRadius(scene, count);
+    const auto positions = gridPositions(scene, count);
+    for (int i = 0; i < count; i++) {
+        const auto box = createRectangle(positions.at(i),
+                                         QSizeF(radius, radius),
+                                         boxColor(i));
+        const auto transform = box->getTransformAnimator();
+        const auto pos = transform->getPosAnimator();
+        setExpression(pos->getXAnimator(),
+                      QString("return value + %1*Math.sin(frame/8 + %2);")
+                      .arg(radius).arg(i));
+        setExpression(transform->getRotAnimator(),
+                      "return value + frame*6;");
+        scene->addContained(box);
+    }
+}
+
+static bool buildVideo(Canvas * const scene,
+                       const BenchScenes::Config& config)
+{
+    if (config.fVideo.isEmpty()) { return false; }
+    const int count = VIDEO_BOXES*config.fScale;
+    const auto positions = gridPositions(scene, count);
+    const int columns = qMax(1, qCeil(std::sqrt(qreal(count))));
+    for (int i = 0; i < count; i++) {
+        const auto box = enve::make_shared<VideoBox>();
+        box->setFilePath(config.fVideo);
+        const auto transform = box->getTransformAnimator();
+        transform->getScaleAnimator()->setBaseValue(QPointF(1., 1.)/columns);
+        box->setRelativePos(positions.at(i) -
+                            QPointF(0.5*scene->getCanvasWidth(),
+                                    0.5*scene->getCanvasHeight())/columns);
+        scene->addContained(box);
+    }
+    return true;
+}
+
+QStringList BenchScenes::sNames()
+{
+    return {"paths", "groups", "text", "raster_effects",
+            "path_effects", "expressions", "video"};
+}
+
+bool BenchScenes::sBuild(const QString& name,
+                         Canvas * const scene,
+                         const Config& config)
+{
+    if (name == "paths") { buildPaths(scene, config); }
+    else if (name == "groups") { buildGroups(scene, config); }
+    else if (name == "text") { buildText(scene, config); }
+    else if (name == "raster_effects") { buildRasterEffects(scene, config); }
+    else if (name == "path_effects") { buildPathEffects(scene, config); }
+    else if (name == "expressions") { buildExpressions(scene, config); }
+    else if (name == "video") { return buildVideo(scene, config); }
+    else { return false; }
+    return true;
+}
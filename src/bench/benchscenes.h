@@ -0,0 +1,51 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef BENCHSCENES_H
+#define BENCHSCENES_H
+
+#include <QStringList>
+
+class Canvas;
+
+//! @brief Synthetic scenes for friction-bench, every generator is
+//! deterministic so results can be compared between releases
+class BenchScenes
+{
+public:
+    struct Config {
+        int fFrames = 60;
+        int fScale = 1;
+        QString fVideo;
+    };
+
+    //! @brief Names of all generators, in run order
+    static QStringList sNames();
+    //! @brief Fills an empty scene, returns false if the generator
+    //! is unknown or can not run with the given config
+    static bool sBuild(const QString& name,
+                       Canvas * const scene,
+                       const Config& config);
+};
+
+#endif // BENCHSCENES_H
@@ -0,0 +1,188 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include <iostream>
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QSurfaceFormat>
+#include <QJsonDocument>
+#include <QFile>
+
+#include "hardwareinfo.h"
+#include "fileshandler.h"
+#include "efiltersettings.h"
+#include "actions.h"
+#include "Private/esettings.h"
+#include "Private/document.h"
+#include "Private/Tasks/taskscheduler.h"
+#include "Sound/esoundsettings.h"
+#include "benchrunner.h"
+#include "benchkernels.h"
+
+// same context setup as the application, the gpu
+// executor shares its context with the other threads
+void setDefaultFormat()
+{
+    QApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
+
+#ifdef USE_GLES
+    QApplication::setAttribute(Qt::AA_UseOpenGLES);
+#else
+    QApplication::setAttribute(Qt::AA_UseDesktopOpenGL);
+#endif
+
+    QSurfaceFormat format;
+
+#ifdef USE_GLES
+    format.setVersion(3, 0);
+    format.setProfile(QSurfaceFormat::NoProfile);
+#else
+    format.setVersion(3, 3);
+    format.setProfile(QSurfaceFormat::CoreProfile);
+#endif
+
+    format.setDepthBufferSize(24);
+    format.setStencilBufferSize(8);
+    format.setSamples(0);
+    QSurfaceFormat::setDefaultFormat(format);
+}
+
+int writeResults(const QJsonObject& results,
+                 const QString& output)
+{
+    const QByteArray json = QJsonDocument(results).toJson(QJsonDocument::Indented);
+    if (output.isEmpty()) {
+        std::cout << json.toStdString() << std::endl;
+        return 0;
+    }
+    QFile file(output);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        std::cerr << "Could not open " << output.toStdString() << std::endl;
+        return 1;
+    }
+    file.write(json);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    setDefaultFormat();
+
+    QApplication app(argc, argv);
+    setlocale(LC_NUMERIC, "C");
+    QApplication::setApplicationName("friction-bench");
+    QApplication::setApplicationVersion(PROJECT_VERSION);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Friction render benchmark. "
+                                     "Run with '-platform offscreen' "
+                                     "on machines without a display.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    const QCommandLineOption scenesOpt("scene",
+                                       "Scene to run (" +
+                                       BenchScenes::sNames().join(", ") +
+                                       "), can be repeated, default all.",
+                                       "name");
+    const QCommandLineOption framesOpt("frames", "Frames per scene.",
+                                       "count", "60");
+    const QCommandLineOption scaleOpt("scale", "Scene complexity multiplier.",
+                                      "factor", "1");
+    const QCommandLineOption widthOpt("width", "Scene width.",
+                                      "pixels", "1280");
+    const QCommandLineOption heightOpt("height", "Scene height.",
+                                       "pixels", "720");
+    const QCommandLineOption fpsOpt("fps", "Scene frame rate.",
+                                    "fps", "30");
+    const QCommandLineOption resolutionOpt("resolution",
+                                           "Render resolution (0.1 - 1).",
+                                           "factor", "1");
+    const QCommandLineOption videoOpt("video",
+                                      "Video file for the video scene.",
+                                      "file");
+    const QCommandLineOption kernelsOpt("kernels",
+                                        "Only compare the pixel and effect kernels "
+                                        "against their scalar references, exits "
+                                        "with 2 if a kernel is out of tolerance.");
+    const QCommandLineOption iterationsOpt("iterations",
+                                           "Timed runs per kernel, the fastest counts.",
+                                           "count", "10");
+    const QCommandLineOption outputOpt("output",
+                                       "Write results to file instead of stdout.",
+                                       "file");
+    parser.addOptions({scenesOpt, framesOpt, scaleOpt, widthOpt, heightOpt,
+                       fpsOpt, resolutionOpt, videoOpt, kernelsOpt,
+                       iterationsOpt, outputOpt});
+    parser.process(app);
+
+    const int iterations = qMax(1, parser.value(iterationsOpt).toInt());
+    if (parser.isSet(kernelsOpt)) {
+        const QJsonObject results = BenchKernels::sRun(iterations);
+        const int status = writeResults(results, parser.value(outputOpt));
+        if (status != 0) { return status; }
+        return BenchKernels::sPassed(results) ? 0 : 2;
+    }
+
+    BenchRunner::Options options;
+    options.fScenes = parser.values(scenesOpt);
+    for (const auto& name : options.fScenes) {
+        if (BenchScenes::sNames().contains(name)) { continue; }
+        std::cerr << "Unknown scene: " << name.toStdString() << std::endl;
+        return 1;
+    }
+    options.fWidth = qMax(1, parser.value(widthOpt).toInt());
+    options.fHeight = qMax(1, parser.value(heightOpt).toInt());
+    options.fFps = qMax(1., parser.value(fpsOpt).toDouble());
+    options.fResolution = qBound(0.1, parser.value(resolutionOpt).toDouble(), 1.);
+    options.fConfig.fFrames = qMax(1, parser.value(framesOpt).toInt());
+    options.fConfig.fScale = qMax(1, parser.value(scaleOpt).toInt());
+    options.fConfig.fVideo = parser.value(videoOpt);
+    options.fKernelIterations = iterations;
+
+    try {
+        HardwareInfo::sUpdateInfo();
+    } catch(const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    // default settings only, user preferences would skew results
+    eSettings settings(HardwareInfo::sCpuThreads(),
+                       HardwareInfo::sRamKB());
+    eFilterSettings filterSettings;
+    TaskScheduler taskScheduler;
+    Document document(taskScheduler);
+    Actions actions(document);
+    FilesHandler filesHandler;
+    eSoundSettings soundSettings;
+
+    try {
+        taskScheduler.initializeGpu();
+    } catch(const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    BenchRunner runner(document, options);
+    return writeResults(runner.run(), parser.value(outputOpt));
+}
@@ -94,7 +94,7 @@ int Animator::anim_getNextKeyRelFrame(const int relFrame) const {
 }
 
 void Animator::prp_afterChangedAbsRange(const FrameRange &range, const bool clip) {
-    if(range.inRange(anim_mCurrentAbsFrame))
+    if(range.inRange(anim_getCurrentAbsFrame()))
         prp_afterChangedCurrent(UpdateReason::userChange);
     emit prp_absFrameRangeChanged(range, clip);
 }
@@ -111,10 +111,36 @@ void Animator::anim_updateAfterChangedKey(Key * const key) {
 }
 
 void Animator::anim_setAbsFrame(const int frame) {
+    anim_mFrameEpoch++;
+    if(const auto parent = getParent<Animator>()) {
+        anim_mParentFrameEpoch = parent->anim_mFrameEpoch;
+    }
     anim_mCurrentAbsFrame = frame;
     anim_updateRelFrame();
 }
 
+void Animator::anim_syncAbsFrame() const {
+    // frame dependent animators are always set by their parent
+    if(anim_isFrameDependent()) return;
+    const auto parent = getParent<Animator>();
+    if(!parent) return;
+    parent->anim_syncAbsFrame();
+    if(anim_mParentFrameEpoch == parent->anim_mFrameEpoch) return;
+    const auto that = const_cast<Animator*>(this);
+    that->anim_mParentFrameEpoch = parent->anim_mFrameEpoch;
+    const int frame = parent->anim_mCurrentAbsFrame;
+    if(frame == anim_mCurrentAbsFrame) return;
+    that->anim_mFrameEpoch++;
+    that->anim_mCurrentAbsFrame = frame;
+    that->anim_updateRelFrame();
+}
+
+void Animator::anim_afterFrameDependencyChanged() {
+    if(const auto parent = getParent<Animator>()) {
+        parent->anim_afterFrameDependencyChanged();
+    }
+}
+
 void Animator::anim_updateRelFrame() {
     anim_mCurrentRelFrame = anim_mCurrentAbsFrame - prp_getTotalFrameShift();
     anim_updateKeyOnCurrrentFrame();
@@ -210,11 +236,14 @@ void Animator::anim_readKeys(eReadStream& src) {
     int nKeys; src >> nKeys;
     if(nKeys < 0 || nKeys > 10000)
         RuntimeThrow("Invalid key count " + std::to_string(nKeys));
+    QList<stdsptr<Key>> keys;
+    keys.reserve(nKeys);
     for(int i = 0; i < nKeys; i++) {
         const auto key = anim_createKey();
         key->readKey(src);
-        anim_appendKey(key);
+        keys << key;
     }
+    anim_appendKeys(keys);
 }
 
 void Animator::anim_writeSelectedKeys(eWriteStream &dst) {
@@ -272,15 +301,36 @@ void Animator::anim_removeKeyAction(const stdsptr<Key> newKey)
 }
 
 void Animator::anim_appendKey(const stdsptr<Key>& newKey) {
+    anim_syncAbsFrame();
     const bool isComplex = toComplexAnimator();
     if(!isComplex) anim_setRecordingValue(true);
     anim_mKeys.add(newKey);
+    if(anim_mKeys.count() == 1) anim_afterFrameDependencyChanged();
     if(newKey->getRelFrame() == anim_mCurrentRelFrame)
         anim_setKeyOnCurrentFrame(newKey.get());
     if(!isComplex) anim_updateAfterChangedKey(newKey.get());
     emit anim_addedKey(newKey.get(), QPrivateSignal());
 }
 
+void Animator::anim_appendKeys(const QList<stdsptr<Key>>& newKeys) {
+    if(newKeys.isEmpty()) return;
+    anim_syncAbsFrame();
+    const bool isComplex = toComplexAnimator();
+    if(!isComplex) anim_setRecordingValue(true);
+    const int iLast = newKeys.count() - 1;
+    for(int i = 0; i <= iLast; i++) {
+        const auto& newKey = newKeys.at(i);
+        anim_mKeys.add(newKey);
+        if(anim_mKeys.count() == 1) anim_afterFrameDependencyChanged();
+        if(newKey->getRelFrame() == anim_mCurrentRelFrame)
+            anim_setKeyOnCurrentFrame(newKey.get());
+        anim_mAppendingKeys = i < iLast;
+        emit anim_addedKey(newKey.get(), QPrivateSignal());
+    }
+    anim_mAppendingKeys = false;
+    if(!isComplex) prp_afterWholeInfluenceRangeChanged();
+}
+
 void Animator::anim_removeKey(const stdsptr<Key>& keyToRemove) {
     anim_removeKeyFromSelected(keyToRemove.get());
     removeKeyWithoutDeselecting(keyToRemove);
@@ -306,6 +356,7 @@ void Animator::removeKeyWithoutDeselecting(const stdsptr<Key>& keyToRemove) {
     Key * const keyPtr = keyToRemove.get();
     anim_updateAfterChangedKey(keyPtr);
     anim_mKeys.remove(keyToRemove);
+    if(anim_mKeys.isEmpty()) anim_afterFrameDependencyChanged();
 
     const int rFrame = keyPtr->getRelFrame();
     if(rFrame == anim_mCurrentRelFrame)
@@ -443,10 +494,12 @@ std::pair<int, int> Animator::anim_getPrevAndNextKeyIdF(const qreal relFrame) co
 }
 
 int Animator::anim_getCurrentAbsFrame() const {
+    anim_syncAbsFrame();
     return anim_mCurrentAbsFrame;
 }
 
 int Animator::anim_getCurrentRelFrame() const {
+    anim_syncAbsFrame();
     return anim_mCurrentRelFrame;
 }
 
@@ -45,6 +45,7 @@ class CORE_EXPORT Animator : public Property {
     Q_OBJECT
     e_DECLARE_TYPE(Animator)
     friend class OverlappingKeys;
+    friend class ComplexAnimator;
 protected:
     Animator(const QString &name);
 
@@ -67,6 +68,10 @@ public:
                                   const int keyRectSize);
     virtual void anim_setAbsFrame(const int frame);
     virtual bool anim_isDescendantRecording() const;
+    //! @brief False if the current value does not change with the frame,
+    //! such animators are skipped by ComplexAnimator::anim_setAbsFrame
+    //! and pick up the frame of their parent when it is queried
+    virtual bool anim_isFrameDependent() const { return true; }
 
     virtual TimelineMovable *anim_getTimelineMovable(
                 const int relX, const int minViewedFrame,
@@ -100,6 +105,8 @@ public:
 public:
     void anim_saveCurrentValueAsKey();
     void anim_appendKey(const stdsptr<Key> &newKey);
+    //! @brief Appends keys sorted by frame, updating once for all of them
+    void anim_appendKeys(const QList<stdsptr<Key>> &newKeys);
     void anim_removeKey(const stdsptr<Key>& keyToRemove);
     void anim_removeKeys(const FrameRange& relRange, const bool action);
     void anim_removeAllKeysFromComplexAnimator(ComplexAnimator *target);
@@ -218,10 +225,19 @@ public:
                  const QString& interpolation = "linear",
                  QList<Animator*> const extInfl = QList<Animator*>()) const;
 protected:
+    //! @brief Call when anim_isFrameDependent might have changed
+    virtual void anim_afterFrameDependencyChanged();
+    //! @brief Catch up with the frame of a parent that skipped this
+    void anim_syncAbsFrame() const;
+
     void anim_readKeys(eReadStream &src);
     void anim_writeKeys(eWriteStream& dst) const;
 
     IdRange anim_frameRangeToKeyIdRange(const FrameRange& relRange) const;
+
+    //! @brief Set while anim_addedKey is emitted for any but the last
+    //! of the keys appended with anim_appendKeys
+    bool anim_mAppendingKeys = false;
 signals:
     void anim_isRecordingChanged();
     void anim_changedKeyOnCurrentFrame(Key* key, QPrivateSignal);
@@ -236,6 +252,10 @@ private:
 
     int anim_mCurrentAbsFrame = 0;
     int anim_mCurrentRelFrame = 0;
+    //! @brief Incremented whenever anim_mCurrentAbsFrame is set
+    uint anim_mFrameEpoch = 0;
+    //! @brief Parent's anim_mFrameEpoch when this frame was last set
+    uint anim_mParentFrameEpoch = 0;
     stdptr<Key> anim_mKeyOnCurrentFrame;
     QList<Key*> anim_mSelectedKeys;
     OverlappingKeyList anim_mKeys;
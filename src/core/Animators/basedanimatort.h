@@ -75,6 +75,8 @@ public:
                                   const bool clip) override;
 
     void anim_setAbsFrame(const int frame) override;
+    bool anim_isFrameDependent() const override
+    { return this->anim_hasKeys(); }
 
     void anim_addKeyAtRelFrame(const int relFrame) override;
 
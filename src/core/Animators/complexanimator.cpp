@@ -144,7 +144,9 @@ void ComplexAnimator::ca_insertChild(const qsptr<Property>& child,
         if(ca_mHiddenEmpty) SWT_setVisible(true);
     }
 
+    anim_syncAbsFrame();
     ca_mChildren.insert(id, child);
+    anim_afterFrameDependencyChanged();
     child->setParent(this);
     child->prp_setInheritedFrameShift(prp_getTotalFrameShift(), this);
     if(child->prp_drawsOnCanvas() ||
@@ -288,6 +290,7 @@ void ComplexAnimator::ca_removeChild(const qsptr<Property> child) {
     const auto childRange = child->prp_absInfluenceRange();
     if(const auto childAnimator = enve_cast<Animator*>(child.get())) {
         childAnimator->anim_removeAllKeysFromComplexAnimator(this);
+        childAnimator->anim_syncAbsFrame();
     }
     disconnect(child.get(), nullptr, this, nullptr);
 
@@ -295,6 +298,7 @@ void ComplexAnimator::ca_removeChild(const qsptr<Property> child) {
 
     child->setParent(nullptr);
     ca_mChildren.removeAt(ca_getChildPropertyIndex(child.get()));
+    anim_afterFrameDependencyChanged();
     if(child->prp_drawsOnCanvas() ||
        enve_cast<ComplexAnimator*>(child)) {
         prp_updateCanvasProps();
@@ -359,16 +363,34 @@ void ComplexAnimator::prp_afterFrameShiftChanged(const FrameRange &oldAbsRange,
 }
 
 void ComplexAnimator::anim_setAbsFrame(const int frame) {
-    //if(!anim_isDescendantRecording()) return;
     Animator::anim_setAbsFrame(frame);
 
     for(const auto &property : ca_mChildren) {
-        if(const auto asAnim = enve_cast<Animator*>(property.get())) {
+        const auto asAnim = enve_cast<Animator*>(property.get());
+        // the others catch up lazily, see Animator::anim_syncAbsFrame
+        if(asAnim && asAnim->anim_isFrameDependent()) {
             asAnim->anim_setAbsFrame(frame);
         }
     }
 }
 
+bool ComplexAnimator::anim_isFrameDependent() const {
+    if(ca_mFrameDependencyValid) return ca_mFrameDependent;
+    ca_mFrameDependencyValid = true;
+    ca_mFrameDependent = anim_hasKeys();
+    for(const auto &property : ca_mChildren) {
+        if(ca_mFrameDependent) break;
+        const auto asAnim = enve_cast<Animator*>(property.get());
+        ca_mFrameDependent = asAnim && asAnim->anim_isFrameDependent();
+    }
+    return ca_mFrameDependent;
+}
+
+void ComplexAnimator::anim_afterFrameDependencyChanged() {
+    ca_mFrameDependencyValid = false;
+    Animator::anim_afterFrameDependencyChanged();
+}
+
 void ComplexAnimator::prp_finishTransform() {
     for(const auto &property : ca_mChildren)
         property->prp_finishTransform();
@@ -54,6 +54,7 @@ public:
     void SWT_setChildrenAncestorDisabled(const bool bT);
 
     void anim_setAbsFrame(const int frame);
+    bool anim_isFrameDependent() const;
 
     bool prp_dependsOn(const Property* const prop) const;
 
@@ -151,6 +152,8 @@ signals:
     void ca_childRemoved(Property*);
     void ca_childMoved(Property*);
 protected:
+    void anim_afterFrameDependencyChanged();
+
     void ca_addChild(const qsptr<Property> &child);
     void ca_insertChild(const qsptr<Property> &child, const int id);
     void ca_removeChild(const qsptr<Property> child);
@@ -172,6 +175,8 @@ private:
     bool ca_mDisabledEmpty = true;
     bool ca_mHiddenEmpty = false;
     bool ca_mChildRecording = false;
+    mutable bool ca_mFrameDependencyValid = false;
+    mutable bool ca_mFrameDependent = true;
     qptr<Property> ca_mGUIProperty;
     QList<qsptr<Property>> ca_mChildren;
 };
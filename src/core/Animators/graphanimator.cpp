@@ -44,6 +44,8 @@ GraphAnimator::GraphAnimator(const QString& name) : Animator(name) {
         prev.fRange.fMax = key->getRelFrame();
         graph_mKeyPaths.insert(splitId + 1, next);
 
+        // appended in bulk, constrain once after the last key
+        if(anim_mAppendingKeys) return;
         graph_constrainCtrlsFrameValues();
     });
 
@@ -49,6 +49,8 @@ public:
                                   const bool clip) override;
 
     void anim_setAbsFrame(const int frame) override;
+    bool anim_isFrameDependent() const override
+    { return this->anim_hasKeys(); }
     stdsptr<Key> anim_createKey() override;
     void anim_addKeyAtRelFrame(const int relFrame) override;
 
@@ -34,6 +34,9 @@
 #include "Segments/fitcurves.h"
 #include "svgexporter.h"
 #include "Properties/namedproperty.h"
+#include "ReadWrite/evformat.h"
+
+#include <cstring>
 
 QrealAnimator::QrealAnimator(const qreal iniVal,
                              const qreal minVal,
@@ -76,8 +79,166 @@ void QrealAnimator::prp_setupTreeViewMenu(PropertyMenu * const menu) {
     Animator::prp_setupTreeViewMenu(menu);
 }
 
+// value, c0 frame, c0 value, c1 frame, c1 value
+#define PACKED_COLUMNS 5
+
+static quint64 zigZag(const qint64 value) {
+    return (quint64(value) << 1) ^ quint64(value >> 63);
+}
+
+static qint64 unZigZag(const quint64 value) {
+    return qint64(value >> 1) ^ -qint64(value & 1);
+}
+
+static void writeVarUInt(QByteArray& dst, quint64 value) {
+    while(value >= 0x80) {
+        dst.append(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    dst.append(char(value));
+}
+
+static quint64 readVarUInt(const char*& it, const char* const end) {
+    quint64 result = 0;
+    for(int shift = 0; shift < 64; shift += 7) {
+        if(it == end) RuntimeThrow("Unexpected end of packed keys");
+        const quint8 byte = quint8(*it++);
+        result |= quint64(byte & 0x7f) << shift;
+        if(!(byte & 0x80)) return result;
+    }
+    RuntimeThrow("Invalid packed key frame");
+}
+
+static bool fitsFloat(const QVector<qreal>& column) {
+    for(const qreal value : column) {
+        if(qreal(float(value)) != value) return false;
+    }
+    return true;
+}
+
+static void appendColumn(QByteArray& dst, const QVector<qreal>& column,
+                         const bool asDouble) {
+    if(asDouble) {
+        dst.append(reinterpret_cast<const char*>(column.constData()),
+                   column.count()*int(sizeof(qreal)));
+    } else {
+        for(const qreal value : column) {
+            const float fValue = float(value);
+            dst.append(reinterpret_cast<const char*>(&fValue), sizeof(float));
+        }
+    }
+}
+
+static qreal columnValue(const char* const column, const int id,
+                         const bool asDouble) {
+    if(asDouble) {
+        qreal value;
+        memcpy(&value, column + id*sizeof(qreal), sizeof(qreal));
+        return value;
+    }
+    float value;
+    memcpy(&value, column + id*sizeof(float), sizeof(float));
+    return qreal(value);
+}
+
+// Keys are stored as a single compressed block of columns: frames as
+// zig-zag varint deltas, control point flags, then each value column
+// as floats when all its values survive the conversion, doubles otherwise.
+void QrealAnimator::writePackedKeys(eWriteStream& dst) const {
+    const auto& keys = anim_getKeys();
+    const int nKeys = keys.count();
+    dst << nKeys;
+    if(nKeys == 0) return;
+
+    QByteArray frames;
+    QByteArray flags;
+    flags.reserve(nKeys);
+    QVector<qreal> columns[PACKED_COLUMNS];
+    for(auto& column : columns) column.reserve(nKeys);
+    int prevFrame = 0;
+    for(const auto key : keys) {
+        const auto qaKey = static_cast<QrealKey*>(key);
+        const int frame = qaKey->getRelFrame();
+        writeVarUInt(frames, zigZag(qint64(frame) - prevFrame));
+        prevFrame = frame;
+        flags.append(char((qaKey->getC0Enabled() ? 1 : 0) |
+                          (qaKey->getC1Enabled() ? 2 : 0)));
+        const auto& c0 = qaKey->c0Clamped();
+        const auto& c1 = qaKey->c1Clamped();
+        columns[0] << qaKey->getValue();
+        columns[1] << c0.getRawXValue();
+        columns[2] << c0.getRawYValue();
+        columns[3] << c1.getRawXValue();
+        columns[4] << c1.getRawYValue();
+    }
+
+    quint8 doubleColumns = 0;
+    for(int i = 0; i < PACKED_COLUMNS; i++) {
+        if(!fitsFloat(columns[i])) doubleColumns |= 1 << i;
+    }
+    QByteArray block;
+    block.append(char(doubleColumns));
+    block.append(frames);
+    block.append(flags);
+    for(int i = 0; i < PACKED_COLUMNS; i++) {
+        appendColumn(block, columns[i], doubleColumns & (1 << i));
+    }
+    dst.writeCompressed(block.constData(), block.size());
+}
+
+void QrealAnimator::readPackedKeys(eReadStream& src) {
+    int nKeys; src >> nKeys;
+    if(nKeys < 0) RuntimeThrow("Invalid key count " + std::to_string(nKeys));
+    if(nKeys == 0) return;
+
+    const QByteArray block = src.readCompressed();
+    // flags, at least one byte per frame and float columns
+    const qint64 minSize = 1 + qint64(nKeys)*(2 + PACKED_COLUMNS*sizeof(float));
+    if(block.size() < minSize) RuntimeThrow("Invalid packed keys");
+    const char* it = block.constData();
+    const char* const end = it + block.size();
+
+    const quint8 doubleColumns = quint8(*it++);
+    QVector<int> frames;
+    frames.reserve(nKeys);
+    qint64 frame = 0;
+    for(int i = 0; i < nKeys; i++) {
+        frame += unZigZag(readVarUInt(it, end));
+        frames << int(frame);
+    }
+
+    if(end - it < nKeys) RuntimeThrow("Unexpected end of packed keys");
+    const char* const flags = it;
+    it += nKeys;
+    const char* columns[PACKED_COLUMNS];
+    for(int i = 0; i < PACKED_COLUMNS; i++) {
+        const bool asDouble = doubleColumns & (1 << i);
+        const qint64 size = nKeys*qint64(asDouble ? sizeof(qreal) : sizeof(float));
+        if(end - it < size) RuntimeThrow("Unexpected end of packed keys");
+        columns[i] = it;
+        it += size;
+    }
+
+    QList<stdsptr<Key>> keys;
+    keys.reserve(nKeys);
+    for(int i = 0; i < nKeys; i++) {
+        const auto value = [&](const int column) {
+            return columnValue(columns[column], i, doubleColumns & (1 << column));
+        };
+        const auto key = enve::make_shared<QrealKey>(value(0), frames.at(i), this);
+        key->setC0Enabled(flags[i] & 1);
+        key->setC1Enabled(flags[i] & 2);
+        key->setC0FrameVar(value(1));
+        key->setC0ValueVar(value(2));
+        key->setC1FrameVar(value(3));
+        key->setC1ValueVar(value(4));
+        keys << key;
+    }
+    anim_appendKeys(keys);
+}
+
 void QrealAnimator::prp_writeProperty_impl(eWriteStream& dst) const {
-    anim_writeKeys(dst);
+    writePackedKeys(dst);
     dst << mCurrentBaseValue;
     dst << !!mExpression;
     if(mExpression) {
@@ -92,10 +253,11 @@ stdsptr<Key> QrealAnimator::anim_createKey() {
 }
 
 void QrealAnimator::prp_readProperty_impl(eReadStream& src) {
-    anim_readKeys(src);
+    const auto evVersion = src.evFileVersion();
+    if(evVersion >= EvFormat::packedKeys) readPackedKeys(src);
+    else anim_readKeys(src);
 
     qreal val; src >> val;
-    const auto evVersion = src.evFileVersion();
     if(evVersion > 8 && evVersion < 15) {
         QString expression; src >> expression;
     } else if(evVersion >= 15) {
@@ -412,7 +574,9 @@ void QrealAnimator::applyExpression(const FrameRange& relRange,
 }
 
 void QrealAnimator::setExpression(const qsptr<Expression>& expression) {
+    anim_syncAbsFrame();
     auto& conn = mExpression.assign(expression);
+    anim_afterFrameDependencyChanged();
     if(expression) {
         const int absFrame = anim_getCurrentAbsFrame();
         expression->setAbsFrame(absFrame);
@@ -551,6 +715,10 @@ void QrealAnimator::anim_setAbsFrame(const int frame) {
     if(changed) prp_afterChangedCurrent(UpdateReason::frameChange);
 }
 
+bool QrealAnimator::anim_isFrameDependent() const {
+    return anim_hasKeys() || hasExpression();
+}
+
 void QrealAnimator::anim_addKeyAtRelFrame(const int relFrame) {
     if(anim_getKeyAtRelFrame(relFrame)) return;
     const qreal value = getBaseValue(relFrame);
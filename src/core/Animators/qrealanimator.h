@@ -82,6 +82,7 @@ public:
                                     const FrameRange &newAbsRange);
 
     void anim_setAbsFrame(const int frame);
+    bool anim_isFrameDependent() const;
     void anim_removeAllKeys();
     void anim_addKeyAtRelFrame(const int relFrame);
 
@@ -203,6 +204,8 @@ public:
                       const QString & motionPath = QString());
 private:
     qreal calculateBaseValueAtRelFrame(const qreal frame) const;
+    void writePackedKeys(eWriteStream& dst) const;
+    void readPackedKeys(eReadStream& src);
     void startBaseValueTransform();
     void finishBaseValueTransform();
     bool updateExpressionRelFrame();
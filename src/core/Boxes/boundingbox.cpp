@@ -28,6 +28,8 @@
 #include "TransformEffects/followpatheffect.h"
 #include "canvas.h"
 #include "swt_abstraction.h"
+#include "Tasks/renderprofiler.h"
+#include "Tasks/metricsregistry.h"
 #include "Timeline/durationrectangle.h"
 #include "pointhelpers.h"
 #include "skia/skqtconversions.h"
@@ -55,6 +57,7 @@
 #include "svgexporter.h"
 #include "svgexporthelpers.h"
 #include "internallinkcanvas.h"
+#include "simpletask.h"
 
 #include <QInputDialog>
 #include <QMessageBox>
@@ -107,6 +110,8 @@ BoundingBox::BoundingBox(const QString& name, const eBoxType type) :
 
 BoundingBox::~BoundingBox() {
     sDocumentBoxes.removeOne(this);
+    // deleted while a project is written in steps
+    if(mWriteId >= 0) sBoxesWithWriteIds.removeOne(this);
 }
 
 void BoundingBox::writeBoundingBox(eWriteStream& dst) const {
@@ -158,10 +163,40 @@ BoundingBox *BoundingBox::sGetBoxByDocumentId(const int documentId) {
 
 void BoundingBox::prp_afterChangedAbsRange(const FrameRange &range, const bool clip) {
     const auto croppedRange = clip ? prp_absInfluenceRange()*range : range;
-    StaticComplexAnimator::prp_afterChangedAbsRange(croppedRange, clip);
     if(croppedRange.inRange(anim_getCurrentAbsFrame())) {
         planUpdate(UpdateReason::userChange);
     }
+    // changes are merged and passed up the tree once
+    // per update, see Document::updateScenes
+    addChangedAbsRange(croppedRange, clip);
+    if(mChangedRangePlanned) return;
+    mChangedRangePlanned = true;
+    SimpleTask::sScheduleContexted(this, [this]() { flushChangedAbsRanges(); });
+}
+
+void BoundingBox::addChangedAbsRange(FrameRange range, bool clip) {
+    if(!range.isValid()) return;
+    // only overlapping or adjacent ranges are merged,
+    // frames between separate edits stay cached
+    for(int i = 0; i < mChangedRanges.count();) {
+        const auto& changed = mChangedRanges.at(i);
+        if(changed.fRange.overlaps(range) || changed.fRange.neighbours(range)) {
+            range += changed.fRange;
+            clip = clip && changed.fClip;
+            mChangedRanges.removeAt(i);
+        } else i++;
+    }
+    mChangedRanges.append({range, clip});
+}
+
+void BoundingBox::flushChangedAbsRanges() {
+    const auto ranges = mChangedRanges;
+    mChangedRanges.clear();
+    mChangedRangePlanned = false;
+    for(const auto& changed : ranges) {
+        StaticComplexAnimator::prp_afterChangedAbsRange(changed.fRange,
+                                                        changed.fClip);
+    }
 }
 
 void BoundingBox::ca_childIsRecordingChanged() {
@@ -479,6 +514,9 @@ void BoundingBox::setParentTransform(BasicTransformAnimator *parent) {
 }
 
 void BoundingBox::afterTotalTransformChanged(const UpdateReason reason) {
+    if(const auto parent = getParentGroup()) {
+        parent->containedBoundsChanged(this);
+    }
     updateDrawRenderContainerTransform();
     planUpdate(reason);
     requestGlobalPivotUpdateIfSelected();
@@ -524,6 +562,9 @@ void BoundingBox::setRelBoundingRect(const QRectF& relRect) {
     mRelRectSk = toSkRect(mRelRect);
     mSkRelBoundingRectPath.reset();
     mSkRelBoundingRectPath.addRect(mRelRectSk);
+    if(const auto parent = getParentGroup()) {
+        parent->containedBoundsChanged(this);
+    }
 
     if(mCenterPivotPlanned) {
         mCenterPivotPlanned = false;
@@ -555,6 +596,7 @@ void BoundingBox::planUpdate(const UpdateReason reason) {
     if(reason == UpdateReason::userChange) {
         mStateId++;
         mRenderDataHandler.clear();
+        mIdenticalRenderData.reset();
 #ifdef Q_OS_MAC
         if (const auto canvas = enve_cast<Canvas*>(this)) {
             canvas->invalidateSceneFramesCache();
@@ -599,7 +641,17 @@ void BoundingBox::queTasks() {
     mUpdatePlanned = false;
     if(!shouldScheduleUpdate()) return;
     const int relFrame = anim_getCurrentRelFrame();
-    if(hasCurrentRenderData(relFrame)) return;
+    static auto& hits = MetricsRegistry::sCounter("cache.render_data.hits");
+    static auto& misses = MetricsRegistry::sCounter("cache.render_data.misses");
+    if(hasCurrentRenderData(relFrame)) {
+        hits.add();
+        if(RenderProfiler::sEnabled()) {
+            RenderProfiler::sInstant("cache", "render data hit",
+                                     prp_getName());
+        }
+        return;
+    }
+    misses.add();
     const auto parentM = getInheritedTransformAtFrame(relFrame);
     queRender(relFrame, parentM);
 }
@@ -631,15 +683,69 @@ stdsptr<BoxRenderData> BoundingBox::getCurrentRenderData(const qreal relFrame) c
     const auto currentRenderData =
             mRenderDataHandler.getItemAtRelFrame(relFrame);
     if(currentRenderData) return currentRenderData->ref<BoxRenderData>();
-    if(mDrawRenderContainer.isExpired()) return nullptr;
-    const auto drawData = mDrawRenderContainer.getSrcRenderData();
-    if(!drawData) return nullptr;
-    if(!diffsIncludingInherited(drawData->fRelFrame, relFrame)) {
-        const auto copy = drawData->makeCopy();
-        copy->fRelFrame = relFrame;
-        return copy;
+    if(!mDrawRenderContainer.isExpired()) {
+        const auto drawData = mDrawRenderContainer.getSrcRenderData();
+        if(drawData && !diffsIncludingInherited(drawData->fRelFrame, relFrame)) {
+            const auto copy = drawData->makeCopy();
+            copy->fRelFrame = relFrame;
+            return copy;
+        }
     }
-    return nullptr;
+    return getIdenticalRenderData(relFrame);
+}
+
+FrameRange BoundingBox::getIdenticalRelRangeIncludingInherited(
+        const int relFrame) const {
+    FrameRange range = prp_getIdenticalRelRange(relFrame);
+    const int absFrame = prp_relFrameToAbsFrame(relFrame);
+    auto parent = getParentGroup();
+    while(parent && !range.isUnary()) {
+        const int parentRelFrame = parent->prp_absFrameToRelFrame(absFrame);
+        const auto parentRange =
+                parent->BoundingBox::prp_getIdenticalRelRange(parentRelFrame);
+        const auto parentAbsRange = parent->prp_relRangeToAbsRange(parentRange);
+        range *= prp_absRangeToRelRange(parentAbsRange);
+        parent = parent->getParentGroup();
+    }
+    return range;
+}
+
+QVector<uint> BoundingBox::inheritedStateIds() const {
+    QVector<uint> ids{mStateId};
+    for(auto parent = getParentGroup(); parent;
+        parent = parent->getParentGroup()) {
+        ids << parent->mStateId;
+    }
+    return ids;
+}
+
+stdsptr<BoxRenderData> BoundingBox::getIdenticalRenderData(
+        const qreal relFrame) const {
+    if(!mIdenticalRenderData) return nullptr;
+    const auto data = mIdenticalRenderData->getData();
+    if(!data) return nullptr;
+    if(!mIdenticalRange.inRange(qFloor(relFrame)) ||
+       !mIdenticalRange.inRange(qCeil(relFrame))) return nullptr;
+    const auto scene = getParentScene();
+    if(!scene) return nullptr;
+    const qreal resolution = scene->getRenderResolution();
+    if(!isZero4Dec(data->fResolution - resolution)) {
+        return nullptr;
+    }
+    if(mIdenticalStateIds != inheritedStateIds()) return nullptr;
+    const auto copy = data->makeCopy();
+    copy->fRelFrame = relFrame;
+    return copy;
+}
+
+void BoundingBox::updateIdenticalRenderData(BoxRenderData * const renderData) {
+    const qreal relFrame = renderData->fRelFrame;
+    const auto range = getIdenticalRelRangeIncludingInherited(qFloor(relFrame));
+    if(range.isUnary() || !range.inRange(qCeil(relFrame))) return;
+    mIdenticalRenderData = enve::make_shared<RenderDataCacheContainer>(
+                renderData->ref<BoxRenderData>());
+    mIdenticalRange = range;
+    mIdenticalStateIds = inheritedStateIds();
 }
 
 bool BoundingBox::isContainedIn(const QRectF &absRect) const {
@@ -1100,7 +1206,7 @@ void BoundingBox::setupWithoutRasterEffects(const qreal relFrame,
     data->fInheritedTransform = parentM;
     data->fTotalTransform = thisRelM*parentM;
 
-    data->fResolution = scene->getResolution();
+    data->fResolution = scene->getRenderResolution();
     data->fResolutionScale.reset();
     data->fResolutionScale.scale(data->fResolution, data->fResolution);
     data->fOpacity = getOpacity(relFrame);
@@ -1461,8 +1567,6 @@ void BoundingBox::sClearWriteBoxes() {
     sBoxesWithWriteIds.clear();
 }
 
-#include "simpletask.h"
-
 void BoundingBox::selectAndAddContainedPointsToList(
         const QRectF &absRect,
         const MovablePoint::PtOp &adder,
@@ -1558,6 +1662,9 @@ void BoundingBox::renderDataFinished(BoxRenderData *renderData) {
     const bool currentState = renderData->fBoxStateId == mStateId;
     const qreal relFrame = renderData->fRelFrame;
     if(currentState) mRenderDataHandler.removeItemAtRelFrame(relFrame);
+    if(currentState && renderData->fRenderedImage) {
+        updateIdenticalRenderData(renderData);
+    }
     auto currentRenderData = mDrawRenderContainer.getSrcRenderData();
     bool newerSate = true;
     bool closerFrame = true;
@@ -1613,9 +1720,12 @@ eTask* BoundingBox::saveSVGWithTransform(SvgExporter& exp,
     const QPointer<const BoundingBox> ptr = this;
     const auto expPtr = &exp;
     const auto parentPtr = &parent;
-    taskPtr->addDependent({[ptr, taskPtr, expPtr, parentPtr, visRange, maskId]() {
+    // siblings may finish in any order, reserve the place in the parent
+    const auto slot = exp.reserveChild(parent);
+    taskPtr->addDependent({[ptr, taskPtr, expPtr, parentPtr, slot, visRange, maskId]() {
         auto& ele = taskPtr->element();
-        if (ptr) {
+        if (!ptr) { parentPtr->removeChild(slot); }
+        else {
             ele.setAttribute("id", AppSupport::filterId(ptr->prp_getName()));
 
             const QString blend = skBlendModeToSVG(ptr->getBlendMode());
@@ -1655,10 +1765,15 @@ eTask* BoundingBox::saveSVGWithTransform(SvgExporter& exp,
                 eleMask.setAttribute("id", QString("%1Mask").arg(AppSupport::filterId(ptr->prp_getName())));
                 eleMask.appendChild(withEffects);
                 expPtr->addToDefs(eleMask);
+                parentPtr->removeChild(slot);
             } else {
-                parentPtr->appendChild(withEffects);
+                parentPtr->replaceChild(withEffects, slot);
             }
         }
+        // the parent holds the element now, the exporter
+        // frees it once it is written
+        ele = QDomElement();
+        expPtr->releaseChild(slot);
     }, nullptr});
     saveSVG(exp, taskPtr);
     taskPtr->queTask();
@@ -37,6 +37,7 @@
 #include "BlendEffects/blendeffect.h"
 #include "TransformEffects/transformeffect.h"
 #include "Tasks/domeletask.h"
+#include "CacheHandlers/renderdatacachecontainer.h"
 
 class Canvas;
 
@@ -396,6 +397,9 @@ public:
     bool diffsIncludingInherited(const int relFrame1, const int relFrame2) const;
     bool diffsIncludingInherited(const qreal relFrame1, const qreal relFrame2) const;
 
+    FrameRange getIdenticalRelRangeIncludingInherited(const int relFrame) const;
+    QVector<uint> inheritedStateIds() const;
+
     bool hasCurrentRenderData(const qreal relFrame) const;
     stdsptr<BoxRenderData> getCurrentRenderData(const qreal relFrame) const;
     BoxRenderData *updateCurrentRenderData(const qreal relFrame);
@@ -457,6 +461,9 @@ public:
 private:
     void cancelWaitingTasks();
     void afterTotalTransformChanged(const UpdateReason reason);
+
+    stdsptr<BoxRenderData> getIdenticalRenderData(const qreal relFrame) const;
+    void updateIdenticalRenderData(BoxRenderData * const renderData);
 signals:
     void globalPivotInfluenced();
     void fillStrokeSettingsChanged();
@@ -489,6 +496,9 @@ private:
                        const Qt::Alignment align,
                        const QRectF& to);
 
+    void addChangedAbsRange(FrameRange range, bool clip);
+    void flushChangedAbsRanges();
+
     void setCustomPropertiesVisible(const bool visible);
     void setBlendEffectsVisible(const bool visible);
     void setTransformEffectsVisible(const bool visible);
@@ -504,6 +514,15 @@ private:
     bool mUpdatePlanned = false;
     UpdateReason mPlannedReason;
 
+    struct ChangedRange {
+        FrameRange fRange;
+        bool fClip;
+    };
+
+    bool mChangedRangePlanned = false;
+    //! @brief Disjoint changed ranges waiting to be passed up the tree
+    QList<ChangedRange> mChangedRanges;
+
     QPointF mSavedTransformPivot;
 
     QRectF mRelRect;
@@ -515,6 +534,13 @@ private:
     QList<Property*> mCanvasProps;
 
     RenderContainer mDrawRenderContainer;
+
+    //! @brief Rendered output reused for every frame of mIdenticalRange
+    //! as long as this box and its ancestors keep their state ids,
+    //! evicted by the memory handler like any other cache
+    stdsptr<RenderDataCacheContainer> mIdenticalRenderData;
+    FrameRange mIdenticalRange;
+    QVector<uint> mIdenticalStateIds;
 };
 
 #include "clipboardcontainer.h"
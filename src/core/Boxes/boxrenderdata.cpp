@@ -26,9 +26,11 @@
 #include "boxrenderdata.h"
 #include "boundingbox.h"
 #include "skia/skiahelpers.h"
+#include "skia/pixelbufferpool.h"
 #include "efiltersettings.h"
 #include "Private/Tasks/taskscheduler.h"
 #include "Private/Tasks/gputaskexecutor.h"
+#include "Tasks/renderprofiler.h"
 
 BoxRenderData::BoxRenderData(BoundingBox * const parent) :
     fFilterQuality(eFilterSettings::sRender()) {
@@ -76,6 +78,21 @@ sk_sp<SkImage> BoxRenderData::requestImageCopy() {
     else return mImageCopies.takeLast();
 }
 
+int BoxRenderData::imageByteCount() const {
+    QList<const void*> counted;
+    int bytes = 0;
+    const auto count = [&](const sk_sp<SkImage>& img) {
+        SkPixmap pixmap;
+        if(!img || !img->peekPixels(&pixmap)) return;
+        if(counted.contains(pixmap.addr())) return;
+        counted << pixmap.addr();
+        bytes += pixmap.width()*pixmap.height()*pixmap.info().bytesPerPixel();
+    };
+    count(fRenderedImage);
+    for(const auto& img : mImageCopies) count(img);
+    return bytes;
+}
+
 void BoxRenderData::drawOnParentLayer(SkCanvas * const canvas) {
     SkPaint paint;
     if(fUseRenderTransform) paint.setFilterQuality(fFilterQuality);
@@ -122,6 +139,7 @@ void BoxRenderData::processGpu(QGL33 * const gl,
                 kRGBA_8888_SkColorType, GrMipMapped::kNo,
                 GrRenderable::kYes);
     if(!grTex.isValid()) return;
+    RenderProfiler::sAddBytes(4ll*fGlobalRect.width()*fGlobalRect.height());
     const auto surf = SkSurface::MakeFromBackendTexture(
                 grContext, grTex, kTopLeft_GrSurfaceOrigin, 0,
                 kRGBA_8888_SkColorType, nullptr, nullptr);
@@ -161,19 +179,22 @@ void BoxRenderData::process()
     const auto info = SkiaHelpers::getPremulRGBAInfo(fGlobalRect.width(),
                                                      fGlobalRect.height());
 
-    mBitmap.allocPixels(info);
-
-    if (mBitmap.getPixels() == nullptr) { return; }
+    if (!PixelBufferPool::sAllocPixels(mBitmap, info)) { return; }
+    RenderProfiler::sAddBytes(qint64(mBitmap.computeByteSize()));
 
     mBitmap.eraseColor(eraseColor());
-    SkCanvas canvas(mBitmap);
-    transformRenderCanvas(canvas);
-
-    drawSk(&canvas);
+    drawBitmap(mBitmap);
 
     fRenderedImage = SkiaHelpers::transferDataToSkImage(mBitmap);
 }
 
+void BoxRenderData::drawBitmap(SkBitmap& bitmap)
+{
+    SkCanvas canvas(bitmap);
+    transformRenderCanvas(canvas);
+    drawSk(&canvas);
+}
+
 void BoxRenderData::beforeProcessing(const Hardware hw) {
     Q_UNUSED(hw)
     Q_ASSERT(mStep != Step::EFFECTS);
@@ -183,8 +204,8 @@ void BoxRenderData::beforeProcessing(const Hardware hw) {
 }
 
 void BoxRenderData::afterProcessing() {
-    if(fMotionBlurTarget) {
-        fMotionBlurTarget->fOtherGlobalRects << fGlobalRect;
+    for(const auto& target : fMotionBlurTargets) {
+        if(target) target->fOtherGlobalRects << fGlobalRect;
     }
     if(fParentBox && fParentIsTarget) {
         fParentBox->renderDataFinished(this);
@@ -194,6 +215,9 @@ void BoxRenderData::afterProcessing() {
 }
 
 void BoxRenderData::afterQued() {
+    if(RenderProfiler::sEnabled() && fParentBox && mProfileLabel.isNull()) {
+        mProfileLabel = fParentBox->prp_getName();
+    }
     if(mDataSet) return;
     if(!mDelayDataSet) dataSet();
 }
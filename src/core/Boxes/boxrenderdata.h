@@ -45,6 +45,7 @@ protected:
     BoxRenderData(BoundingBox * const parent);
 
     virtual void drawSk(SkCanvas * const canvas) = 0;
+    virtual void drawBitmap(SkBitmap& bitmap);
     virtual void updateRelBoundingRect() = 0;
     virtual void setupRenderData() {}
     virtual void transformRenderCanvas(SkCanvas& canvas) const;
@@ -76,12 +77,16 @@ public:
     }
 
     bool nextStep();
+    QString profileLabel() const { return mProfileLabel; }
 
     void processGpu(QGL33 * const gl, SwitchableContext &context);
     void process();
 
     stdsptr<BoxRenderData> makeCopy();
     sk_sp<SkImage> requestImageCopy();
+    //! @brief Raster memory held by the rendered image and its copies,
+    //! pixels shared by several images are counted once
+    int imageByteCount() const;
 
     bool fForceRasterize = false;
 
@@ -107,7 +112,7 @@ public:
     qreal fRelFrame;
 
     // for motion blur
-    stdptr<BoxRenderData> fMotionBlurTarget;
+    QList<stdptr<BoxRenderData>> fMotionBlurTargets;
     // for motion blur
 
     SkBlendMode fBlendMode = SkBlendMode::kSrcOver;
@@ -143,6 +148,7 @@ private:
     EffectsRenderer mEffectsRenderer;
     stdptr<BoxRenderData> mCopySource;
     QList<sk_sp<SkImage>> mImageCopies;
+    QString mProfileLabel;
 };
 
 #endif // BOXRENDERDATA_H
@@ -0,0 +1,181 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "boxspatialindex.h"
+#include "boundingbox.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+// boxes spanning more cells than this are tested on every query
+#define MAX_CELLS_PER_BOX 256
+// margin (in canvas units) absorbing rel/abs mapping round-off
+#define BOUNDS_MARGIN 1.
+
+static bool isRectFinite(const QRectF& rect) {
+    return std::isfinite(rect.x()) && std::isfinite(rect.y()) &&
+           std::isfinite(rect.width()) && std::isfinite(rect.height());
+}
+
+static qint64 cellCount(const QRect& cells) {
+    const qint64 w = qint64(cells.right()) - cells.left() + 1;
+    const qint64 h = qint64(cells.bottom()) - cells.top() + 1;
+    return w*h;
+}
+
+static int toCell(const qreal value, const qreal cellSize) {
+    const qreal cell = qBound(-1e9, value/cellSize, 1e9);
+    return qFloor(cell);
+}
+
+void BoxSpatialIndex::reset(const QList<BoundingBox*>& boxes) {
+    mBoxes = boxes;
+    mRebuild = true;
+}
+
+void BoxSpatialIndex::invalidate(BoundingBox * const box) {
+    if(mRebuild) return;
+    const int id = mBoxToId.value(box, -1);
+    if(id < 0) return;
+    auto& entry = mEntries[id];
+    if(entry.fDirty) return;
+    entry.fDirty = true;
+    mDirty << id;
+}
+
+void BoxSpatialIndex::boxesAt(const QPointF& absPos, QVector<int>& ids) {
+    update();
+    const int x = toCell(absPos.x(), mCellSize);
+    const int y = toCell(absPos.y(), mCellSize);
+    collect(QRect(QPoint(x, y), QPoint(x, y)), ids);
+}
+
+void BoxSpatialIndex::boxesIntersecting(const QRectF& absRect,
+                                        QVector<int>& ids) {
+    update();
+    collect(cellsFor(absRect.normalized()), ids);
+}
+
+QRect BoxSpatialIndex::cellsFor(const QRectF& rect) const {
+    const int x0 = toCell(rect.left() - BOUNDS_MARGIN, mCellSize);
+    const int y0 = toCell(rect.top() - BOUNDS_MARGIN, mCellSize);
+    const int x1 = toCell(rect.right() + BOUNDS_MARGIN, mCellSize);
+    const int y1 = toCell(rect.bottom() + BOUNDS_MARGIN, mCellSize);
+    return QRect(QPoint(x0, y0), QPoint(x1, y1));
+}
+
+void BoxSpatialIndex::insert(const int id) {
+    auto& entry = mEntries[id];
+    entry.fDirty = false;
+    entry.fRect = entry.fBox->getAbsBoundingRect();
+    const bool valid = isRectFinite(entry.fRect) && !entry.fRect.isEmpty();
+    if(valid) {
+        entry.fCells = cellsFor(entry.fRect);
+        entry.fAlways = cellCount(entry.fCells) > MAX_CELLS_PER_BOX;
+    } else entry.fAlways = true;
+
+    if(entry.fAlways) {
+        mAlways << id;
+        return;
+    }
+    const auto& cells = entry.fCells;
+    for(int x = cells.left(); x <= cells.right(); x++) {
+        for(int y = cells.top(); y <= cells.bottom(); y++) {
+            mCells[sCellKey(x, y)] << id;
+        }
+    }
+}
+
+void BoxSpatialIndex::remove(const int id) {
+    const auto& entry = mEntries.at(id);
+    if(entry.fAlways) {
+        mAlways.removeOne(id);
+        return;
+    }
+    const auto& cells = entry.fCells;
+    for(int x = cells.left(); x <= cells.right(); x++) {
+        for(int y = cells.top(); y <= cells.bottom(); y++) {
+            const auto it = mCells.find(sCellKey(x, y));
+            if(it == mCells.end()) continue;
+            it->removeOne(id);
+            if(it->isEmpty()) mCells.erase(it);
+        }
+    }
+}
+
+void BoxSpatialIndex::rebuild() {
+    mRebuild = false;
+    mDirty.clear();
+    mAlways.clear();
+    mCells.clear();
+    mBoxToId.clear();
+    mEntries.clear();
+
+    const int count = mBoxes.count();
+    mEntries.reserve(count);
+    QRectF bounds;
+    for(int i = 0; i < count; i++) {
+        const auto box = mBoxes.at(i);
+        const QRectF rect = box->getAbsBoundingRect();
+        if(isRectFinite(rect) && !rect.isEmpty()) bounds |= rect;
+        mEntries.append({box, rect, QRect(), false, false});
+        mBoxToId.insert(box, i);
+    }
+
+    const int perSide = qBound(1, qCeil(std::sqrt(qreal(count))), 1024);
+    const qreal side = qMax(bounds.width(), bounds.height());
+    mCellSize = qMax(1., side/perSide);
+
+    for(int i = 0; i < count; i++) insert(i);
+}
+
+void BoxSpatialIndex::update() {
+    if(mRebuild || mDirty.count() > mEntries.count()/4) return rebuild();
+    for(const int id : mDirty) {
+        remove(id);
+        insert(id);
+    }
+    mDirty.clear();
+}
+
+void BoxSpatialIndex::collect(const QRect& cells, QVector<int>& ids) const {
+    ids = mAlways;
+    if(cellCount(cells) > mCells.count()) {
+        for(auto it = mCells.begin(); it != mCells.end(); it++) {
+            const quint64 key = it.key();
+            const int x = int(quint32(key >> 32));
+            const int y = int(quint32(key));
+            if(cells.contains(x, y)) ids << it.value();
+        }
+    } else {
+        for(int x = cells.left(); x <= cells.right(); x++) {
+            for(int y = cells.top(); y <= cells.bottom(); y++) {
+                const auto it = mCells.find(sCellKey(x, y));
+                if(it != mCells.end()) ids << it.value();
+            }
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
@@ -0,0 +1,77 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef BOXSPATIALINDEX_H
+#define BOXSPATIALINDEX_H
+
+#include "core_global.h"
+
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QRectF>
+
+class BoundingBox;
+
+// Uniform grid of the absolute bounding rects of the boxes contained
+// in a single ContainerBox. Queries return indices into the contained
+// box list (z-order, topmost first) of boxes whose bounds may contain
+// the point/intersect the rect, callers still do the exact test.
+class CORE_EXPORT BoxSpatialIndex {
+public:
+    void reset(const QList<BoundingBox*>& boxes);
+    void invalidate(BoundingBox * const box);
+
+    void boxesAt(const QPointF& absPos, QVector<int>& ids);
+    void boxesIntersecting(const QRectF& absRect, QVector<int>& ids);
+private:
+    struct Entry {
+        BoundingBox* fBox;
+        QRectF fRect;
+        QRect fCells;
+        bool fAlways;
+        bool fDirty;
+    };
+
+    static quint64 sCellKey(const int x, const int y) {
+        return (quint64(quint32(x)) << 32) | quint32(y);
+    }
+
+    QRect cellsFor(const QRectF& rect) const;
+    void insert(const int id);
+    void remove(const int id);
+    void rebuild();
+    void update();
+    void collect(const QRect& cells, QVector<int>& ids) const;
+
+    bool mRebuild = true;
+    qreal mCellSize = 1;
+    QList<BoundingBox*> mBoxes;
+    QVector<Entry> mEntries;
+    QHash<BoundingBox*, int> mBoxToId;
+    QVector<int> mDirty;
+    QVector<int> mAlways;
+    QHash<quint64, QVector<int>> mCells;
+};
+
+#endif // BOXSPATIALINDEX_H
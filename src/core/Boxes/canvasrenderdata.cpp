@@ -25,6 +25,8 @@
 
 #include "canvasrenderdata.h"
 #include "skia/skiahelpers.h"
+#include "skia/skqtconversions.h"
+#include "simplemath.h"
 
 CanvasRenderData::CanvasRenderData(BoundingBox * const parentBoxT) :
     ContainerBoxRenderData(parentBoxT) {}
@@ -38,6 +40,84 @@ void CanvasRenderData::updateGlobalRect() {
                      qCeil(globalRectF.height()));
     fGlobalRect = QRect(pos, size);
     //setBaseGlobalRect(globalRectF);
+    updateComposite();
+}
+
+void CanvasRenderData::updateComposite() {
+    mBaseImage.reset();
+    fComposite.reset();
+    const auto prev = std::move(fPreviousComposite);
+    if(hasEffects()) return;
+
+    const auto composite = std::make_shared<CanvasComposite>();
+    composite->fRelFrame = qRound(fRelFrame);
+    composite->fResolution = fResolution;
+    composite->fGlobalRect = fGlobalRect;
+    composite->fBgColor = fBgColor;
+    for(const auto& child : fChildrenRenderData) {
+        // clips and clearing blend modes depend on other children
+        if(!child.fClip.fClipOps.isEmpty()) return;
+        CanvasComposite::Child state;
+        if(!child.drawBounds(fResolutionScale, state.fBounds)) return;
+        state.fBox = child->fBlendEffectIdentifier;
+        state.fStateId = child->fBoxStateId;
+        state.fRelFrame = child->fRelFrame;
+        state.fOpacity = child->fOpacity;
+        state.fBlendMode = child->fBlendMode;
+        state.fAntiAlias = child->fAntiAlias;
+        state.fUseRenderTransform = child->fUseRenderTransform;
+        state.fRenderTransform = child->fRenderTransform;
+        composite->fChildren << state;
+    }
+    fComposite = composite;
+
+    if(!prev || !prev->fImage) return;
+    if(prev->fRelFrame != composite->fRelFrame ||
+       !isZero4Dec(prev->fResolution - composite->fResolution) ||
+       prev->fGlobalRect != composite->fGlobalRect ||
+       prev->fBgColor != composite->fBgColor ||
+       prev->fChildren.count() != composite->fChildren.count()) return;
+
+    QRectF dirty;
+    const int count = composite->fChildren.count();
+    for(int i = 0; i < count; i++) {
+        const auto& oldState = prev->fChildren.at(i);
+        const auto& newState = composite->fChildren.at(i);
+        if(oldState.fBox != newState.fBox) return;
+        if(oldState == newState) continue;
+        dirty |= oldState.fBounds;
+        dirty |= newState.fBounds;
+    }
+    const QRect dirtyRect = dirty.toAlignedRect() & fGlobalRect;
+    const qint64 dirtyArea = qint64(dirtyRect.width())*dirtyRect.height();
+    const qint64 area = qint64(fGlobalRect.width())*fGlobalRect.height();
+    if(2*dirtyArea > area) return;
+    mBaseImage = prev->fImage;
+    mDirtyRect = dirtyRect;
+}
+
+void CanvasRenderData::drawSk(SkCanvas * const canvas) {
+    if(!mBaseImage) return ContainerBoxRenderData::drawSk(canvas);
+    SkPaint paint;
+    paint.setBlendMode(SkBlendMode::kSrc);
+    canvas->drawImage(mBaseImage, fGlobalRect.x(), fGlobalRect.y(), &paint);
+    if(mDirtyRect.isEmpty()) return;
+    canvas->save();
+    canvas->clipRect(toSkRect(mDirtyRect));
+    canvas->clear(fBgColor);
+    ContainerBoxRenderData::drawSk(canvas);
+    canvas->restore();
+}
+
+bool CanvasComposite::Child::operator==(const Child& other) const {
+    return fBox == other.fBox && fStateId == other.fStateId &&
+           isZero4Dec(fRelFrame - other.fRelFrame) &&
+           fBounds == other.fBounds &&
+           isZero4Dec(fOpacity - other.fOpacity) &&
+           fBlendMode == other.fBlendMode &&
+           fAntiAlias == other.fAntiAlias &&
+           fUseRenderTransform == other.fUseRenderTransform &&
+           (!fUseRenderTransform || fRenderTransform == other.fRenderTransform);
 }
 
 void CanvasRenderData::updateRelBoundingRect() {
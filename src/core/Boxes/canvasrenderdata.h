@@ -26,6 +26,34 @@
 #ifndef CANVASRENDERDATA_H
 #define CANVASRENDERDATA_H
 #include "layerboxrenderdata.h"
+
+//! @brief Composited scene frame with the state of every drawn child,
+//! used to only redraw the changed region of the same frame
+struct CORE_EXPORT CanvasComposite {
+    struct Child {
+        BoundingBox* fBox;
+        uint fStateId;
+        qreal fRelFrame;
+        QRectF fBounds;
+        qreal fOpacity;
+        SkBlendMode fBlendMode;
+        bool fAntiAlias;
+        bool fUseRenderTransform;
+        QMatrix fRenderTransform;
+
+        bool operator==(const Child& other) const;
+        bool operator!=(const Child& other) const
+        { return !(*this == other); }
+    };
+
+    int fRelFrame;
+    qreal fResolution;
+    QRect fGlobalRect;
+    SkColor fBgColor;
+    QList<Child> fChildren;
+    sk_sp<SkImage> fImage;
+};
+
 struct CORE_EXPORT CanvasRenderData : public ContainerBoxRenderData {
     CanvasRenderData(BoundingBox * const parentBoxT);
 
@@ -33,10 +61,19 @@ struct CORE_EXPORT CanvasRenderData : public ContainerBoxRenderData {
     int fCanvasHeight;
     SkColor fBgColor;
 
+    std::shared_ptr<CanvasComposite> fPreviousComposite;
+    std::shared_ptr<CanvasComposite> fComposite;
+
     SkColor eraseColor() const { return fBgColor; }
 protected:
+    void drawSk(SkCanvas * const canvas);
     void updateGlobalRect();
     void updateRelBoundingRect();
+private:
+    void updateComposite();
+
+    sk_sp<SkImage> mBaseImage;
+    QRect mDirtyRect;
 };
 
 #endif // CANVASRENDERDATA_H
@@ -44,6 +44,8 @@
 #include "ReadWrite/evformat.h"
 #include "internallinkbox.h"
 
+#include <QThread>
+
 class FlipBookProperty : public BoolPropertyContainer {
     e_OBJECT
 
@@ -205,22 +207,35 @@ public:
         }
     }
 
+    // boxes are saved concurrently, each one keeps its place in mEle
     void nextStep() override {
         if (!mSrc) { return cancel(); }
-        if (setValue(mI)) { return; }
+        if (setValue(mFinished)) { return; }
         if (done()) { return; }
 
         const auto& boxes = mSrc->getContainedBoxes();
-        const int id = boxes.count() - ++mI;
-        if (id >= boxes.count()) { return finish(); }
-        const auto& box = boxes.at(id);
-        if (!box->isVisible()) { return nextStep(); }
-        const auto task = box->saveSVGWithTransform(mExp,
-                                                    mEle,
-                                                    mVisRange,
-                                                    mItemMaskId);
-        if (task) { addTask(task->ref<eTask>()); }
-        else { addEmptyTask(); }
+        const int maxRunning = qMax(1, QThread::idealThreadCount());
+        while (mRunning < maxRunning && mI < boxes.count()) {
+            const auto& box = boxes.at(boxes.count() - ++mI);
+            const auto task = box->isVisible() ?
+                        box->saveSVGWithTransform(mExp,
+                                                  mEle,
+                                                  mVisRange,
+                                                  mItemMaskId) : nullptr;
+            if (!task) {
+                mFinished++;
+                continue;
+            }
+            mRunning++;
+            const QPointer<GroupSaverSVG> ptr = this;
+            task->addDependent({[ptr]() {
+                if (!ptr) { return; }
+                ptr->mRunning--;
+                ptr->mFinished++;
+                ptr->nextStep();
+            }, [ptr]() { if (ptr) { ptr->cancel(); } }});
+        }
+        if (mRunning == 0) { setValue(mFinished); }
     }
 private:
     const QPointer<const ContainerBox> mSrc;
@@ -230,6 +245,8 @@ private:
     QString mItemMaskId;
 
     int mI = 0;
+    int mRunning = 0;
+    int mFinished = 0;
 };
 
 void ContainerBox::saveBoxesSVG(SvgExporter& exp,
@@ -667,7 +684,10 @@ bool ContainerBox::relPointInsidePath(const QPointF &relPos) const {
     if(getRelBoundingRect().contains(relPos)) {
         const QPointF absPos = mapRelPosToAbs(relPos);
         const auto minMax = getContainedMinMax();
-        for(int i = minMax.fMin; i <= minMax.fMax; i++) {
+        QVector<int> ids;
+        mSpatialIndex.boxesAt(absPos, ids);
+        for(const int i : ids) {
+            if(i < minMax.fMin || i > minMax.fMax) continue;
             auto& box = mContainedBoxes.at(i);
             if(box->absPointInsidePath(absPos)) {
                 return true;
@@ -706,6 +726,7 @@ void ContainerBox::updateContainedBoxes() {
             mContainedBoxes << box;
         }
     }
+    mSpatialIndex.reset(mContainedBoxes);
 }
 
 bool ContainerBox::isDescendantCurrentGroup() const {
@@ -724,7 +745,10 @@ BoundingBox *ContainerBox::getBoxAtFromAllDescendents(const QPointF &absPos) {
     if(isLink()) return nullptr;
     BoundingBox* boxAtPos = nullptr;
     const auto minMax = getContainedMinMax();
-    for(int i = minMax.fMin; i <= minMax.fMax; i++) {
+    QVector<int> ids;
+    mSpatialIndex.boxesAt(absPos, ids);
+    for(const int i : ids) {
+        if(i < minMax.fMin || i > minMax.fMax) continue;
         const auto& box = mContainedBoxes.at(i);
         if(box->isVisibleAndUnlocked() &&
             box->isVisibleAndInVisibleDurationRect()) {
@@ -1113,7 +1137,10 @@ bool ContainerBox::diffsAffectingContainedBoxes(
 BoundingBox *ContainerBox::getBoxAt(const QPointF &absPos) {
     BoundingBox* boxAtPos = nullptr;
     const auto minMax = getContainedMinMax();
-    for(int i = minMax.fMin; i <= minMax.fMax; i++) {
+    QVector<int> ids;
+    mSpatialIndex.boxesAt(absPos, ids);
+    for(const int i : ids) {
+        if(i < minMax.fMin || i > minMax.fMax) continue;
         const auto& box = mContainedBoxes.at(i);
         if(box->isVisibleAndUnlocked() &&
            box->isVisibleAndInVisibleDurationRect()) {
@@ -1139,7 +1166,10 @@ void ContainerBox::anim_setAbsFrame(const int frame) {
 void ContainerBox::addContainedBoxesToSelection(const QRectF &rect) {
     const auto pScene = getParentScene();
     const auto minMax = getContainedMinMax();
-    for(int i = minMax.fMin; i <= minMax.fMax; i++) {
+    QVector<int> ids;
+    mSpatialIndex.boxesIntersecting(rect, ids);
+    for(const int i : ids) {
+        if(i < minMax.fMin || i > minMax.fMax) continue;
         const auto& box = mContainedBoxes.at(i);
         if(box->isVisibleAndUnlocked() &&
                 box->isVisibleAndInVisibleDurationRect()) {
@@ -26,6 +26,7 @@
 #ifndef CONTAINERBOX_H
 #define CONTAINERBOX_H
 #include "boxwithpatheffects.h"
+#include "boxspatialindex.h"
 #include "conncontextobjlist.h"
 
 class PathBox;
@@ -186,6 +187,8 @@ public:
     bool isCurrentGroup() const;
 
     void updateContainedBoxes();
+    void containedBoundsChanged(BoundingBox * const box)
+    { mSpatialIndex.invalidate(box); }
     bool replaceContained(const qsptr<eBoxOrSound>& replaced,
                              const qsptr<eBoxOrSound>& replacer);
     void addContained(const qsptr<eBoxOrSound> &child);
@@ -293,6 +296,7 @@ private:
     bool mIsDescendantCurrentGroup = false;
     QList<BoundingBox*> mBoxesWithBlendEffects;
     QList<BoundingBox*> mContainedBoxes;
+    mutable BoxSpatialIndex mSpatialIndex;
     QList<qsptr<BlendEffectBoxShadow>> mBlendShadows;
     ConnContextObjList<qsptr<eBoxOrSound>> mContained;
     qsptr<FlipBookProperty> mFlipBook;
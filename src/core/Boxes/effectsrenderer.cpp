@@ -27,6 +27,9 @@
 #include "boxrenderdata.h"
 #include "RasterEffects/rastereffectcaller.h"
 #include "gpurendertools.h"
+#include "Tasks/renderprofiler.h"
+
+#include <typeinfo>
 
 void EffectsRenderer::processGpu(QGL33 * const gl,
                                  SwitchableContext &context,
@@ -43,6 +46,9 @@ void EffectsRenderer::processGpu(QGL33 * const gl,
     while(mCurrentId < mEffects.count()) {
         const auto& effect = mEffects.at(mCurrentId);
         if(effect->hardwareSupport() == HardwareSupport::cpuOnly) break;
+        const RasterEffectCaller& caller = *effect;
+        RenderProfiler::Scope scope("gpu", typeid(caller));
+        if(scope.active()) scope.setBox(boxData->profileLabel());
         effect->processGpu(gl, renderTools);
         mCurrentId++;
     }
@@ -55,7 +61,18 @@ void EffectsRenderer::processCpu(BoxRenderData * const boxData) {
     const auto& effect = mEffects.at(mCurrentId++);
 
     Q_ASSERT(effect->hardwareSupport() != HardwareSupport::gpuOnly);
-    EffectSubTaskSpawner::sSpawn(effect, boxData->ref<BoxRenderData>());
+    QList<stdsptr<RasterEffectCaller>> effects{effect};
+    // a run of point-wise cpu effects shares one pass over the tiles
+    if(effect->pointWise()) {
+        while(mCurrentId < mEffects.count()) {
+            const auto& next = mEffects.at(mCurrentId);
+            if(!next->pointWise() ||
+               next->hardwareSupport() != HardwareSupport::cpuOnly) break;
+            effects << next;
+            mCurrentId++;
+        }
+    }
+    EffectSubTaskSpawner::sSpawn(effects, boxData->ref<BoxRenderData>());
 }
 
 void EffectsRenderer::setBaseGlobalRect(SkIRect &currRect,
@@ -30,20 +30,27 @@
 #include "RasterEffects/rastereffect.h"
 #include "RasterEffects/rastereffectcaller.h"
 #include "Private/Tasks/taskexecutor.h"
+#include "Tasks/renderprofiler.h"
 
 #include <atomic>
+#include <typeinfo>
+
+// rows of a fused tile processed by all the effects before moving on,
+// sized for the strip to stay in cache between the effects
+#define FUSED_STRIP_BYTES (256*1024)
 
 class EffectSubTaskSpawner_priv {
 public:
-    EffectSubTaskSpawner_priv(const stdsptr<RasterEffectCaller>& effect,
+    EffectSubTaskSpawner_priv(const QList<stdsptr<RasterEffectCaller>>& effects,
                               const stdsptr<BoxRenderData>& data) :
-        mUseDst(effect->srcDstSeparation()),
-        mEffectCaller(effect), mData(data) {}
+        mUseDst(effects.first()->srcDstSeparation()),
+        mEffectCallers(effects), mData(data) {}
 
     void initialize();
 private:
     void decRemaining_k();
     void spawn();
+    void process(const CpuRenderData& data);
     void splitSpawn(CpuRenderData& data,
                     const SkIRect& rect,
                     const int nSplits);
@@ -51,7 +58,7 @@ private:
     const bool mUseDst;
     std::atomic<int> mRemaining{0};
 
-    const stdsptr<RasterEffectCaller> mEffectCaller;
+    const QList<stdsptr<RasterEffectCaller>> mEffectCallers;
     const stdsptr<BoxRenderData> mData;
     SkBitmap mSrcBitmap;
     SkBitmap mDstBitmap;
@@ -60,12 +67,17 @@ private:
 };
 
 void EffectSubTaskSpawner_priv::initialize() {
+    RenderProfiler::Scope scope("cpu", "EffectSubTaskSpawner");
+    if(scope.active()) scope.setBox(mData->profileLabel());
     SkPixmap pixmap;
     const auto& srcImg = mData->fRenderedImage;
     mSrcRasterImg = srcImg->makeRasterImage();
     mSrcRasterImg->peekPixels(&pixmap);
     mSrcBitmap.installPixels(pixmap);
-    if(mUseDst) mDstBitmap.allocPixels(mSrcBitmap.info());
+    if(mUseDst) {
+        mDstBitmap.allocPixels(mSrcBitmap.info());
+        RenderProfiler::sAddBytes(qint64(mDstBitmap.computeByteSize()));
+    }
     spawn();
 }
 
@@ -77,16 +89,7 @@ void EffectSubTaskSpawner_priv::splitSpawn(CpuRenderData& data,
         data.fTexTile = rect;
         const auto decRemaining = [this]() { decRemaining_k(); };
         const auto subTask = enve::make_shared<eCustomCpuTask>(nullptr,
-            [this, data]() {
-                SkBitmap dstBitmap;
-                if(mUseDst) {
-                    mDstBitmap.extractSubset(&dstBitmap, data.fTexTile);
-                } else {
-                    mSrcBitmap.extractSubset(&dstBitmap, data.fTexTile);
-                }
-                CpuRenderTools tools{mSrcBitmap, dstBitmap};
-                mEffectCaller->processCpu(tools, data);
-            }, decRemaining, decRemaining);
+            [this, data]() { process(data); }, decRemaining, decRemaining);
         CpuTaskExecutor::sAddTask(subTask);
         return;
     }
@@ -117,12 +120,42 @@ void EffectSubTaskSpawner_priv::splitSpawn(CpuRenderData& data,
     }
 }
 
+void EffectSubTaskSpawner_priv::process(const CpuRenderData& data) {
+    const auto& tile = data.fTexTile;
+    const int stripRows = mEffectCallers.count() == 1 ? tile.height() :
+            qMax(1, FUSED_STRIP_BYTES/qMax(1, 4*tile.width()));
+    CpuRenderData stripData = data;
+    for(int top = tile.top(); top < tile.bottom(); top += stripRows) {
+        stripData.fTexTile = SkIRect::MakeLTRB(tile.left(), top, tile.right(),
+                                               qMin(top + stripRows,
+                                                    tile.bottom()));
+        SkBitmap dstBitmap;
+        if(mUseDst) {
+            mDstBitmap.extractSubset(&dstBitmap, stripData.fTexTile);
+        } else {
+            mSrcBitmap.extractSubset(&dstBitmap, stripData.fTexTile);
+        }
+        // point-wise effects after the first one work in place
+        for(int i = 0; i < mEffectCallers.count(); i++) {
+            const bool inPlace = i > 0 && mUseDst;
+            CpuRenderTools tools{inPlace ? mDstBitmap : mSrcBitmap, dstBitmap};
+            const RasterEffectCaller& caller = *mEffectCallers.at(i);
+            RenderProfiler::Scope scope("cpu", typeid(caller));
+            if(scope.active()) scope.setBox(mData->profileLabel());
+            mEffectCallers.at(i)->processCpu(tools, stripData);
+        }
+    }
+}
+
 void EffectSubTaskSpawner_priv::spawn() {
     const int width = mSrcBitmap.width();
     const int height = mSrcBitmap.height();
     const int area = width*height;
     const int nAllThreads = QThread::idealThreadCount();
-    const int nThreads = qMax(1, mEffectCaller->cpuThreads(nAllThreads, area));
+    int nThreads = 1;
+    for(const auto& effect : mEffectCallers) {
+        nThreads = qMax(nThreads, effect->cpuThreads(nAllThreads, area));
+    }
     mRemaining = nThreads;
 
     auto& srcImage = mData->fRenderedImage;
@@ -155,8 +188,8 @@ void EffectSubTaskSpawner_priv::decRemaining_k() {
 }
 
 
-void EffectSubTaskSpawner::sSpawn(const stdsptr<RasterEffectCaller> &effect,
+void EffectSubTaskSpawner::sSpawn(const QList<stdsptr<RasterEffectCaller>> &effects,
                                   const stdsptr<BoxRenderData> &data) {
-    const auto spawner = new EffectSubTaskSpawner_priv(effect, data);
+    const auto spawner = new EffectSubTaskSpawner_priv(effects, data);
     spawner->initialize();
 }
@@ -27,12 +27,16 @@
 #define EFFECTSUBTASKSPAWNER_H
 #include "smartPointers/ememory.h"
 
+#include <QList>
+
 struct BoxRenderData;
 class RasterEffectCaller;
 
 namespace EffectSubTaskSpawner {
+    //! @brief Runs the effects one after another on every tile,
+    //! effects past the first one have to be point-wise
     CORE_EXPORT
-    void sSpawn(const stdsptr<RasterEffectCaller>& effect,
+    void sSpawn(const QList<stdsptr<RasterEffectCaller>>& effects,
                 const stdsptr<BoxRenderData>& data);
 };
 
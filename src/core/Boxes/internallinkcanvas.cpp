@@ -27,6 +27,7 @@
 #include "linkcanvasrenderdata.h"
 #include "Animators/transformanimator.h"
 #include "canvas.h"
+#include "simplemath.h"
 
 InternalLinkCanvas::InternalLinkCanvas(ContainerBox * const linkTarget,
                                        const bool innerLink) :
@@ -68,19 +69,17 @@ void InternalLinkCanvas::setupRenderData(const qreal relFrame,
                                          BoxRenderData * const data,
                                          Canvas* const scene) {
     if (!scene) { return; }
-    {
-        BoundingBox::setupRenderData(relFrame, parentM, data, scene);
-        const qreal remapped = mFrameRemapping->frame(relFrame);
-        const auto thisM = getTotalTransformAtFrame(relFrame);
-        processChildrenData(remapped, thisM, data, scene);
-    }
+    BoundingBox::setupRenderData(relFrame, parentM, data, scene);
+    const qreal remapped = mFrameRemapping->frame(relFrame);
 
     ContainerBox* finalTarget = getFinalTarget();
     auto canvasData = static_cast<LinkCanvasRenderData*>(data);
     const auto canvasTarget = static_cast<Canvas*>(finalTarget);
-    if (!canvasTarget) { return; }
+    if (!canvasTarget || !canvasTarget->getBgColorAnimator()) {
+        const auto thisM = getTotalTransformAtFrame(relFrame);
+        return processChildrenData(remapped, thisM, data, scene);
+    }
 
-    if (!canvasTarget->getBgColorAnimator()) { return; }
     canvasData->fBgColor = toSkColor(canvasTarget->getBgColorAnimator()->
             getColor(relFrame));
     //qreal res = mParentScene->getResolution();
@@ -92,6 +91,34 @@ void InternalLinkCanvas::setupRenderData(const qreal relFrame,
     } else {
         canvasData->fClipToCanvas = mClipToCanvas->getValue();
     }
+
+    if (!setupSceneFrame(remapped, canvasTarget, canvasData)) {
+        const auto thisM = getTotalTransformAtFrame(relFrame);
+        processChildrenData(remapped, thisM, data, scene);
+    }
+}
+
+bool InternalLinkCanvas::setupSceneFrame(const qreal frame,
+                                         Canvas * const target,
+                                         LinkCanvasRenderData * const data) {
+    // scene frames only cover the canvas and are whole frames
+    if (!data->fClipToCanvas || !isInteger4Dec(frame)) { return false; }
+    // do not upscale the scene frame
+    const auto& m = data->fTotalTransform;
+    const qreal sx = qSqrt(m.m11()*m.m11() + m.m12()*m.m12());
+    const qreal sy = qSqrt(m.m21()*m.m21() + m.m22()*m.m22());
+    if (sx > 1.0001 || sy > 1.0001) { return false; }
+
+    const int relFrame = target->prp_absFrameToRelFrame(qRound(frame));
+    stdsptr<BoxRenderData> pending;
+    data->fSceneFrame = target->linkSceneFrame(relFrame, data->fResolution,
+                                               pending);
+    if (data->fSceneFrame) { return true; }
+    if (!pending) { return false; }
+    // every link showing this frame waits for the same render
+    pending->addDependent(data);
+    data->fSceneFrameData = pending;
+    return true;
 }
 
 bool InternalLinkCanvas::clipToCanvas() {
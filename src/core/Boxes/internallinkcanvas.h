@@ -29,6 +29,8 @@
 #include "Properties/boolproperty.h"
 #include "Boxes/frameremapping.h"
 
+struct LinkCanvasRenderData;
+
 class CORE_EXPORT InternalLinkCanvas : public InternalLinkGroupBox {
     e_OBJECT
 protected:
@@ -55,6 +57,10 @@ public:
     BoundingBox* getLinkTarget();
 
 private:
+    bool setupSceneFrame(const qreal frame,
+                         Canvas * const target,
+                         LinkCanvasRenderData * const data);
+
     qsptr<BoolProperty> mClipToCanvas =
             enve::make_shared<BoolProperty>("clip");
     qsptr<QrealFrameRemapping> mFrameRemapping =
@@ -25,6 +25,41 @@
 
 #include "layerboxrenderdata.h"
 #include "skia/skqtconversions.h"
+#include "Tasks/paralleljobs.h"
+#include "Private/esettings.h"
+
+#include <QThread>
+
+// layers smaller than this or with fewer children are drawn serially
+#define TILED_MIN_CHILDREN 16
+#define TILED_MIN_AREA 512*512
+#define TILE_SIZE 256
+
+bool ChildRenderData::drawBounds(const QMatrix& resolutionScale,
+                                 QRectF& bounds) const {
+    const auto blendMode = fData->fBlendMode;
+    if(blendMode == SkBlendMode::kDstIn ||
+       blendMode == SkBlendMode::kSrcIn ||
+       blendMode == SkBlendMode::kDstATop ||
+       blendMode == SkBlendMode::kModulate ||
+       blendMode == SkBlendMode::kSrcOut) return false;
+    const auto& img = fData->fRenderedImage;
+    if(!img) {
+        bounds = QRectF();
+        return true;
+    }
+    bounds = QRectF(fData->fGlobalRect.topLeft(),
+                    QSizeF(img->width(), img->height()));
+    if(fData->fUseRenderTransform) {
+        bounds = fData->fRenderTransform.mapRect(bounds);
+    }
+    for(const auto& op : fClip.fClipOps) {
+        if(op.fClipPathOp != SkClipOp::kIntersect) continue;
+        const auto clipBounds = toQRectF(op.fClipPath.getBounds());
+        bounds &= resolutionScale.mapRect(clipBounds);
+    }
+    return true;
+}
 
 ContainerBoxRenderData::ContainerBoxRenderData(BoundingBox * const parentBox) :
     BoxRenderData(parentBox) {
@@ -75,6 +110,11 @@ void ContainerBoxRenderData::updateRelBoundingRect() {
 
 void ContainerBoxRenderData::drawSk(SkCanvas * const canvas) {
     for(const auto &child : fChildrenRenderData) {
+        QRectF bounds;
+        if(child.drawBounds(fResolutionScale, bounds)) {
+            if(bounds.isEmpty()) continue;
+            if(canvas->quickReject(toSkRect(bounds))) continue;
+        }
         canvas->save();
         if(!child.fClip.fClipOps.isEmpty()) {
             const SkMatrix transform = canvas->getTotalMatrix();
@@ -86,3 +126,39 @@ void ContainerBoxRenderData::drawSk(SkCanvas * const canvas) {
         canvas->restore();
     }
 }
+
+void ContainerBoxRenderData::drawBitmap(SkBitmap& bitmap) {
+    const int width = bitmap.width();
+    const int height = bitmap.height();
+    const int nThreads = qMin(QThread::idealThreadCount(),
+                              eSettings::sCpuThreadsCapped());
+    const bool tiled = nThreads > 1 &&
+                       fChildrenRenderData.count() >= TILED_MIN_CHILDREN &&
+                       width*height >= TILED_MIN_AREA;
+    if(!tiled) return BoxRenderData::drawBitmap(bitmap);
+    for(const auto &child : fChildrenRenderData) {
+        const auto& img = child->fRenderedImage;
+        if(img && img->isTextureBacked()) {
+            return BoxRenderData::drawBitmap(bitmap);
+        }
+    }
+
+    QList<SkIRect> tileRects;
+    for(int y = 0; y < height; y += TILE_SIZE) {
+        for(int x = 0; x < width; x += TILE_SIZE) {
+            tileRects << SkIRect::MakeXYWH(x, y, qMin(TILE_SIZE, width - x),
+                                           qMin(TILE_SIZE, height - y));
+        }
+    }
+    // each tile draws only the children intersecting it
+    ParallelJobs::sRun(tileRects.count(), nThreads,
+                       [this, &bitmap, &tileRects](const int id) {
+        const auto& tile = tileRects.at(id);
+        SkBitmap tileBitmap;
+        bitmap.extractSubset(&tileBitmap, tile);
+        SkCanvas canvas(tileBitmap);
+        canvas.translate(-tile.x(), -tile.y());
+        transformRenderCanvas(canvas);
+        drawSk(&canvas);
+    });
+}
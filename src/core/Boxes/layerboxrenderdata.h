@@ -56,6 +56,10 @@ struct CORE_EXPORT ChildRenderData {
     inline BoxRenderData* operator->() const
     { return fData.operator->(); }
 
+    //! @brief Bounds (in parent layer coordinates) this child draws to,
+    //! returns false if drawing it can affect the whole parent layer
+    bool drawBounds(const QMatrix& resolutionScale, QRectF& bounds) const;
+
     stdsptr<BoxRenderData> fData;
     bool fIsMain = false;
     PathClip fClip;
@@ -69,6 +73,7 @@ public:
     QList<ChildRenderData> fChildrenRenderData;
 protected:
     void drawSk(SkCanvas * const canvas);
+    void drawBitmap(SkBitmap& bitmap);
     void transformRenderCanvas(SkCanvas& canvas) const final;
     void updateRelBoundingRect();
 };
@@ -28,6 +28,15 @@
 #include "skia/skqtconversions.h"
 
 void LinkCanvasRenderData::drawSk(SkCanvas * const canvas) {
+    if(fSceneFrameData) {
+        // a raster canvas can not draw a texture backed frame
+        const auto& img = fSceneFrameData->fRenderedImage;
+        if(img && (!img->isTextureBacked() || canvas->getGrContext())) {
+            return drawSceneFrame(canvas, img);
+        }
+    } else if(fSceneFrame) {
+        return drawSceneFrame(canvas, fSceneFrame);
+    }
     ContainerBoxRenderData::drawSk(canvas);
     if(fClipToCanvas) {
         canvas->save();
@@ -37,3 +46,18 @@ void LinkCanvasRenderData::drawSk(SkCanvas * const canvas) {
         canvas->restore();
     }
 }
+
+void LinkCanvasRenderData::drawSceneFrame(SkCanvas * const canvas,
+                                          const sk_sp<SkImage>& frame) {
+    if(!frame) return;
+    canvas->save();
+    canvas->concat(toSkMatrix(fScaledTransform));
+    canvas->clipRect(toSkRect(fRelBoundingRect), SkClipOp::kIntersect, true);
+    // scene frames are in scene pixels at fResolution
+    const float invRes = toSkScalar(1/fResolution);
+    canvas->scale(invRes, invRes);
+    SkPaint paint;
+    paint.setFilterQuality(fFilterQuality);
+    canvas->drawImage(frame, 0, 0, &paint);
+    canvas->restore();
+}
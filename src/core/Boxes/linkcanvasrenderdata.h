@@ -31,6 +31,10 @@ struct CORE_EXPORT LinkCanvasRenderData : public CanvasRenderData {
         CanvasRenderData(parentBoxT) {}
 
     bool fClipToCanvas = false;
+    //! @brief Cached frame of the linked scene, drawn instead of children
+    sk_sp<SkImage> fSceneFrame;
+    //! @brief Pending render of the linked scene frame
+    stdsptr<BoxRenderData> fSceneFrameData;
 protected:
     SkColor eraseColor() const {
         if(fClipToCanvas) return fBgColor;
@@ -38,6 +42,7 @@ protected:
     }
 
     void drawSk(SkCanvas * const canvas);
+    void drawSceneFrame(SkCanvas * const canvas, const sk_sp<SkImage>& frame);
 
     void updateRelBoundingRect() {
         if(fClipToCanvas) CanvasRenderData::updateRelBoundingRect();
@@ -356,6 +356,10 @@ bool PathBox::differenceInOutlinePathBetweenFrames(const int frame1, const int f
 
 void PathBox::setPathsOutdated(const UpdateReason reason) {
     mCurrentPathsOutdated = true;
+    if(reason == UpdateReason::userChange) {
+        QMutexLocker lock(&mArcLengthTablesMutex);
+        mArcLengthTables.clear();
+    }
     planUpdate(reason);
 }
 
@@ -428,6 +432,26 @@ SkPath PathBox::getAbsolutePath() const {
 
 const SkPath &PathBox::getRelativePath() const { return mPathSk; }
 
+// frames kept in the arc-length table cache
+#define MAX_ARC_LENGTH_TABLES 64
+
+stdsptr<const ArcLengthTable> PathBox::getRelativeArcLengthTable(
+        const qreal relFrame) {
+    {
+        QMutexLocker lock(&mArcLengthTablesMutex);
+        const auto it = mArcLengthTables.find(relFrame);
+        if(it != mArcLengthTables.end()) return it.value();
+    }
+    const auto qPath = toQPainterPath(getRelativePath(relFrame));
+    const auto table = std::make_shared<const ArcLengthTable>(qPath);
+    QMutexLocker lock(&mArcLengthTablesMutex);
+    if(mArcLengthTables.count() >= MAX_ARC_LENGTH_TABLES) {
+        mArcLengthTables.clear();
+    }
+    mArcLengthTables.insert(relFrame, table);
+    return table;
+}
+
 void PathBox::updateCurrentPreviewDataFromRenderData(
         BoxRenderData* renderData) {
     const auto pathRenderData = enve_cast<PathBoxRenderData*>(renderData);
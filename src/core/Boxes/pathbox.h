@@ -34,6 +34,10 @@
 #include "pathboxrenderdata.h"
 //#include "libmypaintincludes.h"
 #include "Animators/qcubicsegment1danimator.h"
+#include "Segments/arclengthtable.h"
+
+#include <QMutex>
+
 class SmartVectorPath;
 class GradientPoints;
 class SkStroke;
@@ -100,6 +104,9 @@ public:
     SkPath getAbsolutePath(const qreal relFrame) const;
     SkPath getAbsolutePath() const;
     const SkPath &getRelativePath() const;
+    //! @brief Arc-length table of getRelativePath(relFrame),
+    //! cached until the next user change of the path
+    stdsptr<const ArcLengthTable> getRelativeArcLengthTable(const qreal relFrame);
     void setOutlineAffectedByScale(const bool bT);
 
     void copyDataToOperationResult(PathBox * const targetBox) const;
@@ -133,6 +140,9 @@ protected:
     SkPath mOutlineBasePathSk;
     SkPath mOutlinePathSk;
 
+    QMutex mArcLengthTablesMutex;
+    QMap<qreal, stdsptr<const ArcLengthTable>> mArcLengthTables;
+
     GradientPoints* mFillGradientPoints = nullptr;
     GradientPoints* mStrokeGradientPoints = nullptr;
 
@@ -24,6 +24,7 @@
 // Fork of enve - Copyright (C) 2016-2020 Maurycy Liebner
 
 #include "tmploader.h"
+#include "Tasks/metricsregistry.h"
 
 TmpLoader::TmpLoader(const qsptr<QTemporaryFile> &file,
                      HddCachableCont * const target) :
@@ -34,6 +35,10 @@ void TmpLoader::process() {
     if(mTmpFile->open()) {
         eReadStream src(mTmpFile.get());
         read(src);
+        static auto& reloads = MetricsRegistry::sCounter("hdd.reloads");
+        static auto& reloadBytes = MetricsRegistry::sCounter("hdd.reload_bytes");
+        reloads.add();
+        reloadBytes.add(mTmpFile->size());
         mTmpFile->close();
     } else {
         RuntimeThrow("Could not open temporary file for reading.");
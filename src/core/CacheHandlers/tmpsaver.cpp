@@ -24,6 +24,7 @@
 // Fork of enve - Copyright (C) 2016-2020 Maurycy Liebner
 
 #include "tmpsaver.h"
+#include "Tasks/metricsregistry.h"
 
 TmpSaver::TmpSaver(HddCachableCont* const target) :
     mTarget(target) {}
@@ -33,6 +34,10 @@ void TmpSaver::process() {
     if(mTmpFile->open()) {
         eWriteStream dst(mTmpFile.get());
         write(dst);
+        static auto& spills = MetricsRegistry::sCounter("hdd.spills");
+        static auto& spillBytes = MetricsRegistry::sCounter("hdd.spill_bytes");
+        spills.add();
+        spillBytes.add(mTmpFile->size());
         mTmpFile->close();
         mSavingSuccessful = true;
     } else {
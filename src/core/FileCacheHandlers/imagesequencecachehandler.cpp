@@ -26,6 +26,7 @@
 #include "imagesequencecachehandler.h"
 
 #include "appsupport.h"
+#include "Tasks/metricsregistry.h"
 #include "filesourcescache.h"
 #include "fileshandler.h"
 
@@ -49,7 +50,13 @@ ImageCacheContainer *ImageSequenceFileHandler::getFrameAtOrBeforeFrame(
 eTask *ImageSequenceFileHandler::scheduleFrameLoad(const int frame) {
     if(mFrameImageHandlers.isEmpty()) return nullptr;
     const auto& imageHandler = mFrameImageHandlers.at(frame);
-    if(imageHandler->hasImage()) return nullptr;
+    static auto& hits = MetricsRegistry::sCounter("cache.image_sequence.hits");
+    static auto& misses = MetricsRegistry::sCounter("cache.image_sequence.misses");
+    if(imageHandler->hasImage()) {
+        hits.add();
+        return nullptr;
+    }
+    misses.add();
     return imageHandler->scheduleLoad();
 }
 
@@ -29,6 +29,7 @@
 #include "CacheHandlers/imagecachecontainer.h"
 
 #include "appsupport.h"
+#include "Tasks/metricsregistry.h"
 #include "filesourcescache.h"
 
 #include "videoframeloader.h"
@@ -145,7 +146,12 @@ eTask* VideoFrameHandler::scheduleFrameLoad(const int frame) {
         RuntimeThrow("Frame outside of range " + std::to_string(frame));
     const auto currLoader = getFrameLoader(frame);
     if(currLoader) return currLoader;
-    if(mDataHandler->getFrameAtFrame(frame)) return nullptr;
+    static auto& hits = MetricsRegistry::sCounter("cache.video_frames.hits");
+    static auto& misses = MetricsRegistry::sCounter("cache.video_frames.misses");
+    const auto cont = mDataHandler->getFrameAtFrame(frame);
+    if(cont && cont->storesDataInMemory()) hits.add();
+    else misses.add();
+    if(cont) return nullptr;
     const auto loadTask = mDataHandler->scheduleFrameHddCacheLoad(frame);
     if(loadTask) return loadTask;
     const auto loader = addFrameLoader(frame);
@@ -27,6 +27,10 @@
 #include "videocachehandler.h"
 #include "Private/Tasks/taskscheduler.h"
 #include "Private/Tasks/taskexecutor.h"
+#include "skia/pixelkernels.h"
+#include "skia/pixelbufferpool.h"
+
+#include <cstring>
 
 VideoFrameLoader::VideoFrameLoader(VideoFrameHandler * const cacheHandler,
                                    const stdsptr<VideoStreamsData> &openedVideo,
@@ -53,20 +57,48 @@ void VideoFrameLoader::convertFrame() {
     const auto info = SkiaHelpers::getPremulRGBAInfo(
                 mFrameToConvert->width, mFrameToConvert->height);
     SkBitmap bitmap;
-    bitmap.allocPixels(info);
+    if(!PixelBufferPool::sAllocPixels(bitmap, info)) {
+        RuntimeThrow("Could not allocate video frame pixels");
+    }
 
     SkPixmap pixmap;
     bitmap.peekPixels(&pixmap);
 
-    void * const addr = pixmap.writable_addr();
-    uint8_t * const dstSk[] = { static_cast<uint8_t*>(addr) };
-    int linesizesSk[4];
+    const int width = mFrameToConvert->width;
+    const int height = mFrameToConvert->height;
+    const auto format = static_cast<AVPixelFormat>(mFrameToConvert->format);
+    if(format == AV_PIX_FMT_RGBA || format == AV_PIX_FMT_BGRA) {
+        // already packed 8 bit, no need for swscale
+        for(int y = 0; y < height; y++) {
+            const auto src = mFrameToConvert->data[0] +
+                             y*mFrameToConvert->linesize[0];
+            const auto dst = static_cast<uint8_t*>(pixmap.writable_addr(0, y));
+            if(format == AV_PIX_FMT_BGRA) {
+                PixelKernels::swapRedBlue(src, dst, width);
+            } else {
+                std::memcpy(dst, src, static_cast<size_t>(width)*4);
+            }
+        }
+    } else {
+        void * const addr = pixmap.writable_addr();
+        uint8_t * const dstSk[] = { static_cast<uint8_t*>(addr) };
+        int linesizesSk[4];
+
+        av_image_fill_linesizes(linesizesSk, AV_PIX_FMT_RGBA, width);
+        linesizesSk[0] = static_cast<int>(pixmap.rowBytes());
 
-    av_image_fill_linesizes(linesizesSk, AV_PIX_FMT_RGBA,
-                            mFrameToConvert->width);
+        sws_scale(mSwsContext, mFrameToConvert->data, mFrameToConvert->linesize,
+                  0, height, dstSk, linesizesSk);
+    }
 
-    sws_scale(mSwsContext, mFrameToConvert->data, mFrameToConvert->linesize,
-              0, mFrameToConvert->height, dstSk, linesizesSk);
+    // decoded video is straight alpha, skia images are premultiplied
+    const AVPixFmtDescriptor * const desc = av_pix_fmt_desc_get(format);
+    if(desc && (desc->flags & AV_PIX_FMT_FLAG_ALPHA)) {
+        for(int y = 0; y < height; y++) {
+            const auto row = static_cast<uint8_t*>(pixmap.writable_addr(0, y));
+            PixelKernels::premultiply(row, row, width);
+        }
+    }
 
     mLoadedFrame = SkiaHelpers::transferDataToSkImage(bitmap);
 
@@ -40,18 +40,17 @@ public:
     LinesEffectCaller(const qreal angle, const qreal dist) :
         mAngle(angle), mDist(dist) {}
 
-    void apply(SkPath& path);
+    void applyTo(PathEffectPath& effectPath);
 private:
     const qreal mAngle;
     const qreal mDist;
 };
 
-void LinesEffectCaller::apply(SkPath &path) {
-    auto segLists = CubicList::sMakeFromSkPath(path);
-    const QRectF pathBounds = toQRectF(path.getBounds());
-    const auto srcFillType = path.getFillType();
-    path.reset();
-    path.setFillType(srcFillType);
+void LinesEffectCaller::applyTo(PathEffectPath &effectPath) {
+    const auto& segLists = effectPath.segments();
+    const QRectF pathBounds = toQRectF(effectPath.bounds());
+    SkPath path;
+    path.setFillType(effectPath.fillType());
     QTransform rotate;
     const QPointF pivot = pathBounds.center();
     rotate.translate(pivot.x(), pivot.y());
@@ -85,6 +84,7 @@ void LinesEffectCaller::apply(SkPath &path) {
             path.lineTo(toSkPoint(line.p2()));
         }
     }
+    effectPath = path;
 }
 
 stdsptr<PathEffectCaller> LinesPathEffect::getEffectCaller(
@@ -4,3 +4,13 @@ PathEffectCaller::PathEffectCaller()
 {
 
 }
+
+void PathEffectCaller::apply(SkPath& path) {
+    PathEffectPath effectPath(path);
+    applyTo(effectPath);
+    path = effectPath.skPath();
+}
+
+void PathEffectCaller::applyTo(PathEffectPath& path) {
+    apply(path.editSkPath());
+}
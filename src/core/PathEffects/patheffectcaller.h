@@ -3,12 +3,18 @@
 
 #include "../skia/skiaincludes.h"
 #include "../smartPointers/stdselfref.h"
+#include "../smartPointers/ememorypool.h"
+#include "patheffectpath.h"
 
 class CORE_EXPORT PathEffectCaller : public StdSelfRef {
+    e_OBJECT
+    e_POOLED_ALLOCATOR(eMemoryPool::sEffectCallers())
 public:
     PathEffectCaller();
 
-    virtual void apply(SkPath& path) = 0;
+    // override at least one of the two
+    virtual void apply(SkPath& path);
+    virtual void applyTo(PathEffectPath& path);
 };
 
 #endif // PATHEFFECTCALLER_H
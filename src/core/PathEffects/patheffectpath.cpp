@@ -0,0 +1,119 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "patheffectpath.h"
+#include "skia/skqtconversions.h"
+
+PathEffectPath::PathEffectPath(const SkPath& path) :
+    mFillType(path.getFillType()), mPath(path) {}
+
+PathEffectPath& PathEffectPath::operator=(const SkPath& path) {
+    mPath = path;
+    mFillType = path.getFillType();
+    mPathValid = true;
+    mSegmentsValid = false;
+    mSegments.clear();
+    return *this;
+}
+
+const SkPath& PathEffectPath::skPath() {
+    updatePath();
+    return mPath;
+}
+
+SkPath& PathEffectPath::editSkPath() {
+    updatePath();
+    mSegmentsValid = false;
+    mSegments.clear();
+    return mPath;
+}
+
+const QList<CubicList>& PathEffectPath::segments() {
+    updateSegments();
+    return mSegments;
+}
+
+void PathEffectPath::setSegments(const QList<CubicList> segments) {
+    mFillType = fillType();
+    mSegments.clear();
+    for(const auto& list : segments) {
+        QList<qCubicSegment2D> segs;
+        QPointF lastPos;
+        for(const auto& seg : list) {
+            if(!segs.isEmpty() && pointToLen(seg.p0() - lastPos) > 0.1) {
+                mSegments << CubicList(segs);
+                segs.clear();
+            }
+            segs << seg;
+            lastPos = seg.p3();
+        }
+        if(!segs.isEmpty()) mSegments << CubicList(segs);
+    }
+    mSegmentsValid = true;
+    mPathValid = false;
+    mPath.reset();
+}
+
+void PathEffectPath::prepareForSharing() {
+    if(mPathValid) mPath.getBounds();
+    if(mSegmentsValid) {
+        for(const auto& list : mSegments) list.getTotalLength();
+    }
+}
+
+SkPathFillType PathEffectPath::fillType() const {
+    return mPathValid ? mPath.getFillType() : mFillType;
+}
+
+SkRect PathEffectPath::bounds() {
+    if(mPathValid) return mPath.getBounds();
+    SkRect result = SkRect::MakeEmpty();
+    bool first = true;
+    for(const auto& list : mSegments) {
+        for(const auto& seg : list) {
+            const SkPoint pts[4] = {toSkPoint(seg.p0()), toSkPoint(seg.c1()),
+                                    toSkPoint(seg.c2()), toSkPoint(seg.p3())};
+            SkRect segBounds;
+            segBounds.setBounds(pts, 4);
+            if(first) result = segBounds;
+            else result.join(segBounds);
+            first = false;
+        }
+    }
+    return result;
+}
+
+void PathEffectPath::updatePath() {
+    if(mPathValid) return;
+    mPath.reset();
+    mPath.setFillType(mFillType);
+    for(const auto& list : mSegments) mPath.addPath(list.toSkPath());
+    mPathValid = true;
+}
+
+void PathEffectPath::updateSegments() {
+    if(mSegmentsValid) return;
+    mFillType = mPath.getFillType();
+    mSegments = CubicList::sMakeFromSkPath(mPath);
+    mSegmentsValid = true;
+}
@@ -0,0 +1,66 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef PATHEFFECTPATH_H
+#define PATHEFFECTPATH_H
+
+#include "../skia/skiaincludes.h"
+#include "../Segments/cubiclist.h"
+
+// Path handed along a chain of path effects. Keeps the representation
+// produced by the last effect and converts between SkPath and CubicList
+// segments only when the next effect needs the other one, so stacked
+// segment based effects share a single conversion.
+class CORE_EXPORT PathEffectPath {
+public:
+    PathEffectPath(const SkPath& path = SkPath());
+
+    PathEffectPath& operator=(const SkPath& path);
+
+    const SkPath& skPath();
+    //! @brief Modifications invalidate the segments
+    SkPath& editSkPath();
+
+    const QList<CubicList>& segments();
+    //! @brief Splits lists at gaps the same way SkPath conversion does
+    void setSegments(const QList<CubicList> segments);
+
+    //! @brief Fills the lazily computed bounds and lengths,
+    //! afterwards copies can be used from several threads
+    void prepareForSharing();
+
+    SkPathFillType fillType() const;
+    //! @brief Control point bounds, as SkPath::getBounds
+    SkRect bounds();
+private:
+    void updatePath();
+    void updateSegments();
+
+    bool mPathValid = true;
+    bool mSegmentsValid = false;
+    SkPathFillType mFillType;
+    SkPath mPath;
+    QList<CubicList> mSegments;
+};
+
+#endif // PATHEFFECTPATH_H
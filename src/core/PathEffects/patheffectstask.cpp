@@ -24,6 +24,14 @@
 // Fork of enve - Copyright (C) 2016-2020 Maurycy Liebner
 
 #include "patheffectstask.h"
+#include "Tasks/paralleljobs.h"
+#include "Tasks/renderprofiler.h"
+
+#include <QThread>
+#include <typeinfo>
+
+// paths with fewer points run fill and outline chains serially
+#define PARALLEL_MIN_POINTS 512
 
 PathEffectsTask::PathEffectsTask(PathBoxRenderData * const target,
                                  EffectsList&& pathEffects,
@@ -39,33 +47,65 @@ PathEffectsTask::PathEffectsTask(PathBoxRenderData * const target,
 
     mPath(target->fPath), mFillPath(target->fFillPath),
     mOutlineBasePath(target->fOutlineBasePath),
-    mOutlinePath(target->fOutlinePath) {}
+    mOutlinePath(target->fOutlinePath) {
+    if(RenderProfiler::sEnabled() && target->fParentBox) {
+        mProfileLabel = target->fParentBox->prp_getName();
+    }
+}
+
+void PathEffectsTask::applyEffects(const EffectsList& effects,
+                                   PathEffectPath& path) const {
+    for(const auto& effect : effects) {
+        const PathEffectCaller& caller = *effect;
+        RenderProfiler::Scope scope("cpu", typeid(caller));
+        if(scope.active()) scope.setBox(mProfileLabel);
+        effect->applyTo(path);
+    }
+}
 
 void PathEffectsTask::process() {
     const bool pathReady = mPathEffects.isEmpty();
     const bool fillReady = pathReady && mFillEffects.isEmpty();
     const bool outlineBaseReady = pathReady && mOutlineBaseEffects.isEmpty();
+    const bool outlineReady = outlineBaseReady && mOutlineEffects.isEmpty();
 
-    for(const auto& effect : mPathEffects) {
-        effect->apply(mPath);
-    }
+    // fill and outline chains start from the shared path effects result
+    // and keep its representation, no conversion if they do not need one
+    PathEffectPath path(mPath);
+    applyEffects(mPathEffects, path);
+    if(!pathReady) mPath = path.skPath();
 
-    if(!fillReady) {
-        mFillPath = mPath;
-        for(const auto& effect : mFillEffects) {
-            effect->apply(mFillPath);
-        }
+    const bool parallel = !fillReady && !outlineReady &&
+                          mPath.countPoints() >= PARALLEL_MIN_POINTS &&
+                          QThread::idealThreadCount() > 1;
+    if(parallel) {
+        path.prepareForSharing();
+        ParallelJobs::sRun(2, 2, [this, &path](const int id) {
+            if(id == 0) processFill(path);
+            else processOutline(path);
+        });
+    } else {
+        if(!fillReady) processFill(path);
+        if(!outlineReady) processOutline(path);
     }
+}
 
-    if(!outlineBaseReady) {
-        mOutlineBasePath = mPath;
-        for(const auto& effect : mOutlineBaseEffects) {
-            effect->apply(mOutlineBasePath);
-        }
+void PathEffectsTask::processFill(const PathEffectPath& path) {
+    PathEffectPath fillPath(path);
+    applyEffects(mFillEffects, fillPath);
+    mFillPath = fillPath.skPath();
+}
+
+void PathEffectsTask::processOutline(const PathEffectPath& path) {
+    if(!mPathEffects.isEmpty() || !mOutlineBaseEffects.isEmpty()) {
+        PathEffectPath outlineBasePath(path);
+        applyEffects(mOutlineBaseEffects, outlineBasePath);
+        mOutlineBasePath = outlineBasePath.skPath();
         mStroker.strokePath(mOutlineBasePath, &mOutlinePath);
     }
 
-    for(const auto& effect : mOutlineEffects) {
-        effect->apply(mOutlinePath);
-    }
+    if(mOutlineEffects.isEmpty()) return;
+    PathEffectPath outlinePath(mOutlinePath);
+    applyEffects(mOutlineEffects, outlinePath);
+    mOutlinePath = outlinePath.skPath();
 }
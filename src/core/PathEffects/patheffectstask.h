@@ -49,6 +49,7 @@ public:
     }
 
     void process();
+    QString profileLabel() const { return mProfileLabel; }
 
     void afterProcessing() {
         if(!mTarget) return;
@@ -58,6 +59,12 @@ public:
         mTarget->fOutlinePath = mOutlinePath;
     }
 private:
+    void applyEffects(const EffectsList& effects,
+                      PathEffectPath& path) const;
+
+    void processFill(const PathEffectPath& path);
+    void processOutline(const PathEffectPath& path);
+
     const stdptr<PathBoxRenderData> mTarget;
     const SkStroke mStroker;
 
@@ -70,6 +77,8 @@ private:
     SkPath mFillPath;
     SkPath mOutlineBasePath;
     SkPath mOutlinePath;
+
+    QString mProfileLabel;
 };
 
 #endif // PATHEFFECTSTASK_H
@@ -36,20 +36,15 @@ class SubdivideEffectCaller : public PathEffectCaller {
 public:
     SubdivideEffectCaller(const int count) : mCount(count) {}
 
-    void apply(SkPath& path);
+    void applyTo(PathEffectPath& path);
 private:
     const int mCount;
 };
 
-void SubdivideEffectCaller::apply(SkPath &path) {
-    SkPath src;
-    path.swap(src);
-    path.setFillType(src.getFillType());
-    auto lists = CubicList::sMakeFromSkPath(src);
-    for(auto & list : lists) {
-        list.subdivide(mCount);
-        path.addPath(list.toSkPath());
-    }
+void SubdivideEffectCaller::applyTo(PathEffectPath &path) {
+    auto lists = path.segments();
+    for(auto & list : lists) list.subdivide(mCount);
+    path.setSegments(lists);
 }
 
 stdsptr<PathEffectCaller> SubdividePathEffect::getEffectCaller(
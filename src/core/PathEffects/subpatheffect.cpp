@@ -57,30 +57,28 @@ public:
                         const qreal minFrac, const qreal maxFrac) :
         mPathWise(pathWise), mMinFrac(minFrac), mMaxFrac(maxFrac) {}
 
-    void apply(SkPath& path);
+    void applyTo(PathEffectPath& path);
 private:
     const bool mPathWise;
     const qreal mMinFrac;
     const qreal mMaxFrac;
 };
 
-void SubPathEffectCaller::apply(SkPath &path) {
+void SubPathEffectCaller::applyTo(PathEffectPath &path) {
     if(isZero6Dec(mMaxFrac - 1) && isZero6Dec(mMinFrac)) return;
 
     if(isZero6Dec(mMaxFrac - mMinFrac)) {
-        path.reset();
+        path.editSkPath().reset();
         return;
     }
 
-    auto paths = CubicList::sMakeFromSkPath(path);
-    const auto srcFillType = path.getFillType();
-    path.reset();
-    path.setFillType(srcFillType);
-
+    const auto paths = path.segments();
+    QList<CubicList> result;
     if(mPathWise) {
         for(auto& iPath : paths) {
-            path.addPath(iPath.getFragmentUnbound(mMinFrac, mMaxFrac).toSkPath());
+            result << iPath.getFragmentUnbound(mMinFrac, mMaxFrac);
         }
+        path.setSegments(result);
         return;
     } // else
 
@@ -88,6 +86,7 @@ void SubPathEffectCaller::apply(SkPath &path) {
     for(auto& iPath : paths) {
         totalLength += iPath.getTotalLength();
     }
+
     const qreal minLength = mMinFrac*totalLength;
     const qreal maxLength = mMaxFrac*totalLength;
 
@@ -96,11 +95,9 @@ void SubPathEffectCaller::apply(SkPath &path) {
     while(currLen < maxLength) {
         for(auto& iPath : paths) {
             const qreal pathLen = iPath.getTotalLength();
-
             const qreal minRemLen = minLength - currLen;
             const qreal maxRemLen = maxLength - currLen;
             currLen += pathLen;
-
             if(first) {
                 if(currLen > minLength) {
                     first = false;
@@ -108,19 +105,20 @@ void SubPathEffectCaller::apply(SkPath &path) {
                     const bool last = currLen > maxLength;
                     if(last) maxFrag = maxRemLen/pathLen;
                     else maxFrag = 1;
-                    path.addPath(iPath.getFragment(minRemLen/pathLen, maxFrag).toSkPath());
+                    result << iPath.getFragment(minRemLen/pathLen, maxFrag);
                     if(last) break;
                 }
             } else {
                 if(currLen > maxLength) {
-                    path.addPath(iPath.getFragment(0, maxRemLen/pathLen).toSkPath());
+                    result << iPath.getFragment(0, maxRemLen/pathLen);
                     break;
                 } else {
-                    path.addPath(iPath.toSkPath());
+                    result << iPath;
                 }
             }
         }
     }
+    path.setSegments(result);
 }
 
 stdsptr<PathEffectCaller> SubPathEffect::getEffectCaller(
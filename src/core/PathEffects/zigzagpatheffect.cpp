@@ -40,18 +40,17 @@ public:
     ZigZagEffectCaller(const qreal angle, const qreal dist) :
         mAngle(angle), mDist(dist) {}
 
-    void apply(SkPath& path);
+    void applyTo(PathEffectPath& effectPath);
 private:
     const qreal mAngle;
     const qreal mDist;
 };
 
-void ZigZagEffectCaller::apply(SkPath &path) {
-    auto segLists = CubicList::sMakeFromSkPath(path);
-    const QRectF pathBounds = toQRectF(path.getBounds());
-    const auto srcFillType = path.getFillType();
-    path.reset();
-    path.setFillType(srcFillType);
+void ZigZagEffectCaller::applyTo(PathEffectPath &effectPath) {
+    const auto& segLists = effectPath.segments();
+    const QRectF pathBounds = toQRectF(effectPath.bounds());
+    SkPath path;
+    path.setFillType(effectPath.fillType());
     QTransform rotate;
     const QPointF pivot = pathBounds.center();
     rotate.translate(pivot.x(), pivot.y());
@@ -98,6 +97,7 @@ void ZigZagEffectCaller::apply(SkPath &path) {
 
         prevLines = currLines;
     }
+    effectPath = path;
 }
 
 stdsptr<PathEffectCaller> ZigZagPathEffect::getEffectCaller(
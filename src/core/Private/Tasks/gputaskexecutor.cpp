@@ -31,13 +31,15 @@ QAtomicList<stdsptr<eTask>> GpuTaskExecutor::sTasks;
 QAtomicInt GpuTaskExecutor::sUseCount = 0;
 
 GpuTaskExecutor::GpuTaskExecutor() :
-    TaskExecutor(sUseCount, sTasks) {}
+    TaskExecutor("gpu", sUseCount, sTasks) {}
 
 void GpuTaskExecutor::sAddTask(const stdsptr<eTask>& ready) {
+    sQued(*ready);
     sTasks.appendAndNotifyAll(ready);
 }
 
 void GpuTaskExecutor::sAddTasks(const QList<stdsptr<eTask>>& ready) {
+    for(const auto& task : ready) sQued(*task);
     sTasks.appendAndNotifyAll(ready);
 }
 
@@ -24,21 +24,49 @@
 // Fork of enve - Copyright (C) 2016-2020 Maurycy Liebner
 
 #include "taskexecutor.h"
+#include "Tasks/renderprofiler.h"
+
+#include <QElapsedTimer>
+#include <typeinfo>
 
 QAtomicInt TaskExecutor::sTaskFinishSignals = 0;
 
+static QString metricName(const char* const category,
+                          const char* const name) {
+    return QString("executor.%1.%2").arg(category, name);
+}
+
+TaskExecutor::TaskExecutor(const char* const profileCategory,
+                           QAtomicInt& count,
+                           QAtomicList<stdsptr<eTask>>& tasks) :
+    mProfileCategory(profileCategory),
+    mFinishedTasks(MetricsRegistry::sCounter(
+                       metricName(profileCategory, "tasks"))),
+    mBusyTime(MetricsRegistry::sCounter(
+                  metricName(profileCategory, "busy_us"))),
+    mStepTime(MetricsRegistry::sHistogram(
+                  metricName(profileCategory, "step_us"))),
+    mUseCount(count), mTasks(tasks) {}
+
 void TaskExecutor::processTask(eTask& task) {
     task.process();
 }
 
+void TaskExecutor::sQued(eTask& task) {
+    if(!RenderProfiler::sEnabled() || task.mQuedTimestamp >= 0) return;
+    task.mQuedTimestamp = RenderProfiler::sNow();
+}
+
 QAtomicList<stdsptr<eTask>> CpuTaskExecutor::sTasks;
 QAtomicInt CpuTaskExecutor::sUseCount = 0;
 
 void CpuTaskExecutor::sAddTask(const stdsptr<eTask>& ready) {
+    sQued(*ready);
     sTasks.appendAndNotifyAll(ready);
 }
 
 void CpuTaskExecutor::sAddTasks(const QList<stdsptr<eTask>>& ready) {
+    for(const auto& task : ready) sQued(*task);
     sTasks.appendAndNotifyAll(ready);
 }
 
@@ -64,15 +92,32 @@ void TaskExecutor::processLoop() {
         stdsptr<eTask> task;
         if(!mTasks.waitTakeFirst(task, mStop)) break;
         mUseCount++;
-        try {
-            processTask(*task);
-        } catch(...) {
-            task->setException(std::current_exception());
+        {
+            const eTask& taskRef = *task;
+            RenderProfiler::Scope scope(mProfileCategory, typeid(taskRef));
+            if(scope.active()) {
+                scope.setBox(task->profileLabel());
+                const qint64 qued = task->mQuedTimestamp;
+                if(qued >= 0) scope.setWait(RenderProfiler::sNow() - qued);
+            }
+            QElapsedTimer timer;
+            timer.start();
+            try {
+                processTask(*task);
+            } catch(...) {
+                task->setException(std::current_exception());
+            }
+            const qint64 elapsed = timer.nsecsElapsed()/1000;
+            mBusyTime.add(elapsed);
+            mStepTime.record(elapsed);
+            // a next step is qued right away, its wait starts now
+            if(scope.active()) task->mQuedTimestamp = RenderProfiler::sNow();
         }
 
         const bool nextStep = !task->waitingToCancel() &&
                               task->nextStep();
         if(!nextStep) {
+            mFinishedTasks.add();
             sTaskFinishSignals++;
             emit finishedTask(task);
         }
@@ -84,10 +129,12 @@ QAtomicList<stdsptr<eTask>> HddTaskExecutor::sTasks;
 QAtomicInt HddTaskExecutor::sUseCount = 0;
 
 void HddTaskExecutor::sAddTask(const stdsptr<eTask>& ready) {
+    sQued(*ready);
     sTasks.appendAndNotifyAll(ready);
 }
 
 void HddTaskExecutor::sAddTasks(const QList<stdsptr<eTask>>& ready) {
+    for(const auto& task : ready) sQued(*task);
     sTasks.appendAndNotifyAll(ready);
 }
 
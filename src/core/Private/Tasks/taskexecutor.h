@@ -29,14 +29,15 @@
 #include <QThread>
 
 #include "Tasks/updatable.h"
+#include "Tasks/metricsregistry.h"
 #include "../qatomiclist.h"
 
 class CORE_EXPORT TaskExecutor : public QObject {
     Q_OBJECT
 public:
-    TaskExecutor(QAtomicInt& count,
-                 QAtomicList<stdsptr<eTask>>& tasks) :
-        mUseCount(count), mTasks(tasks) {}
+    TaskExecutor(const char* const profileCategory,
+                 QAtomicInt& count,
+                 QAtomicList<stdsptr<eTask>>& tasks);
 
     static QAtomicInt sTaskFinishSignals;
 
@@ -46,18 +47,27 @@ signals:
     void finishedTask(const stdsptr<eTask>&);
 protected:
     void processLoop();
+
+    //! @brief Starts the RenderProfiler queue wait of the task
+    static void sQued(eTask& task);
 private:
     virtual void processTask(eTask& task);
 
     std::atomic<bool> mStop;
 
+    const char* const mProfileCategory;
+
+    MetricsRegistry::Counter& mFinishedTasks;
+    MetricsRegistry::Counter& mBusyTime;
+    MetricsRegistry::Histogram& mStepTime;
+
     QAtomicInt& mUseCount;
     QAtomicList<stdsptr<eTask>>& mTasks;
 };
 
 class CORE_EXPORT CpuTaskExecutor : public TaskExecutor {
 public:
-    CpuTaskExecutor() : TaskExecutor(sUseCount, sTasks) {}
+    CpuTaskExecutor() : TaskExecutor("cpu", sUseCount, sTasks) {}
 
     static void sAddTask(const stdsptr<eTask>& ready);
     static void sAddTasks(const QList<stdsptr<eTask>>& ready);
@@ -70,7 +80,7 @@ private:
 
 class CORE_EXPORT HddTaskExecutor : public TaskExecutor {
 public:
-    HddTaskExecutor() : TaskExecutor(sUseCount, sTasks) {}
+    HddTaskExecutor() : TaskExecutor("hdd", sUseCount, sTasks) {}
 
     static void sAddTask(const stdsptr<eTask>& ready);
     static void sAddTasks(const QList<stdsptr<eTask>>& ready);
@@ -24,11 +24,17 @@
 // Fork of enve - Copyright (C) 2016-2020 Maurycy Liebner
 
 #include "taskquehandler.h"
+#include "Tasks/metricsregistry.h"
 
 int TaskQueHandler::countQues() const { return mQues.count(); }
 
 bool TaskQueHandler::isEmpty() const { return mQues.isEmpty(); }
 
+int TaskQueHandler::countQued(const int queId) const {
+    if(queId < 0 || queId >= mQues.count()) return 0;
+    return mQues.at(queId)->countQued();
+}
+
 void TaskQueHandler::clear() {
     mQues.clear();
     mCurrentQue = nullptr;
@@ -89,6 +95,8 @@ void TaskQueHandler::addTask(const stdsptr<eTask> &task) {
 void TaskQueHandler::endQue() {
     if(!mCurrentQue) return;
     const int count = mCurrentQue->countQued();
+    static auto& queSize = MetricsRegistry::sHistogram("scheduler.que_size");
+    queSize.record(count);
     if(count == 0) mQues.removeLast();
     mCurrentQue = nullptr;
 }
@@ -44,6 +44,8 @@ public:
     void endQue();
 
     int taskCount() const { return mTaskCount; }
+    //! @brief Tasks left in the que at queId, 0 if there is none
+    int countQued(const int queId) const;
 private:
     void queDone(const TaskQue * const que, const int queId);
 
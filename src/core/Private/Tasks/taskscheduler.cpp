@@ -32,6 +32,7 @@
 #include "complextask.h"
 #include "Private/document.h"
 #include "Boxes/boxrenderdata.h"
+#include "Tasks/metricsregistry.h"
 
 TaskScheduler *TaskScheduler::sInstance = nullptr;
 
@@ -55,10 +56,16 @@ TaskScheduler::TaskScheduler() {
     mGpuExec = std::make_shared<GpuExecController>(this);
     connect(mGpuExec.get(), &ExecController::finishedTaskSignal,
             this, &TaskScheduler::afterCpuGpuTaskFinished);
+
+    addMetricProbes();
 }
 
 TaskScheduler::~TaskScheduler()
 {
+    for (const auto& name : mMetricProbes) {
+        MetricsRegistry::sRemoveProbe(name);
+    }
+
     mGpuExec->stop(); // workaround for deadlock, waiting will not work here
     // may result in "QThread: Destroyed while thread is still running" during shutdown
 
@@ -66,6 +73,59 @@ TaskScheduler::~TaskScheduler()
     mHddExec->stopAndWait();
 }
 
+void TaskScheduler::addMetricProbes() {
+    const auto addProbe = [this](const QString& name,
+                                 const MetricsRegistry::Probe& probe) {
+        MetricsRegistry::sAddProbe(name, probe);
+        mMetricProbes << name;
+    };
+    addProbe("scheduler.ques", [this]() {
+        return mQuedCGTasks.countQues();
+    });
+    addProbe("scheduler.qued", [this]() {
+        return mQuedCGTasks.taskCount();
+    });
+    addProbe("scheduler.hdd_qued", [this]() {
+        return mQuedHddTasks.count();
+    });
+    addProbe("scheduler.critical_memory", [this]() {
+        return mCriticalMemoryState ? 1 : 0;
+    });
+    // with always que on there is at most a que per cpu thread
+    addProbe("scheduler.que_slots", [this]() {
+        return mCpuExecs.count();
+    });
+    for(int i = 0; i < mCpuExecs.count(); i++) {
+        addProbe(QString("scheduler.que%1.qued").arg(i), [this, i]() {
+            return mQuedCGTasks.countQued(i);
+        });
+    }
+
+    addProbe("executor.cpu.threads", [this]() {
+        const int cap = eSettings::sInstance->fCpuThreadsCap;
+        const int count = mCpuExecs.count();
+        return cap > 0 ? qMin(count, cap) : count;
+    });
+    addProbe("executor.cpu.busy", []() {
+        return CpuTaskExecutor::sUsageCount();
+    });
+    addProbe("executor.cpu.waiting", []() {
+        return CpuTaskExecutor::sWaitingTasks();
+    });
+    addProbe("executor.gpu.busy", []() {
+        return GpuTaskExecutor::sUsageCount();
+    });
+    addProbe("executor.gpu.waiting", []() {
+        return GpuTaskExecutor::sWaitingTasks();
+    });
+    addProbe("executor.hdd.busy", []() {
+        return HddTaskExecutor::sUsageCount();
+    });
+    addProbe("executor.hdd.waiting", []() {
+        return HddTaskExecutor::sWaitingTasks();
+    });
+}
+
 void TaskScheduler::sSetTaskUnderflowFunc(const Func& func) {
     sInstance->setTaskUnderflowFunc(func);
 }
@@ -27,6 +27,7 @@
 #define TASKSCHEDULER_H
 
 #include <QObject>
+#include <QStringList>
 
 #include "Tasks/etask.h"
 #include "taskquehandler.h"
@@ -112,6 +113,8 @@ private:
 
     void callAllTasksFinishedFunc() const;
 
+    void addMetricProbes();
+
     static TaskScheduler* sInstance;
 
     bool mCriticalMemoryState = false;
@@ -130,6 +133,8 @@ private:
 
     Func mTaskUnderflowFunc;
     Func mAllTasksFinishedFunc;
+
+    QStringList mMetricProbes;
 };
 
 #endif // TASKSCHEDULER_H
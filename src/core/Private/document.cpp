@@ -27,6 +27,7 @@
 #include "Boxes/internallinkcanvas.h"
 #include "canvas.h"
 #include "simpletask.h"
+#include "ReadWrite/projectwriter.h"
 
 #include <QVariant>
 #include <QColor>
@@ -278,6 +279,7 @@ bool Document::removeVisibleScene(Canvas * const scene)
 void Document::setActiveScene(Canvas * const scene)
 {
     if (scene == fActiveScene) { return; }
+    if (scene) { scene->loadDeferredContent(); }
     auto& conn = fActiveScene.assign(scene);
     if (fActiveScene) {
         conn << connect(fActiveScene, &Canvas::currentBoxChanged,
@@ -434,6 +436,8 @@ void Document::setPaintMode(const PaintMode mode)
 
 void Document::clear()
 {
+    // the scenes are about to be removed, finish writing them first
+    ProjectWriter::sFinishAll();
     setPath("");
     const int nScenes = fScenes.count();
     for (int i = 0; i < nScenes; i++) { removeScene(0); }
@@ -27,7 +27,9 @@
 #define DOCUMENT_H
 
 #include <set>
+#include <functional>
 #include <QDomDocument>
+#include <QSet>
 
 #include "smartPointers/ememory.h"
 #include "singlewidgettarget.h"
@@ -51,6 +53,7 @@
 class SceneBoundGradient;
 class FileDataCacheHandler;
 class Canvas;
+class QBuffer;
 enum class CanvasMode : short;
 
 enum class NodeVisiblity {
@@ -189,9 +192,25 @@ public:
 //
     void clear();
 //
-    void writeScenes(eWriteStream &dst) const;
+    void loadDeferredScenes() const;
     void readScenes(eReadStream &src);
 
+    //! @brief Project file sections owned by the application,
+    //! i.e. the window layout and the render settings
+    using WriteSection = std::function<void(eWriteStream&)>;
+    using ReadSection = std::function<void(eReadStream&)>;
+    //! @brief Writes the whole project file including its footer,
+    //! see ProjectWriter to spread the work over several steps
+    void writeProject(eWriteStream &dst,
+                      const WriteSection& layout,
+                      const WriteSection& renderSettings) const;
+    //! @brief Reads a project file held in memory,
+    //! src has to be positioned after the file version
+    void readProject(QBuffer &src, const int evVersion,
+                     const QString& path,
+                     const ReadSection& layout,
+                     const ReadSection& renderSettings);
+
     void writeXEV(const std::shared_ptr<XevZipFileSaver>& xevFileSaver,
                   const RuntimeIdToWriteId& objListIdConv) const;
     void writeDoxumentXEV(QDomDocument& doc) const;
@@ -209,6 +228,13 @@ public:
                               const UpdateFuncs &updateFuncs,
                               const int visiblePartWidgetId);
 private:
+    friend class ProjectWriter;
+    //! @brief Scenes linked with other scenes through a box target
+    QSet<Canvas*> linkedScenes() const;
+    void writeScenesBegin(eWriteStream &dst) const;
+    void writeScene(eWriteStream &dst, Canvas* const scene,
+                    const bool selfContained) const;
+
     void readDocumentXEV(const QDomDocument& doc,
                          QList<Canvas*>& scenes);
 
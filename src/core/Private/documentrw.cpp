@@ -30,10 +30,107 @@
 #include "XML/xmlexporthelpers.h"
 #include "Animators/gradient.h"
 #include "Paint/brushescontext.h"
+#include "ReadWrite/filefooter.h"
+#include "ReadWrite/projectwriter.h"
+#include "Properties/boxtargetproperty.h"
 #include "simpletask.h"
 #include "canvas.h"
 #include "grid.h"
 
+#include <QBuffer>
+#include <QSet>
+
+static void execOnProperties(ContainerBox* const container,
+                             const std::function<void(Property*)> &op)
+{
+    container->ca_execOnDescendants(op);
+    for (const auto box : container->getContainedBoxes()) {
+        if (const auto cont = enve_cast<ContainerBox*>(box)) {
+            execOnProperties(cont, op);
+        } else { box->ca_execOnDescendants(op); }
+    }
+}
+
+// scenes linked with other scenes (in either direction) through a box
+// target have to be read together with the rest of the document
+QSet<Canvas*> Document::linkedScenes() const
+{
+    QSet<Canvas*> result;
+    const auto op = [&result](Property* const prop) {
+        const auto targetProp = enve_cast<BoxTargetProperty*>(prop);
+        if (!targetProp) { return; }
+        const auto target = targetProp->getTarget();
+        if (!target) { return; }
+        const auto propScene = targetProp->getParentScene();
+        const auto targetScene = target->getParentScene();
+        if (propScene == targetScene) { return; }
+        result << propScene << targetScene;
+    };
+    for (const auto &scene : fScenes) { execOnProperties(scene.get(), op); }
+    return result;
+}
+
+// origin is the position the scene content was first written at,
+// checkpoints inside of it are relative to that position
+static Canvas::DeferredContent deferredSceneRead(eReadStream &src,
+                                                 const QByteArray &data,
+                                                 Canvas* const scene,
+                                                 const qint64 origin)
+{
+    const int evVersion = src.evFileVersion();
+    const QDir dir = src.dir();
+    const RuntimeIdToWriteId objListIdConv = src.objListIdConv();
+    const eFuturePos startPos = src.currentPos();
+    return [scene, data, evVersion, dir, objListIdConv, startPos, origin]() {
+        QBuffer buffer;
+        buffer.setData(data);
+        if (!buffer.open(QIODevice::ReadOnly)) {
+            RuntimeThrow("Could not open deferred scene data");
+        }
+        {
+            eReadStream sceneSrc(evVersion, &buffer);
+            sceneSrc.setDir(dir);
+            sceneSrc.objListIdConv() = objListIdConv;
+            buffer.seek(data.size() - FileFooter::sSize(evVersion) -
+                        qint64(sizeof(int)));
+            sceneSrc.readFutureTable();
+            sceneSrc.seek(startPos);
+            sceneSrc.setCheckpointOffset(origin - startPos.fMain);
+
+            // the scene could have been renamed before being loaded
+            const QString name = scene->prp_getName();
+            const auto block = scene->blockUndoRedo();
+            scene->readBoundingBox(sceneSrc);
+            sceneSrc.readCheckpoint("Error reading scene");
+            scene->prp_setName(name);
+        }
+        SimpleTask::sProcessAll();
+    };
+}
+
+static Canvas::DeferredWrite deferredSceneWrite(eReadStream &src,
+                                                const QByteArray &data,
+                                                const eFuturePos &endPos,
+                                                const qint64 origin)
+{
+    const int evVersion = src.evFileVersion();
+    const QDir dir = src.dir();
+    const eFuturePos startPos = src.currentPos();
+    const auto futures = src.futures(int(startPos.fFutureTable) + 1,
+                                     int(endPos.fFutureTable));
+    return [data, evVersion, dir, startPos, endPos, futures, origin](
+            eWriteStream &dst) {
+        // the copy has to be in the current format
+        // and its relative file paths have to stay valid
+        if (evVersion != EvFormat::version) { return false; }
+        if (dst.dir() != dir) { return false; }
+        dst.write(&origin, sizeof(qint64));
+        dst.writeCopied(data.constData() + startPos.fMain,
+                        endPos.fMain - startPos.fMain, startPos, futures);
+        return true;
+    };
+}
+
 void Document::writeBookmarked(eWriteStream &dst) const
 {
     dst << fColors.count();
@@ -42,7 +139,12 @@ void Document::writeBookmarked(eWriteStream &dst) const
     for(const auto &brush : fBrushes) { dst << brush; }
 }
 
-void Document::writeScenes(eWriteStream& dst) const
+void Document::loadDeferredScenes() const
+{
+    for (const auto &scene : fScenes) { scene->loadDeferredContent(); }
+}
+
+void Document::writeScenesBegin(eWriteStream& dst) const
 {
     writeBookmarked(dst);
     dst.writeCheckpoint();
@@ -52,10 +154,24 @@ void Document::writeScenes(eWriteStream& dst) const
 
     const int nScenes = fScenes.count();
     dst.write(&nScenes, sizeof(int));
-    for (const auto &scene : fScenes) {
+}
+
+void Document::writeScene(eWriteStream& dst, Canvas* const scene,
+                          const bool selfContained) const
+{
+    const auto futureId = dst.planFuturePos();
+    dst << scene->getWriteId();
+    dst << scene->prp_getName();
+    dst << selfContained;
+    // scenes never loaded are copied from the file they were read from
+    if (!selfContained || !scene->writeDeferredContent(dst)) {
+        scene->loadDeferredContent();
+        const qint64 origin = dst.pos() + qint64(sizeof(qint64));
+        dst.write(&origin, sizeof(qint64));
         scene->writeBoundingBox(dst);
         dst.writeCheckpoint();
     }
+    dst.assignFuturePos(futureId);
 }
 
 void Document::readBookmarked(eReadStream &src)
@@ -96,6 +212,11 @@ void Document::readScenes(eReadStream& src)
         src.readCheckpoint("Error reading grid");
     }
 
+    // self-contained scenes are only read when first needed,
+    // requires the whole file to be available in memory
+    const bool lazy = src.evFileVersion() >= EvFormat::lazyScenes;
+    const auto buffer = lazy ? qobject_cast<QBuffer*>(src.device()) : nullptr;
+
     int nScenes;
     src.read(&nScenes, sizeof(int));
     for (int i = 0; i < nScenes; i++) {
@@ -105,14 +226,83 @@ void Document::readScenes(eReadStream& src)
         } else {
             scene = fScenes.at(fScenes.count() - nScenes + i).get();
         }
+        qint64 origin = src.currentPos().fMain;
+        if (lazy) {
+            const auto endPos = src.readFuturePos();
+            int readId; src >> readId;
+            QString name; src >> name;
+            bool selfContained; src >> selfContained;
+            if (src.evFileVersion() >= EvFormat::rawScenes) {
+                src.read(&origin, sizeof(qint64));
+            } else { origin = src.currentPos().fMain; }
+            if (buffer && selfContained) {
+                const auto data = buffer->data();
+                scene->prp_setName(name);
+                src.addReadBox(readId, scene);
+                scene->setDeferredContent(
+                            deferredSceneRead(src, data, scene, origin),
+                            deferredSceneWrite(src, data, endPos, origin));
+                src.seek(endPos);
+                continue;
+            }
+        }
         const auto block = scene->blockUndoRedo();
+        src.setCheckpointOffset(origin - src.currentPos().fMain);
         scene->readBoundingBox(src);
         src.readCheckpoint("Error reading scene");
+        src.setCheckpointOffset(0);
     }
 
     SimpleTask::sProcessAll();
 }
 
+void Document::writeProject(eWriteStream& dst,
+                            const WriteSection& layout,
+                            const WriteSection& renderSettings) const
+{
+    // box write ids cannot be shared with a save in progress
+    ProjectWriter::sFinishAll();
+    ProjectWriter writer(*this, dst, layout, renderSettings);
+    while (writer.writeNext()) {}
+}
+
+void Document::readProject(QBuffer& src,
+                           const int evVersion,
+                           const QString& path,
+                           const ReadSection& layout,
+                           const ReadSection& renderSettings)
+{
+    const qint64 savedPos = src.pos();
+    eReadStream readStream(evVersion, &src);
+    readStream.setPath(path);
+
+    const qint64 pos = src.size() - FileFooter::sSize(evVersion) -
+            qint64(sizeof(int));
+    src.seek(pos);
+    readStream.readFutureTable();
+    src.seek(savedPos);
+    readStream.readCheckpoint("File beginning pos mismatch");
+    if (evVersion >= EvFormat::betterSWTAbsReadWrite) {
+        const bool beforeContent = evVersion >= EvFormat::readSceneSettingsBeforeContent;
+        int nScenes; readStream >> nScenes;
+        for (int i = 0; i < nScenes; i++) {
+            const auto scene = createNewScene(!beforeContent);
+            if (beforeContent) {
+                scene->readSettings(readStream);
+                sceneCreated(scene);
+            }
+        }
+        if (layout) { layout(readStream); }
+        readStream.readCheckpoint("Error reading Layout");
+    }
+    readScenes(readStream);
+    readStream.readCheckpoint("Error reading Document");
+    if (evVersion >= EvFormat::betterSWTAbsReadWrite) {
+        if (renderSettings) { renderSettings(readStream); }
+        readStream.readCheckpoint("Error reading Render Widget");
+    }
+}
+
 void Document::writeDoxumentXEV(QDomDocument& doc) const
 {
     auto document = doc.createElement("Document");
@@ -170,6 +360,7 @@ void Document::writeScenesXEV(const std::shared_ptr<XevZipFileSaver>& xevFileSav
 void Document::writeXEV(const std::shared_ptr<XevZipFileSaver>& xevFileSaver,
                         const RuntimeIdToWriteId& objListIdConv) const
 {
+    loadDeferredScenes();
     auto& fileSaver = xevFileSaver->fileSaver();
     fileSaver.processText("document.xml", [&](QTextStream& stream) {
         QDomDocument document;
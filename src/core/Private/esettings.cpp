@@ -254,6 +254,12 @@ eSettings::eSettings(const int cpuThreads,
     gSettings << std::make_shared<eBoolSetting>(fPreviewCache,
                                                 "PreviewCache",
                                                 true);
+    gSettings << std::make_shared<eBoolSetting>(fAdaptivePreview,
+                                                "AdaptivePreview",
+                                                false);
+    gSettings << std::make_shared<eBoolSetting>(fStreamingPreview,
+                                                "StreamingPreview",
+                                                false);
     /*gSettings << std::make_shared<eBoolSetting>(
                      fTimelineAlternateRow,
                      "timelineAlternateRow", true);
@@ -146,6 +146,8 @@ public:
     int fDefaultFillStrokeIndex = 0;
 
     bool fPreviewCache = true;
+    bool fAdaptivePreview = false;
+    bool fStreamingPreview = false;
 
     // timeline settings
     bool fTimelineAlternateRow = true;
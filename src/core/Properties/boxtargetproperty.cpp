@@ -26,6 +26,7 @@
 #include "boxtargetproperty.h"
 #include "Animators/complexanimator.h"
 #include "Boxes/boundingbox.h"
+#include "canvas.h"
 #include "Properties/emimedata.h"
 #include "simpletask.h"
 
@@ -57,6 +58,8 @@ void BoxTargetProperty::setTargetAction(BoundingBox* const box)
 
 void BoxTargetProperty::setTarget(BoundingBox* const box) {
     if(box == mTarget_d) return;
+    // linking a scene renders its content
+    if(const auto scene = enve_cast<Canvas*>(box)) scene->loadDeferredContent();
 
     mTarget_d.assign(box);
     if(box) {
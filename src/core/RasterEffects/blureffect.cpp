@@ -1,4 +1,5 @@
 #include "blureffect.h"
+#include "gaussianblur.h"
 
 #include "Animators/qrealanimator.h"
 #include "Boxes/containerbox.h"
@@ -15,6 +16,13 @@ public:
                     GpuRenderTools& renderTools);
     void processCpu(CpuRenderTools& renderTools,
                     const CpuRenderData &data);
+
+    // GaussianBlur splits the whole image across the threads itself
+    int cpuThreads(const int available, const int area) const {
+        Q_UNUSED(available)
+        Q_UNUSED(area)
+        return 1;
+    }
 private:
     const float mRadius;
 };
@@ -110,34 +118,13 @@ void BlurEffectCaller::processCpu(CpuRenderTools &renderTools,
 {
     Q_UNUSED(data)
 
-    const float sigma = mRadius*0.3333333f;
-    const auto filter = SkBlurImageFilter::Make(sigma, sigma, nullptr);
-
-    SkPaint paint;
-    paint.setImageFilter(filter);
-
-    SkCanvas canvas(renderTools.fDstBtmp);
-    canvas.clear(SK_ColorTRANSPARENT);
-
-    const int radCeil = static_cast<int>(ceil(mRadius));
     const auto& srcBtmp = renderTools.fSrcBtmp;
-    const auto& texTile = data.fTexTile;
-    auto srcRect = texTile.makeOutset(radCeil, radCeil);
-
-    if (srcRect.intersect(srcRect, srcBtmp.bounds())) {
-        SkBitmap packedTile;
-        packedTile.allocPixels(srcBtmp.info().makeWH(srcRect.width(),
-                                                     srcRect.height()));
+    auto& dstBtmp = renderTools.fDstBtmp;
 
-        srcBtmp.readPixels(packedTile.info(),
-                           packedTile.getPixels(),
-                           packedTile.rowBytes(),
-                           srcRect.left(),
-                           srcRect.top());
-
-        const int drawX = srcRect.left() - texTile.left();
-        const int drawY = srcRect.top() - texTile.top();
-
-        canvas.drawBitmap(packedTile, drawX, drawY, &paint);
+    if (srcBtmp.empty() || srcBtmp.getPixels() == nullptr ||
+        dstBtmp.empty() || dstBtmp.getPixels() == nullptr) {
+        return;
     }
+
+    GaussianBlur::blur(srcBtmp, dstBtmp, mRadius*0.3333333f);
 }
@@ -26,6 +26,7 @@
 #include "brightnesscontrasteffect.h"
 #include "gpurendertools.h"
 #include "openglrastereffectcaller.h"
+#include "effectkernels.h"
 
 #include "colorhelpers.h"
 #include "Animators/qrealanimator.h"
@@ -59,6 +60,8 @@ public:
 
     void processCpu(CpuRenderTools& renderTools,
                     const CpuRenderData& data);
+
+    bool pointWise() const { return true; }
 protected:
     void iniVars(QGL33 * const gl) const {
         sBrightnessU = gl->glGetUniformLocation(sProgramId, "brightness");
@@ -115,23 +118,15 @@ void BrightnessContrastEffectCaller::processCpu(CpuRenderTools& renderTools,
     const int imgHeight = srcBtmp.height();
 
     const int xMin = std::max(0, data.fTexTile.left());
-    const int xMax = std::min((int)data.fTexTile.right(), imgWidth - 1);
+    const int xMax = std::min((int)data.fTexTile.right() - 1, imgWidth - 1);
     const int yMin = std::max(0, data.fTexTile.top());
-    const int yMax = std::min((int)data.fTexTile.bottom(), imgHeight - 1);
+    const int yMax = std::min((int)data.fTexTile.bottom() - 1, imgHeight - 1);
 
+    const int count = xMax - xMin + 1;
     for(int yi = yMin; yi <= yMax; yi++) {
-        auto dst = static_cast<uchar*>(dstBtmp.getAddr(0, yi - yMin));
-        auto src = static_cast<uchar*>(srcBtmp.getAddr(xMin, yi));
-        for(int xi = xMin; xi <= xMax; xi++) {
-            const uchar r = *src++;
-            const uchar g = *src++;
-            const uchar b = *src++;
-            const uchar a = *src++;
-
-            *dst++ = (r - 0.5*a)*(mContrast + 1.) + a*(0.5 + mBrightness);
-            *dst++ = (g - 0.5*a)*(mContrast + 1.) + a*(0.5 + mBrightness);
-            *dst++ = (b - 0.5*a)*(mContrast + 1.) + a*(0.5 + mBrightness);
-            *dst++ = a;
-        }
+        const auto dst = static_cast<uchar*>(dstBtmp.getAddr(0, yi - yMin));
+        const auto src = static_cast<const uchar*>(srcBtmp.getAddr(xMin, yi));
+        EffectKernels::brightnessContrast(src, dst, count,
+                                          mBrightness, mContrast);
     }
 }
@@ -26,6 +26,7 @@
 #include "colorizeeffect.h"
 #include "gpurendertools.h"
 #include "openglrastereffectcaller.h"
+#include "effectkernels.h"
 
 #include "colorhelpers.h"
 #include "Animators/qrealanimator.h"
@@ -72,6 +73,8 @@ public:
 
     void processCpu(CpuRenderTools& renderTools,
                     const CpuRenderData& data);
+
+    bool pointWise() const { return true; }
 protected:
     void iniVars(QGL33 * const gl) const {
         sInfluenceU = gl->glGetUniformLocation(sProgramId, "influence");
@@ -140,41 +143,23 @@ void ColorizeEffectCaller::processCpu(CpuRenderTools& renderTools,
     const int imgHeight = srcBtmp.height();
 
     const int xMin = std::max(0, data.fTexTile.left());
-    const int xMax = std::min((int)data.fTexTile.right(), imgWidth - 1);
+    const int xMax = std::min((int)data.fTexTile.right() - 1, imgWidth - 1);
     const int yMin = std::max(0, data.fTexTile.top());
-    const int yMax = std::min((int)data.fTexTile.bottom(), imgHeight - 1);
+    const int yMax = std::min((int)data.fTexTile.bottom() - 1, imgHeight - 1);
+
+    // hue and saturation are fixed, so the result only depends
+    // on the lightness and is linear on both sides of 0.5
+    qreal r = mHue / 360.;
+    qreal g = mSaturation;
+    qreal b = 0.5;
+    qhsl_to_rgb(r, g, b);
+    const float rgbHalf[3] = {float(r), float(g), float(b)};
 
+    const int count = xMax - xMin + 1;
     for(int yi = yMin; yi <= yMax; yi++) {
-        auto dst = static_cast<uchar*>(renderTools.fDstBtmp.getAddr(0, yi - yMin));
-        auto src = static_cast<uchar*>(renderTools.fSrcBtmp.getAddr(xMin, yi));
-        for(int xi = xMin; xi <= xMax; xi++) {
-            const uchar texR = *src++;
-            const uchar texG = *src++;
-            const uchar texB = *src++;
-            const uchar texA = *src++;
-
-            const qreal texRF = texR/255.;
-            const qreal texGF = texG/255.;
-            const qreal texBF = texB/255.;
-            const qreal texAF = texA/255.;
-
-            if(texA == 0) {
-                for(int i = 0; i < 4; i++) *dst++ = 0;
-                continue;
-            }
-            qreal h = texRF/texAF;
-            qreal s = texGF/texAF;
-            qreal l = texBF/texAF;
-            qrgb_to_hsl(h, s, l);
-            h = mHue / 360.;
-            s = mSaturation;
-            l = qBound(0., l + mLightness, 1.);
-            qhsl_to_rgb(h, s, l);
-
-            *dst++ = 255*(h*texAF*mInfluence + texRF*(1 - mInfluence));
-            *dst++ = 255*(s*texAF*mInfluence + texGF*(1 - mInfluence));
-            *dst++ = 255*(l*texAF*mInfluence + texBF*(1 - mInfluence));
-            *dst++ = texA;
-        }
+        const auto dst = static_cast<uchar*>(dstBtmp.getAddr(0, yi - yMin));
+        const auto src = static_cast<const uchar*>(srcBtmp.getAddr(xMin, yi));
+        EffectKernels::colorize(src, dst, count, rgbHalf,
+                                mLightness, mInfluence);
     }
 }
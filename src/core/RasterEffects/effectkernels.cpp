@@ -0,0 +1,426 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "effectkernels.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EFFECTKERNELS_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define EFFECTKERNELS_AVX2
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define EFFECTKERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(EFFECTKERNELS_AVX2)
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define AVX2_TARGET
+static bool detectAvx2() {
+    int info[4];
+    __cpuid(info, 0);
+    if(info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osxsave = info[2] & (1 << 27);
+    const bool avx = info[2] & (1 << 28);
+    // the OS has to save the ymm registers
+    if(!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return info[1] & (1 << 5);
+}
+#else
+#define AVX2_TARGET __attribute__((target("avx2")))
+static bool detectAvx2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+#endif
+static const bool gAvx2 = detectAvx2();
+#endif
+
+static inline uint8_t toByte(const float value) {
+    return static_cast<uint8_t>(std::min(255.f, std::max(0.f, value)));
+}
+
+static void brightnessContrastScalar(const uint8_t* src, uint8_t* dst,
+                                     const int count,
+                                     const float k, const float d) {
+    for(int i = 0; i < count; i++, src += 4, dst += 4) {
+        const float ad = src[3]*d;
+        dst[0] = toByte(src[0]*k + ad);
+        dst[1] = toByte(src[1]*k + ad);
+        dst[2] = toByte(src[2]*k + ad);
+        dst[3] = src[3];
+    }
+}
+
+static void colorizeScalar(const uint8_t* src, uint8_t* dst, const int count,
+                           const float rgbHalf[3], const float lightness,
+                           const float influence) {
+    for(int i = 0; i < count; i++, src += 4, dst += 4) {
+        const int alpha = src[3];
+        if(alpha == 0) {
+            std::fill(dst, dst + 4, 0);
+            continue;
+        }
+        const int mx = std::min(alpha, std::max<int>({src[0], src[1], src[2]}));
+        const int mn = std::min(alpha, std::min<int>({src[0], src[1], src[2]}));
+        const float l = std::min(1.f, std::max(0.f, 0.5f*(mx + mn)/alpha +
+                                                    lightness));
+        const float lo = std::min(2*l, 1.f);
+        const float hi = std::max(2*l - 1, 0.f);
+        const float aInfl = alpha*influence;
+        for(int c = 0; c < 3; c++) {
+            const float color = rgbHalf[c]*lo + (1 - rgbHalf[c])*hi;
+            dst[c] = toByte(color*aInfl + src[c]*(1 - influence));
+        }
+        dst[3] = src[3];
+    }
+}
+
+static void scaleScalar(const uint8_t* src, uint8_t* dst,
+                        const float* factors, const int count) {
+    for(int i = 0; i < count; i++, src += 4, dst += 4) {
+        const float f = factors[i];
+        for(int c = 0; c < 4; c++) dst[c] = toByte(src[c]*f);
+    }
+}
+
+#if defined(EFFECTKERNELS_SSE2)
+// 4 pixels to one float vector per channel
+static inline void loadSse2(const uint8_t* src, __m128 ch[4]) {
+    const __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    ch[0] = _mm_cvtepi32_ps(_mm_and_si128(px, mask));
+    ch[1] = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(px, 8), mask));
+    ch[2] = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(px, 16), mask));
+    ch[3] = _mm_cvtepi32_ps(_mm_srli_epi32(px, 24));
+}
+
+static inline void storeSse2(uint8_t* dst, const __m128 ch[4]) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 maxValue = _mm_set1_ps(255.f);
+    __m128i v[4];
+    for(int c = 0; c < 4; c++) {
+        v[c] = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(ch[c], zero), maxValue));
+    }
+    const __m128i px = _mm_or_si128(_mm_or_si128(v[0], _mm_slli_epi32(v[1], 8)),
+                                    _mm_or_si128(_mm_slli_epi32(v[2], 16),
+                                                 _mm_slli_epi32(v[3], 24)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), px);
+}
+#endif
+
+#if defined(EFFECTKERNELS_AVX2)
+AVX2_TARGET
+static inline void loadAvx2(const uint8_t* src, __m256 ch[4]) {
+    const __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+    ch[0] = _mm256_cvtepi32_ps(_mm256_and_si256(px, mask));
+    ch[1] = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(px, 8), mask));
+    ch[2] = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(px, 16), mask));
+    ch[3] = _mm256_cvtepi32_ps(_mm256_srli_epi32(px, 24));
+}
+
+AVX2_TARGET
+static inline void storeAvx2(uint8_t* dst, const __m256 ch[4]) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 maxValue = _mm256_set1_ps(255.f);
+    __m256i v[4];
+    for(int c = 0; c < 4; c++) {
+        v[c] = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(ch[c], zero),
+                                                 maxValue));
+    }
+    const __m256i px = _mm256_or_si256(
+                _mm256_or_si256(v[0], _mm256_slli_epi32(v[1], 8)),
+                _mm256_or_si256(_mm256_slli_epi32(v[2], 16),
+                                _mm256_slli_epi32(v[3], 24)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), px);
+}
+
+AVX2_TARGET
+static int brightnessContrastAvx2(const uint8_t* src, uint8_t* dst,
+                                  const int count,
+                                  const float k, const float d) {
+    const __m256 kV = _mm256_set1_ps(k);
+    const __m256 dV = _mm256_set1_ps(d);
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        __m256 ch[4];
+        loadAvx2(src + 4*i, ch);
+        const __m256 ad = _mm256_mul_ps(ch[3], dV);
+        for(int c = 0; c < 3; c++) {
+            ch[c] = _mm256_add_ps(_mm256_mul_ps(ch[c], kV), ad);
+        }
+        storeAvx2(dst + 4*i, ch);
+    }
+    return i;
+}
+
+AVX2_TARGET
+static int colorizeAvx2(const uint8_t* src, uint8_t* dst, const int count,
+                        const float rgbHalf[3], const float lightness,
+                        const float influence) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.f);
+    const __m256 two = _mm256_set1_ps(2.f);
+    const __m256 halfV = _mm256_set1_ps(0.5f);
+    const __m256 lightV = _mm256_set1_ps(lightness);
+    const __m256 inflV = _mm256_set1_ps(influence);
+    const __m256 keepV = _mm256_set1_ps(1 - influence);
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        __m256 ch[4];
+        loadAvx2(src + 4*i, ch);
+        const __m256 a = ch[3];
+        const __m256 mx = _mm256_min_ps(_mm256_max_ps(_mm256_max_ps(ch[0], ch[1]),
+                                                      ch[2]), a);
+        const __m256 mn = _mm256_min_ps(_mm256_min_ps(_mm256_min_ps(ch[0], ch[1]),
+                                                      ch[2]), a);
+        __m256 l = _mm256_div_ps(_mm256_mul_ps(_mm256_add_ps(mx, mn), halfV),
+                                 _mm256_max_ps(a, one));
+        l = _mm256_min_ps(one, _mm256_max_ps(zero, _mm256_add_ps(l, lightV)));
+        const __m256 l2 = _mm256_mul_ps(l, two);
+        const __m256 lo = _mm256_min_ps(l2, one);
+        const __m256 hi = _mm256_max_ps(_mm256_sub_ps(l2, one), zero);
+        const __m256 aInfl = _mm256_mul_ps(a, inflV);
+        const __m256 valid = _mm256_cmp_ps(a, zero, _CMP_GT_OQ);
+        for(int c = 0; c < 3; c++) {
+            const __m256 color = _mm256_add_ps(
+                        _mm256_mul_ps(_mm256_set1_ps(rgbHalf[c]), lo),
+                        _mm256_mul_ps(_mm256_set1_ps(1 - rgbHalf[c]), hi));
+            const __m256 value = _mm256_add_ps(_mm256_mul_ps(color, aInfl),
+                                               _mm256_mul_ps(ch[c], keepV));
+            ch[c] = _mm256_and_ps(value, valid);
+        }
+        storeAvx2(dst + 4*i, ch);
+    }
+    return i;
+}
+
+AVX2_TARGET
+static int scaleAvx2(const uint8_t* src, uint8_t* dst,
+                     const float* factors, const int count) {
+    int i = 0;
+    for(; i + 8 <= count; i += 8) {
+        __m256 ch[4];
+        loadAvx2(src + 4*i, ch);
+        const __m256 f = _mm256_loadu_ps(factors + i);
+        for(int c = 0; c < 4; c++) ch[c] = _mm256_mul_ps(ch[c], f);
+        storeAvx2(dst + 4*i, ch);
+    }
+    return i;
+}
+#endif
+
+#if defined(EFFECTKERNELS_NEON)
+// 8 pixels of one channel to two float vectors
+static inline void loadNeon(const uint8x8_t bytes, float32x4_t values[2]) {
+    const uint16x8_t wide = vmovl_u8(bytes);
+    values[0] = vcvtq_f32_u32(vmovl_u16(vget_low_u16(wide)));
+    values[1] = vcvtq_f32_u32(vmovl_u16(vget_high_u16(wide)));
+}
+
+// truncates and saturates, like the scalar version
+static inline uint8x8_t storeNeon(const float32x4_t values[2]) {
+    const uint16x4_t lo = vqmovn_u32(vcvtq_u32_f32(values[0]));
+    const uint16x4_t hi = vqmovn_u32(vcvtq_u32_f32(values[1]));
+    return vqmovn_u16(vcombine_u16(lo, hi));
+}
+#endif
+
+const char* EffectKernels::instructionSet() {
+#if defined(EFFECTKERNELS_AVX2)
+    if(gAvx2) return "AVX2";
+#endif
+#if defined(EFFECTKERNELS_SSE2)
+    return "SSE2";
+#elif defined(EFFECTKERNELS_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+void EffectKernels::brightnessContrast(const uint8_t* src, uint8_t* dst,
+                                       const int count,
+                                       const float brightness,
+                                       const float contrast) {
+    const float k = contrast + 1;
+    const float d = 0.5f + brightness - 0.5f*k;
+    int i = 0;
+#if defined(EFFECTKERNELS_AVX2)
+    if(gAvx2) i = brightnessContrastAvx2(src, dst, count, k, d);
+#endif
+#if defined(EFFECTKERNELS_SSE2)
+    const __m128 kV = _mm_set1_ps(k);
+    const __m128 dV = _mm_set1_ps(d);
+    for(; i + 4 <= count; i += 4) {
+        __m128 ch[4];
+        loadSse2(src + 4*i, ch);
+        const __m128 ad = _mm_mul_ps(ch[3], dV);
+        for(int c = 0; c < 3; c++) {
+            ch[c] = _mm_add_ps(_mm_mul_ps(ch[c], kV), ad);
+        }
+        storeSse2(dst + 4*i, ch);
+    }
+#elif defined(EFFECTKERNELS_NEON)
+    for(; i + 8 <= count; i += 8) {
+        uint8x8x4_t px = vld4_u8(src + 4*i);
+        float32x4_t a[2];
+        loadNeon(px.val[3], a);
+        for(int c = 0; c < 3; c++) {
+            float32x4_t v[2];
+            loadNeon(px.val[c], v);
+            for(int h = 0; h < 2; h++) {
+                v[h] = vmlaq_n_f32(vmulq_n_f32(a[h], d), v[h], k);
+            }
+            px.val[c] = storeNeon(v);
+        }
+        vst4_u8(dst + 4*i, px);
+    }
+#endif
+    brightnessContrastScalar(src + 4*i, dst + 4*i, count - i, k, d);
+}
+
+void EffectKernels::colorize(const uint8_t* src, uint8_t* dst,
+                             const int count, const float rgbHalf[3],
+                             const float lightness, const float influence) {
+    int i = 0;
+#if defined(EFFECTKERNELS_AVX2)
+    if(gAvx2) i = colorizeAvx2(src, dst, count, rgbHalf, lightness, influence);
+#endif
+#if defined(EFFECTKERNELS_SSE2)
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.f);
+    const __m128 two = _mm_set1_ps(2.f);
+    const __m128 halfV = _mm_set1_ps(0.5f);
+    const __m128 lightV = _mm_set1_ps(lightness);
+    const __m128 inflV = _mm_set1_ps(influence);
+    const __m128 keepV = _mm_set1_ps(1 - influence);
+    for(; i + 4 <= count; i += 4) {
+        __m128 ch[4];
+        loadSse2(src + 4*i, ch);
+        const __m128 a = ch[3];
+        const __m128 mx = _mm_min_ps(_mm_max_ps(_mm_max_ps(ch[0], ch[1]),
+                                                ch[2]), a);
+        const __m128 mn = _mm_min_ps(_mm_min_ps(_mm_min_ps(ch[0], ch[1]),
+                                                ch[2]), a);
+        __m128 l = _mm_div_ps(_mm_mul_ps(_mm_add_ps(mx, mn), halfV),
+                              _mm_max_ps(a, one));
+        l = _mm_min_ps(one, _mm_max_ps(zero, _mm_add_ps(l, lightV)));
+        const __m128 l2 = _mm_mul_ps(l, two);
+        const __m128 lo = _mm_min_ps(l2, one);
+        const __m128 hi = _mm_max_ps(_mm_sub_ps(l2, one), zero);
+        const __m128 aInfl = _mm_mul_ps(a, inflV);
+        const __m128 valid = _mm_cmpgt_ps(a, zero);
+        for(int c = 0; c < 3; c++) {
+            const __m128 color = _mm_add_ps(
+                        _mm_mul_ps(_mm_set1_ps(rgbHalf[c]), lo),
+                        _mm_mul_ps(_mm_set1_ps(1 - rgbHalf[c]), hi));
+            const __m128 value = _mm_add_ps(_mm_mul_ps(color, aInfl),
+                                            _mm_mul_ps(ch[c], keepV));
+            ch[c] = _mm_and_ps(value, valid);
+        }
+        storeSse2(dst + 4*i, ch);
+    }
+#elif defined(EFFECTKERNELS_NEON)
+    const float32x4_t zero = vdupq_n_f32(0.f);
+    const float32x4_t one = vdupq_n_f32(1.f);
+    for(; i + 8 <= count; i += 8) {
+        uint8x8x4_t px = vld4_u8(src + 4*i);
+        const uint8x8_t mx = vmin_u8(vmax_u8(vmax_u8(px.val[0], px.val[1]),
+                                             px.val[2]), px.val[3]);
+        const uint8x8_t mn = vmin_u8(vmin_u8(vmin_u8(px.val[0], px.val[1]),
+                                             px.val[2]), px.val[3]);
+        const uint8x8_t valid = vtst_u8(px.val[3], px.val[3]);
+        float32x4_t a[2], mxF[2], mnF[2];
+        loadNeon(px.val[3], a);
+        loadNeon(mx, mxF);
+        loadNeon(mn, mnF);
+        float32x4_t lo[2], hi[2], aInfl[2];
+        for(int h = 0; h < 2; h++) {
+            const float32x4_t div = vmaxq_f32(a[h], one);
+            float32x4_t inv = vrecpeq_f32(div);
+            inv = vmulq_f32(vrecpsq_f32(div, inv), inv);
+            inv = vmulq_f32(vrecpsq_f32(div, inv), inv);
+            float32x4_t l = vmulq_f32(vmulq_n_f32(vaddq_f32(mxF[h], mnF[h]),
+                                                  0.5f), inv);
+            l = vminq_f32(one, vmaxq_f32(zero, vaddq_f32(l, vdupq_n_f32(lightness))));
+            const float32x4_t l2 = vaddq_f32(l, l);
+            lo[h] = vminq_f32(l2, one);
+            hi[h] = vmaxq_f32(vsubq_f32(l2, one), zero);
+            aInfl[h] = vmulq_n_f32(a[h], influence);
+        }
+        for(int c = 0; c < 3; c++) {
+            float32x4_t v[2];
+            loadNeon(px.val[c], v);
+            for(int h = 0; h < 2; h++) {
+                const float32x4_t color = vmlaq_n_f32(
+                            vmulq_n_f32(lo[h], rgbHalf[c]), hi[h], 1 - rgbHalf[c]);
+                v[h] = vmlaq_f32(vmulq_n_f32(v[h], 1 - influence), color, aInfl[h]);
+            }
+            px.val[c] = vand_u8(storeNeon(v), valid);
+        }
+        vst4_u8(dst + 4*i, px);
+    }
+#endif
+    colorizeScalar(src + 4*i, dst + 4*i, count - i,
+                   rgbHalf, lightness, influence);
+}
+
+void EffectKernels::scale(const uint8_t* src, uint8_t* dst,
+                          const float* factors, const int count) {
+    int i = 0;
+#if defined(EFFECTKERNELS_AVX2)
+    if(gAvx2) i = scaleAvx2(src, dst, factors, count);
+#endif
+#if defined(EFFECTKERNELS_SSE2)
+    for(; i + 4 <= count; i += 4) {
+        __m128 ch[4];
+        loadSse2(src + 4*i, ch);
+        const __m128 f = _mm_loadu_ps(factors + i);
+        for(int c = 0; c < 4; c++) ch[c] = _mm_mul_ps(ch[c], f);
+        storeSse2(dst + 4*i, ch);
+    }
+#elif defined(EFFECTKERNELS_NEON)
+    for(; i + 8 <= count; i += 8) {
+        uint8x8x4_t px = vld4_u8(src + 4*i);
+        const float32x4_t f[2] = {vld1q_f32(factors + i),
+                                  vld1q_f32(factors + i + 4)};
+        for(int c = 0; c < 4; c++) {
+            float32x4_t v[2];
+            loadNeon(px.val[c], v);
+            for(int h = 0; h < 2; h++) v[h] = vmulq_f32(v[h], f[h]);
+            px.val[c] = storeNeon(v);
+        }
+        vst4_u8(dst + 4*i, px);
+    }
+#endif
+    scaleScalar(src + 4*i, dst + 4*i, factors + i, count - i);
+}
@@ -0,0 +1,58 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef EFFECTKERNELS_H
+#define EFFECTKERNELS_H
+
+#include "../core_global.h"
+
+#include <cstdint>
+
+// Row kernels of the point-wise CPU raster effects, working on
+// premultiplied 8 bit RGBA (byte order R, G, B, A). Results are truncated
+// like the per-pixel double code they replace and match it within 1.
+// AVX2 is picked at runtime on x86, SSE2/NEON otherwise when available.
+namespace EffectKernels {
+    //! @brief Vector instruction set selected at runtime
+    CORE_EXPORT
+    const char* instructionSet();
+
+    //! @brief c' = (c - a/2)*(contrast + 1) + a*(brightness + 1/2)
+    CORE_EXPORT
+    void brightnessContrast(const uint8_t* src, uint8_t* dst, const int count,
+                            const float brightness, const float contrast);
+
+    //! @brief Replaces hue and saturation keeping the HSL lightness
+    //! @param rgbHalf target hue/saturation color at lightness 0.5
+    CORE_EXPORT
+    void colorize(const uint8_t* src, uint8_t* dst, const int count,
+                  const float rgbHalf[3], const float lightness,
+                  const float influence);
+
+    //! @brief Multiplies each pixel by the matching factor
+    CORE_EXPORT
+    void scale(const uint8_t* src, uint8_t* dst,
+               const float* factors, const int count);
+}
+
+#endif // EFFECTKERNELS_H
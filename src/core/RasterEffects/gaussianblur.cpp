@@ -0,0 +1,242 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "gaussianblur.h"
+
+#include "skia/skiaincludes.h"
+#include "Tasks/paralleljobs.h"
+
+#include <QThread>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#define BOX_PASSES 3
+// below this the boxes are too coarse, a sampled kernel is used instead
+#define MIN_BOX_SIGMA 3.f
+#define ROWS_PER_JOB 32
+#define COLUMNS_PER_JOB 32
+
+// radii of the box blurs whose succession approximates the gaussian
+static void boxRadii(const float sigma, int radii[BOX_PASSES]) {
+    const int n = BOX_PASSES;
+    const float wIdeal = std::sqrt(12*sigma*sigma/n + 1);
+    int wl = static_cast<int>(std::floor(wIdeal));
+    if(wl % 2 == 0) wl--;
+    const int wu = wl + 2;
+    const float mIdeal = (12*sigma*sigma - n*wl*wl - 4*n*wl - 3*n)/(-4*wl - 4);
+    const int m = static_cast<int>(std::round(mIdeal));
+    for(int i = 0; i < n; i++) radii[i] = ((i < m ? wl : wu) - 1)/2;
+}
+
+template <int C>
+static void boxRow(const uint8_t* src, uint8_t* dst,
+                   const int length, const int r) {
+    const float scale = 1.f/(2*r + 1);
+    float sum[C] = {};
+    for(int i = 0; i <= r && i < length; i++) {
+        for(int c = 0; c < C; c++) sum[c] += src[C*i + c];
+    }
+    for(int i = 0; i < length; i++) {
+        for(int c = 0; c < C; c++) {
+            dst[C*i + c] = static_cast<uint8_t>(sum[c]*scale + 0.5f);
+        }
+        const int add = i + r + 1;
+        const int sub = i - r;
+        if(add < length) {
+            for(int c = 0; c < C; c++) sum[c] += src[C*add + c];
+        }
+        if(sub >= 0) {
+            for(int c = 0; c < C; c++) sum[c] -= src[C*sub + c];
+        }
+    }
+}
+
+// vertical pass over a strip of columns, walking the rows in order
+static void boxColumns(const uint8_t* src, const size_t srcStride,
+                       uint8_t* dst, const size_t dstStride,
+                       const int rowBytes, const int height,
+                       const int r, float* const sums) {
+    const float scale = 1.f/(2*r + 1);
+    std::fill(sums, sums + rowBytes, 0.f);
+    for(int y = 0; y <= r && y < height; y++) {
+        const uint8_t* const row = src + y*srcStride;
+        for(int i = 0; i < rowBytes; i++) sums[i] += row[i];
+    }
+    for(int y = 0; y < height; y++) {
+        uint8_t* const out = dst + y*dstStride;
+        for(int i = 0; i < rowBytes; i++) {
+            out[i] = static_cast<uint8_t>(sums[i]*scale + 0.5f);
+        }
+        const int add = y + r + 1;
+        const int sub = y - r;
+        if(add < height) {
+            const uint8_t* const row = src + add*srcStride;
+            for(int i = 0; i < rowBytes; i++) sums[i] += row[i];
+        }
+        if(sub >= 0) {
+            const uint8_t* const row = src + sub*srcStride;
+            for(int i = 0; i < rowBytes; i++) sums[i] -= row[i];
+        }
+    }
+}
+
+template <int C>
+static void kernelRow(const uint8_t* src, uint8_t* dst, const int length,
+                      const std::vector<float>& kernel) {
+    const int k = static_cast<int>(kernel.size())/2;
+    for(int i = 0; i < length; i++) {
+        const int jMin = std::max(-k, -i);
+        const int jMax = std::min(k, length - 1 - i);
+        float sum[C] = {};
+        for(int j = jMin; j <= jMax; j++) {
+            const float w = kernel[j + k];
+            for(int c = 0; c < C; c++) sum[c] += w*src[C*(i + j) + c];
+        }
+        for(int c = 0; c < C; c++) {
+            dst[C*i + c] = static_cast<uint8_t>(std::min(255.f, sum[c] + 0.5f));
+        }
+    }
+}
+
+static void kernelColumns(const uint8_t* src, const size_t srcStride,
+                          uint8_t* dst, const size_t dstStride,
+                          const int rowBytes, const int height,
+                          const std::vector<float>& kernel,
+                          float* const sums) {
+    const int k = static_cast<int>(kernel.size())/2;
+    for(int y = 0; y < height; y++) {
+        std::fill(sums, sums + rowBytes, 0.f);
+        const int jMin = std::max(-k, -y);
+        const int jMax = std::min(k, height - 1 - y);
+        for(int j = jMin; j <= jMax; j++) {
+            const float w = kernel[j + k];
+            const uint8_t* const row = src + (y + j)*srcStride;
+            for(int i = 0; i < rowBytes; i++) sums[i] += w*row[i];
+        }
+        uint8_t* const out = dst + y*dstStride;
+        for(int i = 0; i < rowBytes; i++) {
+            out[i] = static_cast<uint8_t>(std::min(255.f, sums[i] + 0.5f));
+        }
+    }
+}
+
+static std::vector<float> gaussianKernel(const float sigma) {
+    const int k = static_cast<int>(std::ceil(3*sigma));
+    std::vector<float> kernel(2*k + 1);
+    float sum = 0;
+    for(int i = -k; i <= k; i++) {
+        const float w = std::exp(-0.5f*i*i/(sigma*sigma));
+        kernel[i + k] = w;
+        sum += w;
+    }
+    for(auto& w : kernel) w /= sum;
+    return kernel;
+}
+
+// either radii (box passes) or kernel (single pass) is used
+template <int C>
+static void blurImpl(const SkBitmap& src, SkBitmap& dst,
+                     const int radii[BOX_PASSES],
+                     const std::vector<float>& kernel) {
+    const int width = src.width();
+    const int height = src.height();
+    const int nThreads = QThread::idealThreadCount();
+
+    const auto srcPixels = static_cast<const uint8_t*>(src.getPixels());
+    const size_t srcStride = src.rowBytes();
+    const auto dstPixels = static_cast<uint8_t*>(dst.getPixels());
+    const size_t dstStride = dst.rowBytes();
+
+    const int rowJobs = (height + ROWS_PER_JOB - 1)/ROWS_PER_JOB;
+    ParallelJobs::sRun(rowJobs, nThreads, [&](const int id) {
+        std::vector<uint8_t> a(C*width);
+        std::vector<uint8_t> b(kernel.empty() ? C*width : 0);
+        const int yMax = std::min(height, (id + 1)*ROWS_PER_JOB);
+        for(int y = id*ROWS_PER_JOB; y < yMax; y++) {
+            const auto srcRow = srcPixels + y*srcStride;
+            const auto dstRow = dstPixels + y*dstStride;
+            if(kernel.empty()) {
+                boxRow<C>(srcRow, a.data(), width, radii[0]);
+                boxRow<C>(a.data(), b.data(), width, radii[1]);
+                boxRow<C>(b.data(), dstRow, width, radii[2]);
+            } else {
+                kernelRow<C>(srcRow, a.data(), width, kernel);
+                std::copy(a.begin(), a.end(), dstRow);
+            }
+        }
+    });
+
+    const int columnJobs = (width + COLUMNS_PER_JOB - 1)/COLUMNS_PER_JOB;
+    ParallelJobs::sRun(columnJobs, nThreads, [&](const int id) {
+        const int x = id*COLUMNS_PER_JOB;
+        const int rowBytes = C*(std::min(width, x + COLUMNS_PER_JOB) - x);
+        std::vector<uint8_t> a(rowBytes*height);
+        std::vector<uint8_t> b(kernel.empty() ? rowBytes*height : 0);
+        std::vector<float> sums(rowBytes);
+        uint8_t* const strip = dstPixels + C*x;
+        if(kernel.empty()) {
+            boxColumns(strip, dstStride, a.data(), rowBytes,
+                       rowBytes, height, radii[0], sums.data());
+            boxColumns(a.data(), rowBytes, b.data(), rowBytes,
+                       rowBytes, height, radii[1], sums.data());
+            boxColumns(b.data(), rowBytes, strip, dstStride,
+                       rowBytes, height, radii[2], sums.data());
+        } else {
+            kernelColumns(strip, dstStride, a.data(), rowBytes,
+                          rowBytes, height, kernel, sums.data());
+            for(int y = 0; y < height; y++) {
+                std::copy_n(a.data() + y*rowBytes, rowBytes,
+                            strip + y*dstStride);
+            }
+        }
+    });
+}
+
+void GaussianBlur::blur(const SkBitmap& src, SkBitmap& dst,
+                        const float sigma) {
+    Q_ASSERT(src.dimensions() == dst.dimensions());
+    Q_ASSERT(src.colorType() == dst.colorType());
+    if(src.empty() || !src.getPixels() || !dst.getPixels()) return;
+
+    if(!(sigma > 0.1f)) {
+        if(&src != &dst) src.readPixels(dst.pixmap());
+        return;
+    }
+
+    int radii[BOX_PASSES] = {};
+    std::vector<float> kernel;
+    if(sigma < MIN_BOX_SIGMA) kernel = gaussianKernel(sigma);
+    else boxRadii(sigma, radii);
+
+    switch(src.bytesPerPixel()) {
+    case 4:
+        blurImpl<4>(src, dst, radii, kernel);
+        break;
+    case 1:
+        blurImpl<1>(src, dst, radii, kernel);
+        break;
+    default:
+        Q_ASSERT(false);
+    }
+}
@@ -0,0 +1,42 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef GAUSSIANBLUR_H
+#define GAUSSIANBLUR_H
+
+#include "../core_global.h"
+
+class SkBitmap;
+
+// Gaussian blur approximated with three box blurs. Every box pass keeps
+// a running sum, so the cost does not depend on the radius. Rows and
+// then columns of the whole image are split across the CPU task threads.
+// Pixels outside of the image are transparent, like in SkImageFilters::Blur.
+namespace GaussianBlur {
+    //! @brief Blurs 8 bit RGBA or alpha only src into dst,
+    //! both of the same size and color type, dst can be src
+    CORE_EXPORT
+    void blur(const SkBitmap& src, SkBitmap& dst, const float sigma);
+}
+
+#endif // GAUSSIANBLUR_H
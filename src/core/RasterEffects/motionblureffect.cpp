@@ -30,6 +30,8 @@
 #include "Boxes/boundingbox.h"
 #include "appsupport.h"
 
+#include <array>
+
 class MotionBlurCaller : public RasterEffectCaller {
     e_OBJECT
     friend class StdSelfRef;
@@ -105,7 +107,6 @@ private:
 stdsptr<RasterEffectCaller> MotionBlurEffect::getEffectCaller(
             const qreal relFrame, const qreal resolution,
             const qreal influence, BoxRenderData * const data) const {
-    Q_UNUSED(resolution)
     if(mBlocked) return nullptr;
     const MotionBlurEffectBlock block(mBlocked);
     const auto idRange = mParentBox->prp_getIdenticalRelRange(relFrame);
@@ -116,24 +117,41 @@ stdsptr<RasterEffectCaller> MotionBlurEffect::getEffectCaller(
 
     const int nSamples = qCeil(sampleCount);
     if(nSamples == 0) return nullptr;
+    const auto stateIds = mParentBox->inheritedStateIds();
+    if(stateIds != mSamplesStateIds) {
+        mSamples.clear();
+        mSamplesStateIds = stateIds;
+    }
     qreal sampleRelFrame = relFrame - nSamples*frameStep;
     QList<stdsptr<BoxRenderData>> samples;
+    QMap<int, stdsptr<BoxRenderData>> usedSamples;
     for(int i = 0; i < nSamples; i++) {
         if(!idRange.inRange(sampleRelFrame)) {
-            const auto sample = mParentBox->queExternalRender(sampleRelFrame, true);
+            const int key = qRound(sampleRelFrame*1000);
+            auto sample = mSamples.value(key);
+            if(sample && (sample->getState() == eTaskState::canceled ||
+                          sample->waitingToCancel() ||
+                          !isZero4Dec(sample->fResolution - resolution))) {
+                sample.reset();
+            }
+            if(!sample) {
+                sample = mParentBox->queExternalRender(sampleRelFrame, true);
+            }
             if(sample) {
                 if(sample->finished()) {
                     data->fOtherGlobalRects << sample->fGlobalRect;
                 } else {
-                    sample->fMotionBlurTarget = data;
+                    sample->fMotionBlurTargets << data;
                     sample->addDependent(data);
                 }
                 samples << sample;
+                usedSamples.insert(key, sample);
             }
         }
 
         sampleRelFrame += frameStep;
     }
+    mSamples = usedSamples;
     if(samples.isEmpty()) return nullptr;
     return enve::make_shared<MotionBlurCaller>(
                 instanceHwSupport(), sampleCount, opacity, samples);
@@ -173,37 +191,28 @@ void replaceIfHigherAlpha(const int x0, const int y0,
                           const SkPixmap &dst,
                           const SkPixmap &src,
                           const qreal alpha) {
-    uint8_t *dstD = static_cast<uint8_t*>(dst.writable_addr());
-    const uint8_t *srcD = static_cast<const uint8_t*>(src.addr());
-    const int dstRowWidth = dst.rowBytesAsPixels();
-    const int srcRowWidth = src.rowBytesAsPixels();
-
-    int dstId = (y0 * dstRowWidth + x0)*4;
-    int srcId = 0;
+    static const auto sInverse = []() {
+        std::array<float, 256> inverse;
+        inverse[0] = 0;
+        for(int i = 1; i < 256; i++) inverse[i] = 1.f/i;
+        return inverse;
+    }();
+    const float fAlpha = static_cast<float>(alpha);
     const int yMax = qMin(src.height(), dst.height() - y0);
     const int xMax = qMin(src.width(), dst.width() - x0);
-    const int iDstYInc = qMax(0, dstRowWidth - xMax)*4;
-    const int iSrcYInc = qMax(0, srcRowWidth - xMax)*4;
     for(int y = 0; y < yMax; y++) {
-        for(int x = 0; x < xMax; x++) {
-            const int maxSrcId = srcRowWidth*src.height()*4;
-            Q_ASSERT(srcId + 3 < maxSrcId);
-            const int maxDstId = dstRowWidth*dst.height()*4;
-            Q_ASSERT(dstId + 3 < maxDstId);
-            uchar& dstAlpha = dstD[dstId + 3];
-            const uchar srcAlpha = static_cast<uchar>(qRound(srcD[srcId + 3]*alpha));
-            if(srcAlpha > dstAlpha) {
-                const qreal m2 = alpha*(1 - qreal(dstAlpha)/srcAlpha);
-                dstD[dstId] += static_cast<uint8_t>(qRound(srcD[srcId]*m2));
-                dstD[dstId + 1] += static_cast<uint8_t>(qRound(srcD[srcId + 1]*m2));
-                dstD[dstId + 2] += static_cast<uint8_t>(qRound(srcD[srcId + 2]*m2));
-                dstAlpha += static_cast<uint8_t>(qRound(srcD[srcId + 3]*m2));
-            }
-            dstId += 4;
-            srcId += 4;
+        const auto srcD = static_cast<const uint8_t*>(src.addr(0, y));
+        const auto dstD = static_cast<uint8_t*>(dst.writable_addr(x0, y0 + y));
+        for(int i = 0; i < 4*xMax; i += 4) {
+            const uint8_t dstAlpha = dstD[i + 3];
+            const uint8_t srcAlpha = static_cast<uint8_t>(srcD[i + 3]*fAlpha + 0.5f);
+            if(srcAlpha <= dstAlpha) continue;
+            const float m2 = fAlpha*(1 - dstAlpha*sInverse[srcAlpha]);
+            dstD[i] += static_cast<uint8_t>(srcD[i]*m2 + 0.5f);
+            dstD[i + 1] += static_cast<uint8_t>(srcD[i + 1]*m2 + 0.5f);
+            dstD[i + 2] += static_cast<uint8_t>(srcD[i + 2]*m2 + 0.5f);
+            dstD[i + 3] += static_cast<uint8_t>(srcD[i + 3]*m2 + 0.5f);
         }
-        dstId += iDstYInc;
-        srcId += iSrcYInc;
     }
 }
 
@@ -43,6 +43,9 @@ private:
     FrameRange getMotionBlurPropsIdenticalRange(const int relFrame) const;
 
     mutable bool mBlocked = false;
+    // sub-frame samples of the last frame, shared with the next one
+    mutable QVector<uint> mSamplesStateIds;
+    mutable QMap<int, stdsptr<BoxRenderData>> mSamples;
     qptr<BoundingBox> mParentBox;
     qsptr<QrealAnimator> mOpacity;
     qsptr<QrealAnimator> mNumberSamples;
@@ -26,11 +26,14 @@
 #include "noisefadeeffect.h"
 #include "gpurendertools.h"
 #include "openglrastereffectcaller.h"
+#include "effectkernels.h"
 
 #include "Animators/qrealanimator.h"
 
 #include "appsupport.h"
 
+#include <vector>
+
 NoiseFadeEffect::NoiseFadeEffect() :
     RasterEffect("noise fade",
                  AppSupport::getRasterEffectHardwareSupport("NoiseFade",
@@ -68,6 +71,8 @@ public:
 
     void processCpu(CpuRenderTools& renderTools,
                     const CpuRenderData& data);
+
+    bool pointWise() const { return true; }
 protected:
     void iniVars(QGL33 * const gl) const {
         sSeedU = gl->glGetUniformLocation(sProgramId, "seed");
@@ -83,9 +88,9 @@ protected:
         gl->glUniform1f(sTimeU, mTime);
     }
 private:
-    qreal r(const QPointF& p) const;
-    qreal n(const QPointF& p) const;
-    qreal noise(const QPointF& p) const;
+    qreal r(const qreal x, const qreal y) const;
+    void noiseRow(const int xMin, const int count, const qreal width,
+                  const qreal y, float* const values) const;
 
     static bool sInitialized;
     static GLuint sProgramId;
@@ -131,18 +136,6 @@ qreal GLSL_smoothstep(const qreal edge0,
     return t * t * (3.0 - 2.0 * t);
 }
 
-QPointF GLSL_smoothstep(const QPointF& edge0,
-                        const QPointF& edge1,
-                        const QPointF& x) {
-    const qreal rx = GLSL_smoothstep(edge0.x(), edge1.x(), x.x());
-    const qreal ry = GLSL_smoothstep(edge0.y(), edge1.y(), x.y());
-    return {rx, ry};
-}
-
-QPointF GLSL_floor(const QPointF& p) {
-    return {floor(p.x()), floor(p.y())};
-}
-
 qreal GLSL_mix(const qreal x, const qreal y, const qreal a) {
     return x*(1 - a) + y*a;
 }
@@ -151,36 +144,46 @@ qreal GLSL_fract(const qreal x) {
     return x - floor(x);
 }
 
-QPointF GLSL_fract(const QPointF& p) {
-    return p - GLSL_floor(p);
+qreal NoiseFadeEffectCaller::r(const qreal x, const qreal y) const {
+    return GLSL_fract(cos((x + 0.00001*mSeed)*42.98 +
+                          (y + 0.00001*mSeed)*43.23) * 1127.53);
 }
 
-qreal NoiseFadeEffectCaller::r(const QPointF& p) const {
-    return GLSL_fract(cos((p.x() + 0.00001*mSeed)*42.98 +
-                          (p.y() + 0.00001*mSeed)*43.23) * 1127.53);
-}
+// Sum of the value noise octaves for the points {xi/width, y}*.4 of a row.
+// The lattice values only change when a point enters a new cell,
+// so they are evaluated once per cell instead of once per pixel.
+void NoiseFadeEffectCaller::noiseRow(const int xMin, const int count,
+                                     const qreal width, const qreal y,
+                                     float* const values) const {
+    static const qreal sScales[] = {32., 16., 8., 4., 2., 1.};
+    static const qreal sWeights[] = {0.58, 0.2, 0.1, 0.05, 0.02, 0.0125};
 
-qreal NoiseFadeEffectCaller::n(const QPointF& p) const {
-    const QPointF fn = GLSL_floor(p);
-    const QPointF sn = GLSL_smoothstep(QPointF{0. ,0.},
-                                       QPointF{1., 1.},
-                                       GLSL_fract(p));
-
-    const qreal h1 = GLSL_mix(r(fn),
-                              r(fn + QPointF{1., 0.}), sn.x());
-    const qreal h2 = GLSL_mix(r(fn + QPointF{0., 1.}),
-                              r(fn + QPointF{1., 1.}), sn.x());
-    return GLSL_mix(h1 ,h2, sn.y());
-}
-
-qreal NoiseFadeEffectCaller::noise(const QPointF& p) const {
+    std::fill(values, values + count, 0.f);
     const qreal s = mSize*0.001;
-    return 0.58 * n(p/(32.*s)) +
-           0.2 * n(p/(16.*s)) +
-           0.1 * n(p/(8.*s)) +
-           0.05 * n(p/(4.*s)) +
-           0.02 * n(p/(2.*s)) +
-           0.0125 * n(p/s);
+    for(int o = 0; o < 6; o++) {
+        const qreal scale = sScales[o]*s;
+        const qreal py = y/scale;
+        const qreal fy = floor(py);
+        const qreal sy = GLSL_smoothstep(0., 1., py - fy);
+
+        bool first = true;
+        qreal cell = 0;
+        qreal v0 = 0;
+        qreal v1 = 0;
+        for(int i = 0; i < count; i++) {
+            const qreal px = (xMin + i)/width*.4/scale;
+            const qreal fx = floor(px);
+            if(first || fx != cell) {
+                if(!first && fx == cell + 1) v0 = v1;
+                else v0 = GLSL_mix(r(fx, fy), r(fx, fy + 1), sy);
+                v1 = GLSL_mix(r(fx + 1, fy), r(fx + 1, fy + 1), sy);
+                cell = fx;
+                first = false;
+            }
+            const qreal sx = GLSL_smoothstep(0., 1., px - fx);
+            values[i] += sWeights[o]*GLSL_mix(v0, v1, sx);
+        }
+    }
 }
 
 void NoiseFadeEffectCaller::processCpu(CpuRenderTools& renderTools,
@@ -199,25 +202,24 @@ void NoiseFadeEffectCaller::processCpu(CpuRenderTools& renderTools,
     const qreal imgHeight = renderTools.fSrcBtmp.height();
 
     const int xMin = std::max(0, data.fTexTile.left());
-    const int xMax = std::min((int)data.fTexTile.right(), (int)imgWidth - 1);
+    const int xMax = std::min((int)data.fTexTile.right() - 1, (int)imgWidth - 1);
     const int yMin = std::max(0, data.fTexTile.top());
-    const int yMax = std::min((int)data.fTexTile.bottom(), (int)imgHeight - 1);
+    const int yMax = std::min((int)data.fTexTile.bottom() - 1, (int)imgHeight - 1);
 
     const qreal t = abs(sin(0.5*PI*mTime));
     const qreal b = 0.25*(0.75 - 0.749*mSharpness);
 
+    const int count = xMax - xMin + 1;
+    if(count <= 0) return;
+    std::vector<float> factors(count);
+
     for(int yi = yMin; yi <= yMax; yi++) {
-        auto dst = static_cast<uchar*>(renderTools.fDstBtmp.getAddr(0, yi - yMin));
-        auto src = static_cast<uchar*>(renderTools.fSrcBtmp.getAddr(xMin, yi));
-        for(int xi = xMin; xi <= xMax; xi++) {
-            const qreal x = xi/imgWidth;
-            const qreal y = yi/imgHeight;
+        const auto dst = static_cast<uchar*>(dstBtmp.getAddr(0, yi - yMin));
+        const auto src = static_cast<const uchar*>(srcBtmp.getAddr(xMin, yi));
 
-            const qreal c = GLSL_smoothstep(t + b, t - b, noise(QPointF{x, y} * .4));
+        noiseRow(xMin, count, imgWidth, yi/imgHeight*.4, factors.data());
+        for(auto& f : factors) f = 1 - GLSL_smoothstep(t + b, t - b, f);
 
-            for(int i = 0; i < 4; i++) {
-                *dst++ = *src++ * (1 - c);
-            }
-        }
+        EffectKernels::scale(src, dst, factors.data(), count);
     }
 }
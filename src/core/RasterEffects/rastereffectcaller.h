@@ -26,6 +26,7 @@
 #ifndef RASTEREFFECTCALLER_H
 #define RASTEREFFECTCALLER_H
 #include "../smartPointers/stdselfref.h"
+#include "../smartPointers/ememorypool.h"
 #include "../glhelpers.h"
 #include "../gpurendertools.h"
 #include "../cpurendertools.h"
@@ -35,6 +36,7 @@ enum class HardwareSupport : short;
 
 class CORE_EXPORT RasterEffectCaller : public StdSelfRef {
     e_OBJECT
+    e_POOLED_ALLOCATOR(eMemoryPool::sEffectCallers())
 public:
     RasterEffectCaller(const HardwareSupport hwSupport,
                        const bool forceMargin = false,
@@ -56,6 +58,10 @@ public:
 
     virtual bool srcDstSeparation() const { return true; }
 
+    // each pixel depends only on the matching source pixel, allowing
+    // processCpu to run in place and to be fused with its neighbours
+    virtual bool pointWise() const { return false; }
+
     HardwareSupport hardwareSupport() const {
         return fHwSupport;
     }
@@ -1,4 +1,5 @@
 #include "shadoweffect.h"
+#include "gaussianblur.h"
 
 #include "Boxes/containerbox.h"
 #include "svgexporter.h"
@@ -23,7 +24,15 @@ public:
                     GpuRenderTools& renderTools);
     void processCpu(CpuRenderTools& renderTools,
                     const CpuRenderData &data);
+
+    // GaussianBlur splits the whole image across the threads itself
+    int cpuThreads(const int available, const int area) const {
+        Q_UNUSED(available)
+        Q_UNUSED(area)
+        return 1;
+    }
 private:
+    SkColor shadowColor() const;
     void setupPaint(SkPaint& paint) const;
 
     const float mRadius;
@@ -128,18 +137,20 @@ ShadowEffect::getEffectCaller(const qreal relFrame,
                 QMargins(iL, iT, iR, iB));
 }
 
+SkColor ShadowEffectCaller::shadowColor() const
+{
+    const uint8_t alpha = static_cast<uint8_t>(SkColorGetA(mColor) * mOpacity);
+    return SkColorSetARGB(alpha,
+                          SkColorGetR(mColor),
+                          SkColorGetG(mColor),
+                          SkColorGetB(mColor));
+}
+
 void ShadowEffectCaller::setupPaint(SkPaint &paint) const
 {
     const float sigma = mRadius * 0.3333333f;
     paint.setImageFilter(SkImageFilters::Blur(sigma, sigma, nullptr));
-
-    const uint8_t alpha = static_cast<uint8_t>(SkColorGetA(mColor) * mOpacity);
-    const SkColor shadowColor = SkColorSetARGB(alpha,
-                                               SkColorGetR(mColor),
-                                               SkColorGetG(mColor),
-                                               SkColorGetB(mColor));
-
-    paint.setColorFilter(SkColorFilters::Blend(shadowColor, SkBlendMode::kSrcIn));
+    paint.setColorFilter(SkColorFilters::Blend(shadowColor(), SkBlendMode::kSrcIn));
 }
 
 void ShadowEffectCaller::processGpu(QGL33 * const gl,
@@ -174,39 +185,22 @@ void ShadowEffectCaller::processCpu(CpuRenderTools &renderTools,
         return;
     }
 
+    // the shadow color is applied with src-in,
+    // so only the alpha channel has to be blurred
+    SkBitmap shadow;
+    if (!shadow.tryAllocPixels(SkImageInfo::MakeA8(srcBtmp.width(),
+                                                   srcBtmp.height())) ||
+        !srcBtmp.readPixels(shadow.pixmap())) {
+        return;
+    }
+    GaussianBlur::blur(shadow, shadow, mRadius * 0.3333333f);
+
     SkCanvas canvas(dstBtmp);
     canvas.clear(SK_ColorTRANSPARENT);
 
-    const int radCeil = static_cast<int>(ceil(mRadius));
-    const auto& texTile = data.fTexTile;
-
-    const int ceilDX = static_cast<int>(ceil(abs(mTranslation.x())));
-    const int ceilDY = static_cast<int>(ceil(abs(mTranslation.y())));
-    auto srcRect = texTile.makeOutset(radCeil + ceilDX, radCeil + ceilDY);
-
-    if (srcRect.intersect(srcRect, srcBtmp.bounds())) {
-
-        SkBitmap packedTile;
-        packedTile.allocPixels(srcBtmp.info().makeWH(srcRect.width(),
-                                                     srcRect.height()));
-
-        if (srcBtmp.readPixels(packedTile.info(),
-                               packedTile.getPixels(),
-                               packedTile.rowBytes(),
-                               srcRect.left(),
-                               srcRect.top())) {
-
-            const int drawX = srcRect.left() - texTile.left();
-            const int drawY = srcRect.top() - texTile.top();
-
-            SkPaint paint;
-            setupPaint(paint);
-
-            canvas.drawBitmap(packedTile,
-                              mTranslation.x() + drawX,
-                              mTranslation.y() + drawY,
-                              &paint);
-            canvas.drawBitmap(packedTile, drawX, drawY);
-        }
-    }
+    // alpha only bitmaps are drawn in the paint color
+    SkPaint paint;
+    paint.setColor(shadowColor());
+    canvas.drawBitmap(shadow, mTranslation.x(), mTranslation.y(), &paint);
+    canvas.drawBitmap(srcBtmp, 0, 0);
 }
@@ -26,11 +26,14 @@
 #include "wipeeffect.h"
 #include "gpurendertools.h"
 #include "openglrastereffectcaller.h"
+#include "effectkernels.h"
 
 #include "Animators/qrealanimator.h"
 
 #include "appsupport.h"
 
+#include <vector>
+
 WipeEffect::WipeEffect() :
     RasterEffect("wipe",
                  AppSupport::getRasterEffectHardwareSupport("Wipe",
@@ -63,6 +66,8 @@ public:
 
     void processCpu(CpuRenderTools& renderTools,
                     const CpuRenderData& data);
+
+    bool pointWise() const { return true; }
 protected:
     void iniVars(QGL33 * const gl) const {
         sSharpnessU = gl->glGetUniformLocation(sProgramId, "sharpness");
@@ -145,9 +150,9 @@ void WipeEffectCaller::processCpu(CpuRenderTools& renderTools,
     const qreal imgHeight = srcBtmp.height();
 
     const int xMin = std::max(0, data.fTexTile.left());
-    const int xMax = std::min((int)data.fTexTile.right(), (int)imgWidth - 1);
+    const int xMax = std::min((int)data.fTexTile.right() - 1, (int)imgWidth - 1);
     const int yMin = std::max(0, data.fTexTile.top());
-    const int yMax = std::min((int)data.fTexTile.bottom(), (int)imgHeight - 1);
+    const int yMax = std::min((int)data.fTexTile.bottom() - 1, (int)imgHeight - 1);
 
     const qreal width = 2 - mSharpness;
     const qreal margin = 0.5*(width - 1);
@@ -162,23 +167,31 @@ void WipeEffectCaller::processCpu(CpuRenderTools& renderTools,
 
     const qreal c = 0.25*PI - direction;
 
+    // a*cos(direction - asin(y/a)) with a = |(x, y)| and x >= 0 expands
+    // to x*cos(direction) + y*sin(direction), f is linear in x and y
+    const qreal norm = 1/(cos(c) * sqrt(2));
+    const qreal fX = cos(direction) * norm;
+    const qreal fY = sin(direction) * norm;
+    const qreal offset = 0.33333 * sqrt(2) * (1 - mSharpness);
+
+    const int count = xMax - xMin + 1;
+    if(count <= 0) return;
+    std::vector<float> factors(count);
+
     for(int yi = yMin; yi <= yMax; yi++) {
-        auto dst = static_cast<uchar*>(renderTools.fDstBtmp.getAddr(0, yi - yMin));
-        auto src = static_cast<uchar*>(renderTools.fSrcBtmp.getAddr(xMin, yi));
-        for(int xi = xMin; xi <= xMax; xi++) {
-            qreal x = xi/imgWidth;
-            const qreal y = yi/imgHeight;
+        const auto dst = static_cast<uchar*>(dstBtmp.getAddr(0, yi - yMin));
+        const auto src = static_cast<const uchar*>(srcBtmp.getAddr(xMin, yi));
+        const qreal fRow = yi/imgHeight * fY;
+        for(int j = 0; j < count; j++) {
+            qreal x = (xMin + j)/imgWidth;
 
             if(i) x = 1 - x;
 
-            const qreal a = sqrt(x*x + y*y);
-            const qreal b = direction - asin(y / a);
-
-            qreal f = a * cos(b) / (cos(c) * sqrt(2));
+            qreal f = x * fX + fRow;
 
             if(ii) f = 1 - f;
 
-            f += 0.33333 * sqrt(2) * (1 - mSharpness);
+            f += offset;
 
             float alpha;
             if(f < x0) {
@@ -188,10 +201,8 @@ void WipeEffectCaller::processCpu(CpuRenderTools& renderTools,
             } else {
                 alpha = 1 - 0.5*(cos(PI*(f - x0)/(1 - mSharpness)) + 1);
             }
-
-            for(int i = 0; i < 4; i++) {
-                *dst++ = *src++ * alpha;
-            }
+            factors[j] = alpha;
         }
+        EffectKernels::scale(src, dst, factors.data(), count);
     }
 }
@@ -58,8 +58,16 @@ bool eReadStream::seek(const eFuturePos &pos) {
     return mFutureTable.seek(pos);
 }
 
+eFuturePos eReadStream::currentPos() const {
+    return mFutureTable.currentPos();
+}
+
+QList<eFuturePos> eReadStream::futures(const int first, const int last) const {
+    return mFutureTable.futures(first, last);
+}
+
 void eReadStream::readCheckpoint(const QString &errMsg) {
-    const qint64 sPos = mSrc->pos();
+    const qint64 sPos = mSrc->pos() + mCheckpointOffset;
     qint64 pos; read(&pos, sizeof(qint64));
     if(pos != sPos)
         RuntimeThrow("The QIODevice::pos '" + QString::number(sPos) +
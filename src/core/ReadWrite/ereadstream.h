@@ -27,6 +27,14 @@ class CORE_EXPORT eReadFutureTable {
         return mFutures.at(mFutureId++);
     }
 
+    eFuturePos currentPos() const {
+        return {mMain->pos(), mFutureId - 1};
+    }
+
+    QList<eFuturePos> futures(const int first, const int last) const {
+        return mFutures.mid(first, last - first + 1);
+    }
+
     void read();
 private:
     int mFutureId = 0;
@@ -47,6 +55,10 @@ public:
     void addReadStreamDoneTask(const ReadStreamDoneTask& task);
 
     void setPath(const QString& path);
+    const QDir& dir() const { return mDir; }
+    void setDir(const QDir& dir) { mDir = dir; }
+
+    QIODevice* device() const { return mSrc; }
 
     RuntimeIdToWriteId& objListIdConv() { return mObjectListIdConv; }
 
@@ -55,7 +67,15 @@ public:
     eFuturePos readFuturePos();
 
     bool seek(const eFuturePos& pos);
-
+    //! @brief Position to be used with seek to resume reading from here
+    eFuturePos currentPos() const;
+    //! @brief Futures with ids in the inclusive range
+    QList<eFuturePos> futures(const int first, const int last) const;
+
+    //! @brief Content copied from another file keeps the checkpoints
+    //! written there, offset is their distance from the current position
+    void setCheckpointOffset(const qint64 offset)
+    { mCheckpointOffset = offset; }
     void readCheckpoint(const QString& errMsg);
 
     inline qint64 read(void* const data, const qint64 len) {
@@ -94,6 +114,7 @@ private:
     const int mEvFileVersion;
     QIODevice* const mSrc;
     QDir mDir;
+    qint64 mCheckpointOffset = 0;
     eReadFutureTable mFutureTable;
     RuntimeIdToWriteId mObjectListIdConv;
 };
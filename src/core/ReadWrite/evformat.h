@@ -48,6 +48,9 @@ namespace EvFormat {
         avStretch = 33,
         grid = 34,
         v100 = 35,
+        lazyScenes = 36,
+        packedKeys = 37,
+        rawScenes = 38,
 
         nextVersion
     };
@@ -31,6 +31,13 @@ void eWriteStream::assignFuturePos(const eWriteStream::FuturePosId id) {
     mFutureTable.assignFuturePos(id.fId);
 }
 
+qint64 eWriteStream::writeCopied(const char* const data, const qint64 len,
+                                 const eFuturePos& src,
+                                 const QList<eFuturePos>& futures) {
+    mFutureTable.appendCopied(futures, src);
+    return write(data, len);
+}
+
 void eWriteStream::writeCheckpoint() {
     const qint64 pos = mDst->pos();
     write(&pos, sizeof(qint64));
@@ -27,8 +27,22 @@ class CORE_EXPORT eWriteFutureTable {
         return id;
     }
 
+    //! @brief Futures planned after id (nested content) are skipped
+    //! when seeking to the assigned position
     void assignFuturePos(const int id) {
-        mFutures.replace(id, {mMain->pos(), id});
+        mFutures.replace(id, {mMain->pos(), mFutures.count() - 1});
+    }
+
+    //! @brief Adds the futures of content about to be copied unchanged
+    //! from another file, src is where the content started there
+    void appendCopied(const QList<eFuturePos>& futures,
+                      const eFuturePos& src) {
+        const qint64 posShift = mMain->pos() - src.fMain;
+        const qint64 idShift = mFutures.count() - (src.fFutureTable + 1);
+        for(const auto& future : futures) {
+            mFutures.append({future.fMain + posShift,
+                             future.fFutureTable + idShift});
+        }
     }
 private:
     QList<eFuturePos> mFutures;
@@ -47,6 +61,8 @@ public:
     eWriteStream(QIODevice* const dst);
 
     void setPath(const QString& path);
+    const QDir& dir() const { return mDir; }
+    qint64 pos() const { return mDst->pos(); }
 
     RuntimeIdToWriteId& objListIdConv() { return mObjectListIdConv; }
 
@@ -67,6 +83,12 @@ public:
 
     qint64 writeCompressed(const void* const data, const qint64 len);
 
+    //! @brief Copies content read from another file, src is where it
+    //! started there and futures are the ones planned inside of it
+    qint64 writeCopied(const char* const data, const qint64 len,
+                       const eFuturePos& src,
+                       const QList<eFuturePos>& futures);
+
     eWriteStream& operator<<(const bool val);
     eWriteStream& operator<<(const int val);
     eWriteStream& operator<<(const uint val);
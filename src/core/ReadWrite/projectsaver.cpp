@@ -0,0 +1,101 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "projectsaver.h"
+#include "projectwriter.h"
+
+#include <QSaveFile>
+
+QList<stdsptr<ProjectSaver>> ProjectSaver::sPending;
+
+ProjectSaver::ProjectSaver(const QString& path, const QByteArray& data,
+                           const Finished& finished) :
+    mPath(path), mData(data), mFinished(finished) {}
+
+void ProjectSaver::process() {
+    write();
+}
+
+void ProjectSaver::sSave(const QString& path, const QByteArray& data,
+                         const Finished& finished) {
+    const auto saver = enve::make_shared<ProjectSaver>(path, data, finished);
+    sPending << saver;
+    saver->queTask();
+}
+
+void ProjectSaver::sFinishAll() {
+    // projects still being serialized are saved as well
+    ProjectWriter::sFinishAll();
+    const auto pending = sPending;
+    for(const auto& saver : pending) {
+        try {
+            saver->write();
+        } catch(const std::exception& e) {
+            gPrintExceptionCritical(e);
+        }
+    }
+}
+
+bool ProjectSaver::sIsPending(const QString& path) {
+    if(ProjectWriter::sIsPending(path)) return true;
+    for(const auto& saver : sPending) {
+        if(saver->mPath == path) return true;
+    }
+    return false;
+}
+
+void ProjectSaver::afterProcessing() {
+    finish();
+}
+
+void ProjectSaver::afterCanceled() {
+    // never reached the hdd thread, write now rather than lose the data
+    try {
+        write();
+    } catch(const std::exception& e) {
+        gPrintExceptionCritical(e);
+    }
+    finish();
+}
+
+void ProjectSaver::write() {
+    std::lock_guard<std::mutex> lock(mWriteMutex);
+    if(mWritten) return;
+    mWritten = true;
+    QSaveFile file(mPath);
+    // e.g. sandboxed locations, where no temporary file can be created
+    file.setDirectWriteFallback(true);
+    if(!file.open(QIODevice::WriteOnly)) {
+        RuntimeThrow("Could not open file for writing " + mPath + ".");
+    }
+    if(file.write(mData) != mData.size() || !file.commit()) {
+        RuntimeThrow("Error while writing to file " + mPath);
+    }
+    mSuccess = true;
+}
+
+void ProjectSaver::finish() {
+    const auto self = ref<ProjectSaver>();
+    sPending.removeOne(self);
+    if(mFinished) mFinished(mSuccess);
+}
@@ -0,0 +1,69 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef PROJECTSAVER_H
+#define PROJECTSAVER_H
+
+#include "Tasks/updatable.h"
+
+#include <mutex>
+
+// Writes serialized project data on the hdd thread. The data goes to
+// a temporary file that replaces the target only once fully written,
+// so a failed save never destroys the previous file.
+class CORE_EXPORT ProjectSaver : public eHddTask {
+    e_OBJECT
+public:
+    using Finished = std::function<void(const bool success)>;
+protected:
+    ProjectSaver(const QString& path, const QByteArray& data,
+                 const Finished& finished);
+public:
+    void process();
+
+    static void sSave(const QString& path, const QByteArray& data,
+                      const Finished& finished = nullptr);
+    //! @brief Blocks until all pending saves, including the ones
+    //! still serialized by ProjectWriter, are written
+    static void sFinishAll();
+    //! @brief true if a save to path is queued but not finished yet
+    static bool sIsPending(const QString& path);
+protected:
+    void afterProcessing();
+    void afterCanceled();
+private:
+    void write();
+    void finish();
+
+    static QList<stdsptr<ProjectSaver>> sPending;
+
+    const QString mPath;
+    const QByteArray mData;
+    const Finished mFinished;
+
+    std::mutex mWriteMutex;
+    bool mWritten = false;
+    bool mSuccess = false;
+};
+
+#endif // PROJECTSAVER_H
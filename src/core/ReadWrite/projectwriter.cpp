@@ -0,0 +1,165 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "projectwriter.h"
+
+#include "filefooter.h"
+#include "canvas.h"
+
+#include <QTimer>
+
+struct ProjectWriter::Pending {
+    Pending(const Document& document, const QString& path,
+            const Document::WriteSection& layout,
+            const Document::WriteSection& renderSettings,
+            const Finished& finished, const QStringList& copies) :
+        fPath(path), fCopies(copies), fFinished(finished),
+        fStream(&fBuffer) {
+        fBuffer.open(QIODevice::WriteOnly);
+        fStream.setPath(path);
+        fWriter = std::make_unique<ProjectWriter>(document, fStream,
+                                                  layout, renderSettings);
+    }
+
+    //! @brief Returns false once done, the data is then with ProjectSaver
+    bool writeNext() {
+        try {
+            if (fWriter->writeNext()) { return true; }
+        } catch (const std::exception& e) {
+            fWriter.reset();
+            gPrintExceptionCritical(e);
+            if (fFinished) { fFinished(false); }
+            return false;
+        }
+        fWriter.reset();
+        fBuffer.close();
+        ProjectSaver::sSave(fPath, fBuffer.data(), fFinished);
+        for (const auto& copy : fCopies) {
+            ProjectSaver::sSave(copy, fBuffer.data());
+        }
+        return false;
+    }
+
+    const QString fPath;
+    const QStringList fCopies;
+    const Finished fFinished;
+    QBuffer fBuffer;
+    eWriteStream fStream;
+    std::unique_ptr<ProjectWriter> fWriter;
+};
+
+QList<std::shared_ptr<ProjectWriter::Pending>> ProjectWriter::sPending;
+bool ProjectWriter::sStepQueued = false;
+
+ProjectWriter::ProjectWriter(const Document& document, eWriteStream& dst,
+                             const Document::WriteSection& layout,
+                             const Document::WriteSection& renderSettings) :
+    mDocument(document), mDst(dst), mRenderSettings(renderSettings),
+    mScenes(document.fScenes), mLinked(document.linkedScenes())
+{
+    try {
+        dst.writeCheckpoint();
+        dst << mScenes.count();
+        for (const auto &scene : mScenes) {
+            scene->writeSettings(dst);
+        }
+        if (layout) { layout(dst); }
+        dst.writeCheckpoint();
+        document.writeScenesBegin(dst);
+    } catch (...) {
+        BoundingBox::sClearWriteBoxes();
+        throw;
+    }
+}
+
+ProjectWriter::~ProjectWriter()
+{
+    if (!mFinished) { BoundingBox::sClearWriteBoxes(); }
+}
+
+bool ProjectWriter::writeNext()
+{
+    if (mFinished) { return false; }
+    if (mNextScene < mScenes.count()) {
+        const auto scene = mScenes.at(mNextScene++).get();
+        mDocument.writeScene(mDst, scene, !mLinked.contains(scene));
+        return true;
+    }
+    mDst.writeCheckpoint();
+    if (mRenderSettings) { mRenderSettings(mDst); }
+    mDst.writeCheckpoint();
+
+    mDst.writeFutureTable();
+    FileFooter::sWrite(mDst);
+
+    mFinished = true;
+    BoundingBox::sClearWriteBoxes();
+    return false;
+}
+
+void ProjectWriter::sSave(const Document& document, const QString& path,
+                          const Document::WriteSection& layout,
+                          const Document::WriteSection& renderSettings,
+                          const Finished& finished,
+                          const QStringList& copies)
+{
+    sFinishAll();
+    sPending << std::make_shared<Pending>(document, path, layout,
+                                          renderSettings, finished, copies);
+    sQueueStep();
+}
+
+void ProjectWriter::sQueueStep()
+{
+    if (sStepQueued) { return; }
+    sStepQueued = true;
+    // one step per event loop pass, input is handled in between
+    QTimer::singleShot(0, &ProjectWriter::sNextStep);
+}
+
+void ProjectWriter::sNextStep()
+{
+    sStepQueued = false;
+    if (sPending.isEmpty()) { return; }
+    const auto pending = sPending.first();
+    if (!pending->writeNext()) { sPending.removeOne(pending); }
+    if (!sPending.isEmpty()) { sQueueStep(); }
+}
+
+void ProjectWriter::sFinishAll()
+{
+    while (!sPending.isEmpty()) {
+        const auto pending = sPending.takeFirst();
+        while (pending->writeNext()) {}
+    }
+}
+
+bool ProjectWriter::sIsPending(const QString& path)
+{
+    for (const auto& pending : sPending) {
+        if (pending->fPath == path || pending->fCopies.contains(path)) {
+            return true;
+        }
+    }
+    return false;
+}
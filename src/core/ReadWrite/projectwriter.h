@@ -0,0 +1,78 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef PROJECTWRITER_H
+#define PROJECTWRITER_H
+
+#include "projectsaver.h"
+#include "Private/document.h"
+
+#include <QBuffer>
+
+// Serializes a project one scene per writeNext call. sSave spreads the
+// calls over event loop passes, so that saving a large project does not
+// freeze the interface, and hands the result to ProjectSaver. Scenes
+// edited in between are written as they are when their turn comes.
+// Box write ids are global, so only one project is written at a time.
+class CORE_EXPORT ProjectWriter {
+public:
+    using Finished = ProjectSaver::Finished;
+
+    ProjectWriter(const Document& document, eWriteStream& dst,
+                  const Document::WriteSection& layout,
+                  const Document::WriteSection& renderSettings);
+    ~ProjectWriter();
+
+    //! @brief Writes the next part, returns false once all is written
+    bool writeNext();
+
+    //! @brief Serializes document in steps and saves it to path,
+    //! copies are written with the same data, e.g. backups
+    static void sSave(const Document& document, const QString& path,
+                      const Document::WriteSection& layout,
+                      const Document::WriteSection& renderSettings,
+                      const Finished& finished = nullptr,
+                      const QStringList& copies = QStringList());
+    //! @brief Finishes pending serialization right away
+    //! and hands the data to ProjectSaver
+    static void sFinishAll();
+    //! @brief true if path or a copy is still being serialized
+    static bool sIsPending(const QString& path);
+private:
+    struct Pending;
+    static void sQueueStep();
+    static void sNextStep();
+
+    static QList<std::shared_ptr<Pending>> sPending;
+    static bool sStepQueued;
+
+    const Document& mDocument;
+    eWriteStream& mDst;
+    const Document::WriteSection mRenderSettings;
+    const QList<qsptr<Canvas>> mScenes;
+    const QSet<Canvas*> mLinked;
+    int mNextScene = 0;
+    bool mFinished = false;
+};
+
+#endif // PROJECTWRITER_H
@@ -0,0 +1,84 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "arclengthtable.h"
+
+#include <algorithm>
+
+ArcLengthTable::ArcLengthTable(const QPainterPath& path) {
+    const int count = path.elementCount();
+    for(int i = 1; i < count; i++) {
+        const auto& e = path.elementAt(i);
+        const QPointF prev = path.elementAt(i - 1);
+        if(e.isLineTo()) {
+            const qreal len = QLineF(prev, e).length();
+            mSegments.append({qCubicSegment2D::sFromLine(prev, e),
+                              mLength, len, true});
+            mLength += len;
+        } else if(e.isCurveTo()) {
+            if(i + 2 >= count) break;
+            const qCubicSegment2D cubic(prev, e, path.elementAt(i + 1),
+                                        path.elementAt(i + 2));
+            const qreal len = cubic.length();
+            mSegments.append({cubic, mLength, len, false});
+            mLength += len;
+            i += 2;
+        }
+    }
+}
+
+int ArcLengthTable::segmentAtPercent(const qreal per) const {
+    // first segment ending at or after per, the last one otherwise
+    const auto it = std::lower_bound(
+                mSegments.begin(), mSegments.end() - 1, per,
+                [this](const Segment& seg, const qreal value) {
+        return (seg.fStart + seg.fLength)/mLength < value;
+    });
+    return int(it - mSegments.begin());
+}
+
+int ArcLengthTable::segmentAtLength(const qreal len) const {
+    const auto it = std::lower_bound(
+                mSegments.begin(), mSegments.end() - 1, len,
+                [](const Segment& seg, const qreal value) {
+        return seg.fStart + seg.fLength < value;
+    });
+    return int(it - mSegments.begin());
+}
+
+qreal ArcLengthTable::percentAtLength(const qreal len) const {
+    if(!isValid() || len <= 0) return 0;
+    if(len > mLength) return 1;
+    const auto& seg = mSegments.at(segmentAtLength(len));
+    if(seg.fLine) return len/mLength;
+    const qreal t = seg.fCubic.tAtLength(len - seg.fStart);
+    return (t*seg.fLength + seg.fStart)/mLength;
+}
+
+QPointF ArcLengthTable::pointAtPercent(const qreal per) const {
+    if(!isValid()) return QPointF();
+    const auto& seg = mSegments.at(segmentAtPercent(per));
+    if(seg.fLength <= 0) return seg.fCubic.p0();
+    const qreal t = (mLength*per - seg.fStart)/seg.fLength;
+    return seg.fCubic.posAtT(qBound(0., t, 1.));
+}
@@ -0,0 +1,62 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef ARCLENGTHTABLE_H
+#define ARCLENGTHTABLE_H
+
+#include "qcubicsegment2d.h"
+
+#include <QPainterPath>
+#include <QVector>
+
+// Cumulative segment lengths of a QPainterPath, built once and shared
+// by every query. Matches QPainterPath::percentAtLength and
+// QPainterPath::pointAtPercent, with a binary search over segments
+// in place of the linear walk that recomputes every segment length.
+class CORE_EXPORT ArcLengthTable {
+public:
+    ArcLengthTable(const QPainterPath& path);
+
+    //! @brief False for paths the table cannot answer for,
+    //! i.e. paths without segments or of zero length
+    bool isValid() const { return mLength > 0; }
+    qreal length() const { return mLength; }
+
+    qreal percentAtLength(const qreal len) const;
+    QPointF pointAtPercent(const qreal per) const;
+private:
+    struct Segment {
+        qCubicSegment2D fCubic;
+        qreal fStart;
+        qreal fLength;
+        bool fLine;
+    };
+
+    int segmentAtPercent(const qreal per) const;
+    int segmentAtLength(const qreal len) const;
+
+    QVector<Segment> mSegments;
+    qreal mLength = 0;
+};
+
+#endif // ARCLENGTHTABLE_H
@@ -29,6 +29,7 @@
 #include "CacheHandlers/soundcachecontainer.h"
 #include "soundmerger.h"
 #include "FileCacheHandlers/soundreaderformerger.h"
+#include "Tasks/metricsregistry.h"
 
 SoundComposition::SoundComposition(Canvas * const parent) :
     QIODevice(parent), mParent(parent) {
@@ -49,6 +50,10 @@ void SoundComposition::stop() {
     clearUseRange();
 }
 
+qreal SoundComposition::currentFrame() const {
+    return mPos*mParent->getFps()/mSettings.fSampleRate;
+}
+
 void SoundComposition::addSound(const qsptr<eSound>& sound) {
     auto& conn = mSounds.addObj(sound);
     conn << connect(sound.get(), &Property::prp_absFrameRangeChanged,
@@ -101,7 +106,13 @@ SoundMerger *SoundComposition::scheduleFrame(const int frameId) {
 SoundMerger *SoundComposition::scheduleSecond(const int secondId) {
     if(mSounds.isEmpty()) return nullptr;
     if(mProcessingSeconds.contains(secondId)) return nullptr;
-    if(mSecondsCache.atFrame(secondId)) return nullptr;
+    static auto& hits = MetricsRegistry::sCounter("cache.sound.hits");
+    static auto& misses = MetricsRegistry::sCounter("cache.sound.misses");
+    if(mSecondsCache.atFrame(secondId)) {
+        hits.add();
+        return nullptr;
+    }
+    misses.add();
     mProcessingSeconds.append(secondId);
     const int sampleRate = mSettings.fSampleRate;
     const SampleRange sampleRange = {secondId*sampleRate,
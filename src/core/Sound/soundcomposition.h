@@ -52,6 +52,7 @@ public:
 
     void start(const int startFrame);
     void stop();
+    qreal currentFrame() const;
 
     qint64 readData(char *data, qint64 maxLen);
     qint64 writeData(const char *data, qint64 len);
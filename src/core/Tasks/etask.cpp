@@ -24,9 +24,11 @@
 // Fork of enve - Copyright (C) 2016-2020 Maurycy Liebner
 
 #include "etask.h"
+#include "renderprofiler.h"
 
 bool eTask::queTask() {
     mState = eTaskState::qued;
+    if(RenderProfiler::sEnabled()) mQuedTimestamp = RenderProfiler::sNow();
     afterQued();
     queTaskNow();
     return true;
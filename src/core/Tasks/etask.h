@@ -30,12 +30,16 @@
 #include "../hardwareenums.h"
 #include "../switchablecontext.h"
 #include "etaskbase.h"
+#include "../smartPointers/ememorypool.h"
 
 class CORE_EXPORT eTask : public StdSelfRef, public eTaskBase {
     friend class TaskScheduler;
+    friend class TaskExecutor;
     friend class Que;
     friend class eTaskBase;
     template <typename T> friend class TaskCollection;
+    e_OBJECT
+    e_POOLED_ALLOCATOR(eMemoryPool::sTasks())
 protected:
     eTask() {}
 
@@ -49,10 +53,15 @@ public:
     virtual void process() = 0;
 
     virtual bool nextStep() { return false; }
+    //! @brief Box or file the task works on, for RenderProfiler
+    virtual QString profileLabel() const { return QString(); }
 
     bool queTask();
 
     void aboutToProcess(const Hardware hw);
+private:
+    //! @brief RenderProfiler::sNow() when last qued, -1 if not recorded
+    qint64 mQuedTimestamp = -1;
 };
 
 Q_DECLARE_METATYPE(stdsptr<eTask>);
@@ -0,0 +1,245 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "Tasks/metricsregistry.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QTextStream>
+#include <QtAlgorithms>
+#include <QtMath>
+#include <cmath>
+#include <map>
+
+// snapshots kept for dumping, one per tick
+#define MAX_SNAPSHOTS 600
+
+using Histogram = MetricsRegistry::Histogram;
+
+struct Metric {
+    MetricsRegistry::Kind fKind = MetricsRegistry::Kind::counter;
+    MetricsRegistry::Counter fCounter;
+    MetricsRegistry::Gauge fGauge;
+    Histogram fHistogram;
+    MetricsRegistry::Probe fProbe;
+
+    // state at the previous tick
+    qint64 fLastValue = 0;
+    qint64 fLastSum = 0;
+    qint64 fLastBuckets[Histogram::sBucketCount] = {};
+};
+
+static QMutex sMutex;
+static std::map<QString, Metric> sMetrics;
+static QList<MetricsRegistry::Snapshot> sSnapshots;
+static QElapsedTimer sClock;
+static qint64 sLastTick = 0;
+
+static int bucketId(const qint64 value) {
+    if(value <= 0) return 0;
+    const int bits = 64 - qCountLeadingZeroBits(quint64(value));
+    return qMin(bits, Histogram::sBucketCount - 1);
+}
+
+static qreal bucketMin(const int id) {
+    return id == 0 ? 0 : std::ldexp(1., id - 1);
+}
+
+static qreal bucketMax(const int id) {
+    return std::ldexp(1., id);
+}
+
+static qint64 percentile(const qint64* const counts,
+                         const qint64 total,
+                         const qreal fraction) {
+    const qreal target = total*fraction;
+    qint64 before = 0;
+    for(int i = 0; i < Histogram::sBucketCount; i++) {
+        const qint64 count = counts[i];
+        if(count == 0 || before + count < target) {
+            before += count;
+            continue;
+        }
+        const qreal inBucket = (target - before)/count;
+        const qreal min = bucketMin(i);
+        return qRound64(min + (bucketMax(i) - min)*inBucket);
+    }
+    return 0;
+}
+
+static Metric& metric(const QString& name,
+                      const MetricsRegistry::Kind kind) {
+    const auto it = sMetrics.find(name);
+    if(it != sMetrics.end()) {
+        Q_ASSERT(it->second.fKind == kind);
+        return it->second;
+    }
+    auto& result = sMetrics[name];
+    result.fKind = kind;
+    return result;
+}
+
+void MetricsRegistry::Histogram::record(const qint64 value) {
+    mBuckets[bucketId(value)].fetch_add(1, std::memory_order_relaxed);
+    mSum.fetch_add(value, std::memory_order_relaxed);
+    qint64 max = mMax.load(std::memory_order_relaxed);
+    while(value > max &&
+          !mMax.compare_exchange_weak(max, value,
+                                      std::memory_order_relaxed)) {}
+}
+
+const MetricsRegistry::Sample* MetricsRegistry::Snapshot::find(
+        const QString& name) const {
+    for(const auto& sample : fSamples) {
+        if(sample.fName == name) return &sample;
+    }
+    return nullptr;
+}
+
+qint64 MetricsRegistry::Snapshot::value(const QString& name) const {
+    const auto sample = find(name);
+    return sample ? sample->fValue : 0;
+}
+
+qreal MetricsRegistry::Snapshot::rate(const QString& name) const {
+    const auto sample = find(name);
+    return sample ? sample->fRate : 0;
+}
+
+MetricsRegistry::Counter& MetricsRegistry::sCounter(const QString& name) {
+    QMutexLocker lock(&sMutex);
+    return metric(name, Kind::counter).fCounter;
+}
+
+MetricsRegistry::Gauge& MetricsRegistry::sGauge(const QString& name) {
+    QMutexLocker lock(&sMutex);
+    return metric(name, Kind::gauge).fGauge;
+}
+
+MetricsRegistry::Histogram& MetricsRegistry::sHistogram(const QString& name) {
+    QMutexLocker lock(&sMutex);
+    return metric(name, Kind::histogram).fHistogram;
+}
+
+void MetricsRegistry::sAddProbe(const QString& name, const Probe& probe) {
+    QMutexLocker lock(&sMutex);
+    metric(name, Kind::gauge).fProbe = probe;
+}
+
+void MetricsRegistry::sRemoveProbe(const QString& name) {
+    QMutexLocker lock(&sMutex);
+    sMetrics.erase(name);
+}
+
+void MetricsRegistry::sTick() {
+    QMutexLocker lock(&sMutex);
+    if(!sClock.isValid()) sClock.start();
+    const qint64 now = sClock.elapsed();
+    const qreal seconds = qMax(qint64(1), now - sLastTick)/1000.;
+    sLastTick = now;
+
+    Snapshot snapshot;
+    snapshot.fTime = now;
+    for(auto& it : sMetrics) {
+        auto& metric = it.second;
+        Sample sample;
+        sample.fName = it.first;
+        sample.fKind = metric.fKind;
+        switch(metric.fKind) {
+        case Kind::counter: {
+            const qint64 value = metric.fCounter.value();
+            sample.fValue = value;
+            sample.fRate = (value - metric.fLastValue)/seconds;
+            metric.fLastValue = value;
+        } break;
+        case Kind::gauge:
+            if(metric.fProbe) metric.fGauge.set(metric.fProbe());
+            sample.fValue = metric.fGauge.value();
+            break;
+        case Kind::histogram: {
+            auto& hist = metric.fHistogram;
+            qint64 counts[Histogram::sBucketCount];
+            qint64 count = 0;
+            for(int i = 0; i < Histogram::sBucketCount; i++) {
+                const qint64 total = hist.mBuckets[i].load(
+                            std::memory_order_relaxed);
+                counts[i] = total - metric.fLastBuckets[i];
+                metric.fLastBuckets[i] = total;
+                count += counts[i];
+            }
+            const qint64 sum = hist.mSum.load(std::memory_order_relaxed);
+            const qint64 max = hist.mMax.exchange(0, std::memory_order_relaxed);
+            sample.fCount = count;
+            if(count > 0) {
+                sample.fMean = qreal(sum - metric.fLastSum)/count;
+                sample.fP50 = qMin(max, percentile(counts, count, 0.5));
+                sample.fP95 = qMin(max, percentile(counts, count, 0.95));
+                sample.fMax = max;
+            }
+            sample.fValue = sample.fP50;
+            metric.fLastSum = sum;
+        } break;
+        }
+        snapshot.fSamples << sample;
+    }
+    sSnapshots << snapshot;
+    if(sSnapshots.count() > MAX_SNAPSHOTS) sSnapshots.removeFirst();
+}
+
+MetricsRegistry::Snapshot MetricsRegistry::sLatest() {
+    QMutexLocker lock(&sMutex);
+    if(sSnapshots.isEmpty()) return Snapshot();
+    return sSnapshots.last();
+}
+
+bool MetricsRegistry::sDump(const QString& path) {
+    QFile file(path);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
+    QTextStream stream(&file);
+    stream << "time_s,metric,kind,value,rate,count,mean,p50,p95,max\n";
+
+    QMutexLocker lock(&sMutex);
+    for(const auto& snapshot : sSnapshots) {
+        const QString time = QString::number(snapshot.fTime/1000., 'f', 3);
+        for(const auto& sample : snapshot.fSamples) {
+            stream << time << ',' << sample.fName << ',';
+            switch(sample.fKind) {
+            case Kind::counter:
+                stream << "counter," << sample.fValue << ','
+                       << sample.fRate << ",,,,,";
+                break;
+            case Kind::gauge:
+                stream << "gauge," << sample.fValue << ",,,,,,";
+                break;
+            case Kind::histogram:
+                stream << "histogram,,," << sample.fCount << ','
+                       << sample.fMean << ',' << sample.fP50 << ','
+                       << sample.fP95 << ',' << sample.fMax;
+                break;
+            }
+            stream << '\n';
+        }
+    }
+    return stream.status() == QTextStream::Ok;
+}
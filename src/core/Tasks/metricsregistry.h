@@ -0,0 +1,123 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef METRICSREGISTRY_H
+#define METRICSREGISTRY_H
+
+#include "../core_global.h"
+
+#include <QList>
+#include <QString>
+#include <atomic>
+#include <functional>
+
+// Named counters, gauges and histograms describing the scheduler,
+// executors and caches. Updating a metric is a relaxed atomic
+// operation, look them up once and keep the reference. sTick samples
+// every metric into a snapshot, with counter rates and histogram
+// statistics covering the time since the previous tick. The latest
+// snapshots are kept for the overlay and for dumping to a file.
+class CORE_EXPORT MetricsRegistry {
+public:
+    enum class Kind { counter, gauge, histogram };
+
+    class CORE_EXPORT Counter {
+    public:
+        void add(const qint64 value = 1) {
+            mValue.fetch_add(value, std::memory_order_relaxed);
+        }
+        qint64 value() const {
+            return mValue.load(std::memory_order_relaxed);
+        }
+    private:
+        std::atomic<qint64> mValue{0};
+    };
+
+    class CORE_EXPORT Gauge {
+    public:
+        void set(const qint64 value) {
+            mValue.store(value, std::memory_order_relaxed);
+        }
+        qint64 value() const {
+            return mValue.load(std::memory_order_relaxed);
+        }
+    private:
+        std::atomic<qint64> mValue{0};
+    };
+
+    // Power of two buckets of non-negative values
+    class CORE_EXPORT Histogram {
+    public:
+        static constexpr int sBucketCount = 64;
+
+        void record(const qint64 value);
+    private:
+        friend class MetricsRegistry;
+
+        std::atomic<qint64> mBuckets[sBucketCount] = {};
+        std::atomic<qint64> mSum{0};
+        std::atomic<qint64> mMax{0};
+    };
+
+    struct Sample {
+        QString fName;
+        Kind fKind;
+        //! @brief Current value, total for counters
+        qint64 fValue = 0;
+        //! @brief Counter increase per second since the previous tick
+        qreal fRate = 0;
+        //! @brief Histogram values recorded since the previous tick
+        qint64 fCount = 0;
+        qreal fMean = 0;
+        qint64 fP50 = 0;
+        qint64 fP95 = 0;
+        qint64 fMax = 0;
+    };
+
+    struct Snapshot {
+        //! @brief Milliseconds since the first tick
+        qint64 fTime = 0;
+        QList<Sample> fSamples;
+
+        const Sample* find(const QString& name) const;
+        qint64 value(const QString& name) const;
+        qreal rate(const QString& name) const;
+    };
+
+    using Probe = std::function<qint64()>;
+
+    static Counter& sCounter(const QString& name);
+    static Gauge& sGauge(const QString& name);
+    static Histogram& sHistogram(const QString& name);
+
+    //! @brief Gauge read from probe on every tick
+    static void sAddProbe(const QString& name, const Probe& probe);
+    static void sRemoveProbe(const QString& name);
+
+    static void sTick();
+    static Snapshot sLatest();
+    //! @brief Writes the kept snapshots as CSV, one row per metric
+    static bool sDump(const QString& path);
+};
+
+#endif // METRICSREGISTRY_H
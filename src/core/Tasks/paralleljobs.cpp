@@ -0,0 +1,65 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "Tasks/paralleljobs.h"
+#include "Tasks/updatable.h"
+#include "Private/Tasks/taskexecutor.h"
+
+bool ParallelJobs::runNext(const Job& job) {
+    const int id = mNext++;
+    if(id >= mCount) return false;
+    try {
+        job(id);
+    } catch(...) {
+        QMutexLocker lock(&mMutex);
+        if(!mException) mException = std::current_exception();
+    }
+    QMutexLocker lock(&mMutex);
+    if(++mDone == mCount) mFinished.wakeAll();
+    return true;
+}
+
+void ParallelJobs::waitFinished() {
+    QMutexLocker lock(&mMutex);
+    while(mDone < mCount) mFinished.wait(&mMutex);
+    if(mException) std::rethrow_exception(mException);
+}
+
+void ParallelJobs::sRun(const int count, const int maxThreads,
+                        const Job& job) {
+    if(count <= 0) return;
+    const auto jobs = std::make_shared<ParallelJobs>(count);
+    // helpers touch job (and whatever it references)
+    // only while holding an unfinished job
+    const auto helper = [jobs, job]() {
+        while(jobs->runNext(job));
+    };
+    const int nHelpers = qMin(maxThreads, count) - 1;
+    for(int i = 0; i < nHelpers; i++) {
+        const auto task = enve::make_shared<eCustomCpuTask>(
+                              nullptr, helper, nullptr, nullptr);
+        CpuTaskExecutor::sAddTask(task);
+    }
+    while(jobs->runNext(job));
+    jobs->waitFinished();
+}
@@ -0,0 +1,63 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef PARALLELJOBS_H
+#define PARALLELJOBS_H
+
+#include "../core_global.h"
+
+#include <QMutex>
+#include <QWaitCondition>
+#include <atomic>
+#include <exception>
+#include <functional>
+
+// Independent jobs shared by the calling thread and helper CPU tasks.
+// Every thread claims the next job from a shared counter, so nobody
+// blocks on helpers that did not get to run yet, and the caller only
+// waits for jobs some helper already started.
+class CORE_EXPORT ParallelJobs {
+public:
+    using Job = std::function<void(const int id)>;
+
+    ParallelJobs(const int count) : mCount(count) {}
+
+    //! @brief Runs job for the next unclaimed id,
+    //! returns false if all jobs are claimed
+    bool runNext(const Job& job);
+    //! @brief Waits for all claimed jobs, rethrows the first exception
+    void waitFinished();
+
+    //! @brief Runs job(0)...job(count - 1) using at most
+    //! maxThreads threads, including the calling one
+    static void sRun(const int count, const int maxThreads, const Job& job);
+private:
+    const int mCount;
+    std::atomic<int> mNext{0};
+    int mDone = 0;
+    QMutex mMutex;
+    QWaitCondition mFinished;
+    std::exception_ptr mException;
+};
+
+#endif // PARALLELJOBS_H
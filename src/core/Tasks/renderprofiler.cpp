@@ -0,0 +1,274 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "Tasks/renderprofiler.h"
+
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QVector>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+#if defined(__GNUC__)
+#include <cxxabi.h>
+#endif
+
+// recording stops growing past this many events
+#define MAX_EVENTS 1000000
+
+std::atomic<bool> RenderProfiler::sRecording{false};
+
+static QMutex sMutex;
+static QVector<RenderProfiler::Event> sEvents;
+static int sDropped = 0;
+static std::atomic<qint64> sOrigin{0};
+static std::atomic<int> sNextThread{0};
+
+static thread_local RenderProfiler::Scope* tCurrentScope = nullptr;
+
+static qint64 steadyMicroseconds() {
+    using namespace std::chrono;
+    const auto now = steady_clock::now().time_since_epoch();
+    return duration_cast<microseconds>(now).count();
+}
+
+static int currentThread() {
+    static thread_local const int thread = sNextThread++;
+    return thread;
+}
+
+RenderProfiler::Scope::Scope(const char* const category,
+                             const char* const name) :
+    mActive(sEnabled()) {
+    if(!mActive) return;
+    mEvent.fCategory = category;
+    mEvent.fName = name;
+    mEvent.fType = nullptr;
+    begin();
+}
+
+RenderProfiler::Scope::Scope(const char* const category,
+                             const std::type_info& type) :
+    mActive(sEnabled()) {
+    if(!mActive) return;
+    mEvent.fCategory = category;
+    mEvent.fName = nullptr;
+    mEvent.fType = &type;
+    begin();
+}
+
+RenderProfiler::Scope::~Scope() {
+    if(!mActive) return;
+    mEvent.fDuration = sNow() - mEvent.fStart;
+    tCurrentScope = mParent;
+    sRecord(mEvent);
+}
+
+void RenderProfiler::Scope::begin() {
+    mEvent.fThread = currentThread();
+    mEvent.fWait = -1;
+    mEvent.fBytes = 0;
+    mParent = tCurrentScope;
+    tCurrentScope = this;
+    mEvent.fStart = sNow();
+}
+
+void RenderProfiler::sStart() {
+    {
+        QMutexLocker lock(&sMutex);
+        if(sEvents.isEmpty()) sOrigin = steadyMicroseconds();
+    }
+    sRecording = true;
+}
+
+void RenderProfiler::sStop() {
+    sRecording = false;
+}
+
+void RenderProfiler::sClear() {
+    QMutexLocker lock(&sMutex);
+    sEvents.clear();
+    sEvents.squeeze();
+    sDropped = 0;
+    sOrigin = steadyMicroseconds();
+}
+
+qint64 RenderProfiler::sNow() {
+    return steadyMicroseconds() - sOrigin;
+}
+
+void RenderProfiler::sAddBytes(const qint64 bytes) {
+    if(!sEnabled() || !tCurrentScope) return;
+    tCurrentScope->mEvent.fBytes += bytes;
+}
+
+void RenderProfiler::sInstant(const char* const category,
+                              const char* const name,
+                              const QString& box) {
+    if(!sEnabled()) return;
+    Event event;
+    event.fCategory = category;
+    event.fName = name;
+    event.fType = nullptr;
+    event.fBox = box;
+    event.fThread = currentThread();
+    event.fStart = sNow();
+    event.fDuration = -1;
+    event.fWait = -1;
+    event.fBytes = 0;
+    sRecord(event);
+}
+
+void RenderProfiler::sRecord(const Event& event) {
+    QMutexLocker lock(&sMutex);
+    if(sEvents.count() >= MAX_EVENTS) {
+        sDropped++;
+        return;
+    }
+    sEvents.append(event);
+}
+
+int RenderProfiler::sEventCount() {
+    QMutexLocker lock(&sMutex);
+    return sEvents.count();
+}
+
+int RenderProfiler::sDroppedCount() {
+    QMutexLocker lock(&sMutex);
+    return sDropped;
+}
+
+QByteArray RenderProfiler::sTypeName(const std::type_info& type) {
+    QByteArray result;
+#if defined(__GNUC__)
+    int status = 0;
+    const auto name = abi::__cxa_demangle(type.name(), nullptr,
+                                          nullptr, &status);
+    if(status == 0 && name) result = name;
+    std::free(name);
+#endif
+    if(result.isEmpty()) {
+        result = type.name();
+        if(result.startsWith("class ")) result.remove(0, 6);
+        else if(result.startsWith("struct ")) result.remove(0, 7);
+    }
+    return result;
+}
+
+class TypeNames {
+public:
+    QByteArray name(const RenderProfiler::Event& event) {
+        if(event.fName) return event.fName;
+        auto it = mNames.find(event.fType);
+        if(it == mNames.end()) {
+            it = mNames.insert(event.fType,
+                               RenderProfiler::sTypeName(*event.fType));
+        }
+        return *it;
+    }
+private:
+    QHash<const std::type_info*, QByteArray> mNames;
+};
+
+QList<RenderProfiler::Summary> RenderProfiler::sSummary() {
+    QVector<Event> events;
+    {
+        QMutexLocker lock(&sMutex);
+        events = sEvents;
+    }
+    TypeNames names;
+    QList<Summary> result;
+    QHash<QString, int> ids;
+    for(const auto& event : events) {
+        const QByteArray name = names.name(event);
+        const QString key = QString::fromLatin1(event.fCategory) + '\n' +
+                            QString::fromUtf8(name) + '\n' + event.fBox;
+        auto id = ids.find(key);
+        if(id == ids.end()) {
+            id = ids.insert(key, result.count());
+            Summary summary;
+            summary.fCategory = event.fCategory;
+            summary.fName = name;
+            summary.fBox = event.fBox;
+            result << summary;
+        }
+        auto& summary = result[*id];
+        summary.fCount++;
+        summary.fBytes += event.fBytes;
+        if(event.fWait > 0) summary.fWait += event.fWait;
+        if(event.fDuration > 0) {
+            summary.fTotal += event.fDuration;
+            summary.fMax = qMax(summary.fMax, event.fDuration);
+        }
+    }
+    std::sort(result.begin(), result.end(),
+              [](const Summary& a, const Summary& b) {
+        return a.fTotal > b.fTotal;
+    });
+    return result;
+}
+
+bool RenderProfiler::sExportChromeTrace(const QString& path) {
+    QVector<Event> events;
+    {
+        QMutexLocker lock(&sMutex);
+        events = sEvents;
+    }
+    TypeNames names;
+    QJsonArray traceEvents;
+    for(const auto& event : events) {
+        QJsonObject args;
+        if(!event.fBox.isEmpty()) args["box"] = event.fBox;
+        if(event.fWait >= 0) args["wait_us"] = event.fWait;
+        if(event.fBytes > 0) args["bytes"] = event.fBytes;
+
+        QJsonObject obj;
+        obj["name"] = QString::fromUtf8(names.name(event));
+        obj["cat"] = event.fCategory;
+        obj["pid"] = 1;
+        obj["tid"] = event.fThread;
+        obj["ts"] = event.fStart;
+        if(event.fDuration < 0) {
+            obj["ph"] = "i";
+            obj["s"] = "t";
+        } else {
+            obj["ph"] = "X";
+            obj["dur"] = event.fDuration;
+        }
+        if(!args.isEmpty()) obj["args"] = args;
+        traceEvents.append(obj);
+    }
+    QJsonObject root;
+    root["traceEvents"] = traceEvents;
+    root["displayTimeUnit"] = "ms";
+
+    QFile file(path);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+    const auto data = QJsonDocument(root).toJson(QJsonDocument::Compact);
+    return file.write(data) == data.size();
+}
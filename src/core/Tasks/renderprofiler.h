@@ -0,0 +1,119 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef RENDERPROFILER_H
+#define RENDERPROFILER_H
+
+#include "../core_global.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <atomic>
+#include <typeinfo>
+
+// Records where render time goes. Tasks, effects and encoding are
+// timed per thread along with their queue wait and the memory they
+// allocate. The results can be summarized per task/effect and box, or
+// exported as a Chrome trace (chrome://tracing, ui.perfetto.dev).
+// Nothing is recorded, and scopes cost a single atomic load, unless
+// recording was started.
+class CORE_EXPORT RenderProfiler {
+public:
+    struct Event {
+        const char* fCategory;
+        const char* fName;
+        const std::type_info* fType;
+        QString fBox;
+        int fThread;
+        //! @brief Microseconds since recording started
+        qint64 fStart;
+        //! @brief Microseconds, -1 for instant events
+        qint64 fDuration;
+        //! @brief Microseconds spent qued, -1 if unknown
+        qint64 fWait;
+        qint64 fBytes;
+    };
+
+    struct Summary {
+        QByteArray fCategory;
+        QByteArray fName;
+        QString fBox;
+        int fCount = 0;
+        qint64 fTotal = 0;
+        qint64 fMax = 0;
+        qint64 fWait = 0;
+        qint64 fBytes = 0;
+    };
+
+    // Times the enclosing block. Name it either with a string literal
+    // or with the type of the object doing the work.
+    class CORE_EXPORT Scope {
+    public:
+        Scope(const char* const category, const char* const name);
+        Scope(const char* const category, const std::type_info& type);
+        ~Scope();
+
+        bool active() const { return mActive; }
+
+        void setBox(const QString& box) { mEvent.fBox = box; }
+        void setWait(const qint64 wait) { mEvent.fWait = wait; }
+    private:
+        friend class RenderProfiler;
+
+        void begin();
+
+        const bool mActive;
+        Scope* mParent = nullptr;
+        Event mEvent;
+    };
+
+    static bool sEnabled() {
+        return sRecording.load(std::memory_order_relaxed);
+    }
+
+    static void sStart();
+    static void sStop();
+    static void sClear();
+
+    //! @brief Microseconds since recording started
+    static qint64 sNow();
+    //! @brief Attributes bytes to the innermost scope of this thread
+    static void sAddBytes(const qint64 bytes);
+    static void sInstant(const char* const category,
+                         const char* const name,
+                         const QString& box = QString());
+
+    static int sEventCount();
+    static int sDroppedCount();
+    static QList<Summary> sSummary();
+    static bool sExportChromeTrace(const QString& path);
+
+    static QByteArray sTypeName(const std::type_info& type);
+private:
+    static void sRecord(const Event& event);
+
+    static std::atomic<bool> sRecording;
+};
+
+#endif // RENDERPROFILER_H
@@ -45,9 +45,12 @@ FollowPathEffect::FollowPathEffect() :
     ca_addChild(mInfluence);
 }
 
+// Path is QPainterPath or ArcLengthTable, map takes points
+// from the path to the coordinates of the follower
+template <typename Path>
 void calculateFollowRotPosChange(
-        const SkPath relPath,
-        const QMatrix transform,
+        const Path& path,
+        const QMatrix& map,
         const bool lengthBased,
         const bool rotate,
         const qreal infl,
@@ -55,21 +58,17 @@ void calculateFollowRotPosChange(
         qreal& rotChange,
         qreal& posXChange,
         qreal& posYChange) {
-    SkPath path;
-    relPath.transform(toSkMatrix(transform), &path);
-    const QPainterPath qpath = toQPainterPath(path);
-
     if(lengthBased) {
-        const qreal length = qpath.length();
-        per = qpath.percentAtLength(per*length);
+        const qreal length = path.length();
+        per = path.percentAtLength(per*length);
     }
-    const auto p1 = qpath.pointAtPercent(per);
+    const auto p1 = map.map(path.pointAtPercent(per));
 
     if(rotate) {
         qreal t2 = per + 0.0001;
         const bool reverse = t2 > 1;
         if(reverse) t2 = 0.9999;
-        const auto p2 = qpath.pointAtPercent(t2);
+        const auto p2 = map.map(path.pointAtPercent(t2));
 
         const QLineF baseLine(QPointF(0., 0.), QPointF(100., 0.));
         QLineF l;
@@ -84,6 +83,34 @@ void calculateFollowRotPosChange(
     posYChange = p1.y();
 }
 
+void calculateFollowRotPosChange(
+        const SkPath relPath,
+        const QMatrix transform,
+        const bool lengthBased,
+        const bool rotate,
+        const qreal infl,
+        const qreal per,
+        qreal& rotChange,
+        qreal& posXChange,
+        qreal& posYChange) {
+    SkPath path;
+    relPath.transform(toSkMatrix(transform), &path);
+    const QPainterPath qpath = toQPainterPath(path);
+    calculateFollowRotPosChange(qpath, QMatrix(), lengthBased, rotate,
+                                infl, per, rotChange, posXChange, posYChange);
+}
+
+// arc-length fractions survive only rotation, uniform scaling,
+// reflection and translation
+static bool isSimilarityTransform(const QMatrix& transform) {
+    const qreal m11 = transform.m11();
+    const qreal m12 = transform.m12();
+    const qreal m21 = transform.m21();
+    const qreal m22 = transform.m22();
+    return (isZero6Dec(m11 - m22) && isZero6Dec(m12 + m21)) ||
+           (isZero6Dec(m11 + m22) && isZero6Dec(m12 - m21));
+}
+
 void FollowPathEffect::setRotScaleAfterTargetChange(
         BoundingBox* const oldTarget, BoundingBox* const newTarget) {
     const bool rotate = mRotate->getValue();
@@ -163,7 +190,6 @@ void FollowPathEffect::applyEffect(const qreal relFrame,
 
     const auto transform = targetTransform*parentTransform.inverted();
 
-    const auto relPath = target->getRelativePath(targetRelFrame);
     const qreal infl = mInfluence->getEffectiveValue(relFrame);
     qreal per = mComplete->getEffectiveValue(relFrame);
     const bool rotate = mRotate->getValue();
@@ -173,9 +199,18 @@ void FollowPathEffect::applyEffect(const qreal relFrame,
     qreal posXChange;
     qreal posYChange;
 
-    calculateFollowRotPosChange(relPath, transform,
-                                lengthBased, rotate, infl, per,
-                                rotChange, posXChange, posYChange);
+    const auto table = isSimilarityTransform(transform) ?
+                target->getRelativeArcLengthTable(targetRelFrame) : nullptr;
+    if(table && table->isValid()) {
+        calculateFollowRotPosChange(*table, transform,
+                                    lengthBased, rotate, infl, per,
+                                    rotChange, posXChange, posYChange);
+    } else {
+        const auto relPath = target->getRelativePath(targetRelFrame);
+        calculateFollowRotPosChange(relPath, transform,
+                                    lengthBased, rotate, infl, per,
+                                    rotChange, posXChange, posYChange);
+    }
 
     if(rotate) rot += rotChange;
 
@@ -54,6 +54,9 @@
 #include "simpletask.h"
 #include "themesupport.h"
 #include "efiltersettings.h"
+#include "simplemath.h"
+#include "Tasks/renderprofiler.h"
+#include "Tasks/metricsregistry.h"
 
 using namespace Friction::Core;
 
@@ -143,12 +146,62 @@ void Canvas::setResolution(const qreal percent)
     updateAllBoxes(UpdateReason::userChange);
 }
 
+void Canvas::setPreviewResolutionScale(const qreal scale)
+{
+    if (isZero4Dec(mPreviewResolutionScale - scale)) { return; }
+    mPreviewResolutionScale = scale;
+    // cached frames keep their own resolution,
+    // only the box draw caches need to be redone
+    updateAllBoxes(UpdateReason::frameChange);
+}
+
+// frames rendered by the adaptive preview at a reduced resolution
+static bool isBelowResolution(const SceneFrameContainer * const cont,
+                              const qreal resolution)
+{
+    return cont->fResolution < resolution - 0.0001;
+}
+
+bool Canvas::refineSceneFrame()
+{
+    const int relFrame = anim_getCurrentRelFrame();
+    const auto cont = mSceneFramesHandler.atFrame<SceneFrameContainer>(relFrame);
+    if (!cont || !cont->storesDataInMemory()) { return false; }
+    if (!isBelowResolution(cont, getRenderResolution())) { return false; }
+    mSceneFrameOutdated = true;
+    planUpdate(UpdateReason::frameChange);
+    return true;
+}
+
+bool Canvas::refineNextSceneFrame(const FrameRange& range)
+{
+    const qreal resolution = getRenderResolution();
+    int relFrame = range.fMin;
+    while (relFrame <= range.fMax) {
+        const auto cont = mSceneFramesHandler.atFrame<SceneFrameContainer>(relFrame);
+        if (!cont) {
+            relFrame++;
+            continue;
+        }
+        if (cont->fBoxState == mStateId &&
+            isBelowResolution(cont, resolution)) {
+            if (!mRenderDataHandler.getItemAtRelFrame(relFrame)) {
+                queRender(relFrame, QMatrix());
+            }
+            return true;
+        }
+        relFrame = cont->getRangeMax() + 1;
+    }
+    return false;
+}
+
 void Canvas::invalidateSceneFramesCache()
 {
     mSceneFrame.reset();
     mLoadingSceneFrame.reset();
     mSceneFrameOutdated = true;
     mSceneFramesHandler.clear();
+    mLastComposite.reset();
 }
 
 void Canvas::setCurrentGroupParentAsCurrentGroup()
@@ -883,6 +936,33 @@ void Canvas::setLoadingSceneFrame(const stdsptr<SceneFrameContainer>& cont) {
     }
 }
 
+sk_sp<SkImage> Canvas::linkSceneFrame(const int relFrame,
+                                      const qreal resolution,
+                                      stdsptr<BoxRenderData>& pending) {
+    const auto cont = mSceneFramesHandler.atFrame<SceneFrameContainer>(relFrame);
+    if(cont && cont->fBoxState == mStateId && cont->storesDataInMemory() &&
+       isZero4Dec(cont->fResolution - resolution)) {
+        const auto& img = cont->getImage();
+        if(img && !img->isTextureBacked()) return img;
+    }
+    const auto current = mRenderDataHandler.getItemAtRelFrame(relFrame);
+    if(current && isZero4Dec(current->fResolution - resolution)) {
+        pending = current->ref<BoxRenderData>();
+    } else pending = queRenderAtResolution(relFrame, resolution);
+    return nullptr;
+}
+
+stdsptr<BoxRenderData> Canvas::queRenderAtResolution(const int relFrame,
+                                                     const qreal resolution) {
+    // the boxes read the resolution from the scene while being set up,
+    // only the adaptive preview scales it for the current scene
+    const qreal scale = mPreviewResolutionScale;
+    mPreviewResolutionScale = resolution/mResolution;
+    const auto data = queRender(relFrame, QMatrix());
+    mPreviewResolutionScale = scale;
+    return data;
+}
+
 FrameRange Canvas::prp_getIdenticalRelRange(const int relFrame) const {
     const auto groupRange = ContainerBox::prp_getIdenticalRelRange(relFrame);
     //FrameRange canvasRange{0, mMaxFrame};
@@ -896,11 +976,26 @@ void Canvas::renderDataFinished(BoxRenderData *renderData) {
     const int relFrame = qRound(renderData->fRelFrame);
     mLastStateId = renderData->fBoxStateId;
 
+    const auto canvasData = static_cast<CanvasRenderData*>(renderData);
+    const auto& composite = canvasData->fComposite;
+    const auto& img = renderData->fRenderedImage;
+    if(currentState && composite && img && !img->isTextureBacked()) {
+        composite->fImage = img;
+        mLastComposite = composite;
+    }
+
     const auto range = prp_getIdenticalRelRange(relFrame);
     const auto cont = enve::make_shared<SceneFrameContainer>(
                 this, renderData, range,
                 currentState ? &mSceneFramesHandler : nullptr);
-    if(currentState) mSceneFramesHandler.add(cont);
+    if(currentState) {
+        // replaces frames kept from a reduced resolution preview
+        const auto prev = mSceneFramesHandler.atFrame<SceneFrameContainer>(relFrame);
+        if(prev && isBelowResolution(prev, cont->fResolution)) {
+            mSceneFramesHandler.remove(range);
+        }
+        mSceneFramesHandler.add(cont);
+    }
 
     if(!mPreviewing && !mRenderingOutput){
         bool newerSate = true;
@@ -915,7 +1010,10 @@ void Canvas::renderDataFinished(BoxRenderData *renderData) {
                                           qAbs(cRelFrame - cRange.fMax));
             closerFrame = finishedFrameDist < oldFrameDist;
         }
-        if(newerSate || closerFrame) {
+        const bool sharper = mSceneFrame &&
+                             isBelowResolution(mSceneFrame.get(), cont->fResolution) &&
+                             mSceneFrame->getRange().inRange(relFrame);
+        if(newerSate || closerFrame || sharper) {
             mSceneFrameOutdated = !currentState;
             setSceneFrame(cont);
         }
@@ -1259,13 +1357,28 @@ void Canvas::anim_setAbsFrame(const int frame)
     const int newRelFrame = anim_getCurrentRelFrame();
 
     const auto cont = mSceneFramesHandler.atFrame<SceneFrameContainer>(newRelFrame);
+    static auto& hits = MetricsRegistry::sCounter("cache.scene_frames.hits");
+    static auto& misses = MetricsRegistry::sCounter("cache.scene_frames.misses");
+    if (cont && cont->storesDataInMemory()) { hits.add(); }
+    else { misses.add(); }
+    if (RenderProfiler::sEnabled()) {
+        RenderProfiler::sInstant("cache", cont ? "scene frame hit" :
+                                                 "scene frame miss",
+                                 prp_getName());
+    }
     if (cont) {
-        if (cont->storesDataInMemory()) {
-            setSceneFrame(cont->ref<SceneFrameContainer>());
-        } else {
-            setLoadingSceneFrame(cont->ref<SceneFrameContainer>());
+        // a streaming preview renders ahead of the frame it displays
+        const bool streaming = mPreviewing && mRenderingPreview;
+        if (!streaming) {
+            if (cont->storesDataInMemory()) {
+                setSceneFrame(cont->ref<SceneFrameContainer>());
+            } else {
+                setLoadingSceneFrame(cont->ref<SceneFrameContainer>());
+            }
         }
         mSceneFrameOutdated = !cont->storesDataInMemory();
+        // a reduced resolution frame stays visible until refined
+        if (!mPreviewing || streaming) { refineSceneFrame(); }
     } else {
         mSceneFrameOutdated = true;
         planUpdate(UpdateReason::frameChange);
@@ -1599,6 +1712,32 @@ void Canvas::readBoundingBox(eReadStream& src)
     clearGradientRWIds();
 }
 
+void Canvas::setDeferredContent(const DeferredContent &read,
+                                const DeferredWrite &write)
+{
+    mDeferredContent = read;
+    mDeferredWrite = write;
+}
+
+bool Canvas::writeDeferredContent(eWriteStream &dst) const
+{
+    if (!mDeferredContent || !mDeferredWrite) { return false; }
+    return mDeferredWrite(dst);
+}
+
+void Canvas::loadDeferredContent()
+{
+    if (!mDeferredContent) { return; }
+    const DeferredContent read = mDeferredContent;
+    mDeferredContent = nullptr;
+    mDeferredWrite = nullptr;
+    try {
+        read();
+    } catch (const std::exception &e) {
+        gPrintExceptionCritical(e);
+    }
+}
+
 void Canvas::writeMarkers(eWriteStream &dst) const
 {
     dst << mIn.enabled;
@@ -193,6 +193,24 @@ public:
                           qreal devicePixelRatio);
     void setResolution(const qreal percent);
     void invalidateSceneFramesCache();
+    //! @brief Scales the resolution of newly rendered frames without
+    //! invalidating cached ones, used by the adaptive preview
+    void setPreviewResolutionScale(const qreal scale);
+    qreal getPreviewResolutionScale() const
+    {
+        return mPreviewResolutionScale;
+    }
+    //! @brief Resolution new frames are rendered at
+    qreal getRenderResolution() const
+    {
+        return mResolution*mPreviewResolutionScale;
+    }
+    //! @brief Renders the current frame again if it is only cached
+    //! at a lower resolution, returns true if an update was planned
+    bool refineSceneFrame();
+    //! @brief Queues a render of the first frame in range that is only
+    //! cached at a lower resolution, returns false if there is none left
+    bool refineNextSceneFrame(const FrameRange& range);
 
     void applyCurrentTransformToSelected();
     QPointF getSelectedPointsAbsPivotPos();
@@ -425,6 +443,9 @@ public:
         canvasData->fBgColor = toSkColor(mBackgroundColor->getColor());
         canvasData->fCanvasHeight = mHeight;
         canvasData->fCanvasWidth = mWidth;
+        if (!mRenderingOutput) {
+            canvasData->fPreviousComposite = mLastComposite;
+        }
     }
 
     bool clipToCanvas()
@@ -542,6 +563,12 @@ public:
     void setSceneFrame(const int relFrame);
     void setSceneFrame(const stdsptr<SceneFrameContainer> &cont);
     void setLoadingSceneFrame(const stdsptr<SceneFrameContainer> &cont);
+    //! @brief Frame image for scene links rendered at resolution,
+    //! if it is not cached in memory returns null and sets pending
+    //! to the (possibly newly queued) render data producing it
+    sk_sp<SkImage> linkSceneFrame(const int relFrame,
+                                  const qreal resolution,
+                                  stdsptr<BoxRenderData>& pending);
 
     void setRenderingPreview(const bool bT);
 
@@ -616,6 +643,21 @@ public:
     void readSettings(eReadStream &src);
     void writeBoundingBox(eWriteStream& dst) const;
     void readBoundingBox(eReadStream& src);
+
+    // content read postponed until the scene is first needed,
+    // until then saving copies the unread content as it was
+    using DeferredContent = stdfunc<void()>;
+    using DeferredWrite = stdfunc<bool(eWriteStream&)>;
+    void setDeferredContent(const DeferredContent& read,
+                            const DeferredWrite& write = nullptr);
+    //! @brief Returns false if the content has to be loaded and written
+    bool writeDeferredContent(eWriteStream& dst) const;
+    bool hasDeferredContent() const
+    {
+        return static_cast<bool>(mDeferredContent);
+    }
+    void loadDeferredContent();
+
     void writeMarkers(eWriteStream &dst) const;
     void readMarkers(eReadStream &src);
 
@@ -759,6 +801,9 @@ public:
     void removeNullObject(NullObject* const obj);
 
 private:
+    //! @brief Queues a render with every box set up at resolution
+    stdsptr<BoxRenderData> queRenderAtResolution(const int relFrame,
+                                                 const qreal resolution);
     void addGradient(const qsptr<SceneBoundGradient> &grad);
 
     void readGradients(eReadStream &src);
@@ -842,6 +887,8 @@ private:
 
     QList<qsptr<SceneBoundGradient>> mGradients;
     QList<NullObject*> mNullObjects;
+    DeferredContent mDeferredContent;
+    DeferredWrite mDeferredWrite;
 
 protected:
     Document& mDocument;
@@ -866,6 +913,7 @@ protected:
 
     uint mLastStateId = 0;
     HddCachableCacheHandler mSceneFramesHandler;
+    std::shared_ptr<CanvasComposite> mLastComposite;
 
     qsptr<ColorAnimator> mBackgroundColor = enve::make_shared<ColorAnimator>();
 
@@ -881,6 +929,7 @@ protected:
     FrameRange mRange{0, 200};
 
     qreal mResolution = 0.5;
+    qreal mPreviewResolutionScale = 1;
 
     qptr<BoundingBox> mCurrentBox;
     qptr<Circle> mCurrentCircle;
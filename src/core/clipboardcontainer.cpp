@@ -30,6 +30,7 @@
 #include "PathEffects/patheffectcollection.h"
 #include "Animators/SmartPath/smartpathcollection.h"
 #include "Properties/boxtargetproperty.h"
+#include "ReadWrite/projectwriter.h"
 
 Clipboard::Clipboard(const ClipboardType type) : mType(type) {}
 
@@ -57,6 +58,8 @@ void Clipboard::read(const Clipboard::Reader &reader) {
 
 BoxesClipboard::BoxesClipboard(const QList<BoundingBox*> &src) :
     Clipboard(ClipboardType::boxes) {
+    // box write ids are shared with a project that is being written
+    ProjectWriter::sFinishAll();
     const auto writer = [&src](eWriteStream& writeStream) {
         const int nBoxes = src.count();
         writeStream << nBoxes;
@@ -0,0 +1,102 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "pixelbufferpool.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// free buffers kept per byte size and in total, the rest goes back to free
+#define POOL_MAX_FREE 4
+#define POOL_MAX_CACHED_BYTES (qint64(256)*1024*1024)
+
+struct PixelBuffers {
+    std::mutex fMutex;
+    std::map<size_t, std::vector<void*>> fFree;
+    std::atomic<qint64> fCachedBytes{0};
+};
+
+// never destroyed, images may still be released
+// from static destructors after main returns
+static PixelBuffers& sBuffers() {
+    static const auto sInstance = new PixelBuffers;
+    return *sInstance;
+}
+
+static void releasePixels(void* addr, void* context) {
+    const size_t size = reinterpret_cast<size_t>(context);
+    auto& buffers = sBuffers();
+    {
+        std::lock_guard<std::mutex> lock(buffers.fMutex);
+        auto& sizeFree = buffers.fFree[size];
+        if(sizeFree.size() < POOL_MAX_FREE &&
+           buffers.fCachedBytes + qint64(size) <= POOL_MAX_CACHED_BYTES) {
+            sizeFree.push_back(addr);
+            buffers.fCachedBytes += qint64(size);
+            return;
+        }
+    }
+    std::free(addr);
+}
+
+bool PixelBufferPool::sAllocPixels(SkBitmap& bitmap, const SkImageInfo& info) {
+    const size_t rowBytes = info.minRowBytes();
+    const size_t size = info.computeByteSize(rowBytes);
+    if(SkImageInfo::ByteSizeOverflowed(size) || size == 0) return false;
+    auto& buffers = sBuffers();
+    void* addr = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(buffers.fMutex);
+        const auto it = buffers.fFree.find(size);
+        if(it != buffers.fFree.end() && !it->second.empty()) {
+            addr = it->second.back();
+            it->second.pop_back();
+            buffers.fCachedBytes -= qint64(size);
+        }
+    }
+    if(!addr) addr = std::malloc(size);
+    if(!addr) return false;
+    // releasePixels is called right away if installing fails
+    return bitmap.installPixels(info, addr, rowBytes, releasePixels,
+                                reinterpret_cast<void*>(size));
+}
+
+void PixelBufferPool::sTrim() {
+    auto& buffers = sBuffers();
+    std::map<size_t, std::vector<void*>> cached;
+    {
+        std::lock_guard<std::mutex> lock(buffers.fMutex);
+        cached.swap(buffers.fFree);
+        buffers.fCachedBytes = 0;
+    }
+    for(const auto& sizeBuffers : cached) {
+        for(const auto addr : sizeBuffers.second) std::free(addr);
+    }
+}
+
+qint64 PixelBufferPool::sCachedBytes() {
+    return sBuffers().fCachedBytes;
+}
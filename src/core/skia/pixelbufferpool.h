@@ -0,0 +1,47 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef PIXELBUFFERPOOL_H
+#define PIXELBUFFERPOOL_H
+
+#include "../core_global.h"
+
+#include "skiaincludes.h"
+
+// Recycles the pixel memory of decoded video frames, reloaded cache
+// images and box renders. Frames of one video or scene mostly share
+// a size, so a released buffer is handed to the next frame instead of
+// going back to the system allocator.
+class CORE_EXPORT PixelBufferPool {
+public:
+    //! @brief Allocates the pixels of bitmap with minimal row bytes,
+    //! the memory returns to the pool once the bitmap and every image
+    //! made from it are gone
+    static bool sAllocPixels(SkBitmap& bitmap, const SkImageInfo& info);
+
+    //! @brief Returns all cached buffers to the system allocator
+    static void sTrim();
+    static qint64 sCachedBytes();
+};
+
+#endif // PIXELBUFFERPOOL_H
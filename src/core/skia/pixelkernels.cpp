@@ -0,0 +1,413 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "pixelkernels.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PIXELKERNELS_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define PIXELKERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+// exact round(x/255) for x <= 255*255
+static inline uint32_t div255(const uint32_t x) {
+    const uint32_t y = x + 128;
+    return (y + (y >> 8)) >> 8;
+}
+
+// 16.16 fixed point 255/alpha
+static const auto gUnpremulScale = []() {
+    struct { uint32_t fScale[256]; } table;
+    table.fScale[0] = 0;
+    for(uint32_t a = 1; a < 256; a++) {
+        table.fScale[a] = (255*65536 + a/2)/a;
+    }
+    return table;
+}();
+
+static void premultiplyScalar(const uint8_t* src, uint8_t* dst,
+                              const int count) {
+    for(int i = 0; i < count; i++, src += 4, dst += 4) {
+        const uint32_t a = src[3];
+        dst[0] = static_cast<uint8_t>(div255(src[0]*a));
+        dst[1] = static_cast<uint8_t>(div255(src[1]*a));
+        dst[2] = static_cast<uint8_t>(div255(src[2]*a));
+        dst[3] = static_cast<uint8_t>(a);
+    }
+}
+
+static void unpremultiplyScalar(const uint8_t* src, uint8_t* dst,
+                                const int count) {
+    for(int i = 0; i < count; i++, src += 4, dst += 4) {
+        const uint32_t a = src[3];
+        const uint32_t scale = gUnpremulScale.fScale[a];
+        dst[0] = static_cast<uint8_t>(std::min(255u, (src[0]*scale + 32768) >> 16));
+        dst[1] = static_cast<uint8_t>(std::min(255u, (src[1]*scale + 32768) >> 16));
+        dst[2] = static_cast<uint8_t>(std::min(255u, (src[2]*scale + 32768) >> 16));
+        dst[3] = static_cast<uint8_t>(a);
+    }
+}
+
+static void swapRedBlueScalar(const uint8_t* src, uint8_t* dst,
+                              const int count) {
+    for(int i = 0; i < count; i++, src += 4, dst += 4) {
+        const uint8_t r = src[0];
+        dst[0] = src[2];
+        dst[1] = src[1];
+        dst[2] = r;
+        dst[3] = src[3];
+    }
+}
+
+const char* PixelKernels::instructionSet() {
+#if defined(PIXELKERNELS_SSE2)
+    return "SSE2";
+#elif defined(PIXELKERNELS_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+void PixelKernels::premultiply(const uint8_t* src, uint8_t* dst,
+                               const int count) {
+    int i = 0;
+#if defined(PIXELKERNELS_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rgbMask = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+    const __m128i alphaLane = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+    const __m128i half = _mm_set1_epi16(128);
+    const auto mul = [&](const __m128i px) {
+        __m128i alpha = _mm_shufflelo_epi16(px, _MM_SHUFFLE(3, 3, 3, 3));
+        alpha = _mm_shufflehi_epi16(alpha, _MM_SHUFFLE(3, 3, 3, 3));
+        alpha = _mm_or_si128(_mm_and_si128(alpha, rgbMask), alphaLane);
+        const __m128i y = _mm_add_epi16(_mm_mullo_epi16(px, alpha), half);
+        return _mm_srli_epi16(_mm_add_epi16(y, _mm_srli_epi16(y, 8)), 8);
+    };
+    for(; i + 4 <= count; i += 4) {
+        const __m128i px = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(src + 4*i));
+        const __m128i lo = mul(_mm_unpacklo_epi8(px, zero));
+        const __m128i hi = mul(_mm_unpackhi_epi8(px, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4*i),
+                         _mm_packus_epi16(lo, hi));
+    }
+#elif defined(PIXELKERNELS_NEON)
+    for(; i + 8 <= count; i += 8) {
+        uint8x8x4_t px = vld4_u8(src + 4*i);
+        const uint8x8_t a = px.val[3];
+        for(int c = 0; c < 3; c++) {
+            const uint16x8_t x = vmull_u8(px.val[c], a);
+            px.val[c] = vraddhn_u16(x, vrshrq_n_u16(x, 8));
+        }
+        vst4_u8(dst + 4*i, px);
+    }
+#endif
+    premultiplyScalar(src + 4*i, dst + 4*i, count - i);
+}
+
+void PixelKernels::unpremultiply(const uint8_t* src, uint8_t* dst,
+                                 const int count) {
+    int i = 0;
+#if defined(PIXELKERNELS_SSE2)
+    const __m128i byteMask = _mm_set1_epi32(0xFF);
+    const __m128i opaque = _mm_set1_epi32(0xFF);
+    const __m128 maxValue = _mm_set1_ps(255.f);
+    const __m128 zeroF = _mm_setzero_ps();
+    for(; i + 4 <= count; i += 4) {
+        const __m128i px = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(src + 4*i));
+        __m128i* const dstPx = reinterpret_cast<__m128i*>(dst + 4*i);
+        const __m128i alpha = _mm_srli_epi32(px, 24);
+        if(_mm_movemask_epi8(_mm_cmpeq_epi32(alpha, opaque)) == 0xFFFF) {
+            _mm_storeu_si128(dstPx, px);
+            continue;
+        }
+        const __m128 alphaF = _mm_cvtepi32_ps(alpha);
+        const __m128 scale = _mm_and_ps(_mm_div_ps(maxValue, alphaF),
+                                        _mm_cmpneq_ps(alphaF, zeroF));
+        __m128i result = _mm_slli_epi32(alpha, 24);
+        for(int c = 0; c < 3; c++) {
+            const __m128i channel = _mm_and_si128(_mm_srli_epi32(px, 8*c),
+                                                  byteMask);
+            const __m128 value = _mm_min_ps(_mm_mul_ps(_mm_cvtepi32_ps(channel),
+                                                       scale), maxValue);
+            result = _mm_or_si128(result, _mm_slli_epi32(_mm_cvtps_epi32(value),
+                                                         8*c));
+        }
+        _mm_storeu_si128(dstPx, result);
+    }
+#elif defined(PIXELKERNELS_NEON)
+    const float32x4_t maxValue = vdupq_n_f32(255.f);
+    for(; i + 4 <= count; i += 4) {
+        const uint32x4_t px = vld1q_u32(reinterpret_cast<const uint32_t*>(src + 4*i));
+        const uint32x4_t alpha = vshrq_n_u32(px, 24);
+        const float32x4_t alphaF = vcvtq_f32_u32(alpha);
+        float32x4_t inv = vrecpeq_f32(alphaF);
+        inv = vmulq_f32(vrecpsq_f32(alphaF, inv), inv);
+        inv = vmulq_f32(vrecpsq_f32(alphaF, inv), inv);
+        const uint32x4_t nonZero = vtstq_u32(alpha, alpha);
+        const float32x4_t scale = vreinterpretq_f32_u32(
+                    vandq_u32(vreinterpretq_u32_f32(vmulq_f32(inv, maxValue)),
+                              nonZero));
+        uint32x4_t result = vshlq_n_u32(alpha, 24);
+        const uint32x4_t byteMask = vdupq_n_u32(0xFF);
+        const uint32x4_t r = vandq_u32(px, byteMask);
+        const uint32x4_t g = vandq_u32(vshrq_n_u32(px, 8), byteMask);
+        const uint32x4_t b = vandq_u32(vshrq_n_u32(px, 16), byteMask);
+        const auto scaled = [&](const uint32x4_t channel) {
+            const float32x4_t value = vminq_f32(vmulq_f32(vcvtq_f32_u32(channel),
+                                                          scale), maxValue);
+            return vcvtq_u32_f32(vaddq_f32(value, vdupq_n_f32(0.5f)));
+        };
+        result = vorrq_u32(result, scaled(r));
+        result = vorrq_u32(result, vshlq_n_u32(scaled(g), 8));
+        result = vorrq_u32(result, vshlq_n_u32(scaled(b), 16));
+        vst1q_u32(reinterpret_cast<uint32_t*>(dst + 4*i), result);
+    }
+#endif
+    unpremultiplyScalar(src + 4*i, dst + 4*i, count - i);
+}
+
+void PixelKernels::swapRedBlue(const uint8_t* src, uint8_t* dst,
+                               const int count) {
+    int i = 0;
+#if defined(PIXELKERNELS_SSE2)
+    const __m128i agMask = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+    const __m128i byteMask = _mm_set1_epi32(0xFF);
+    for(; i + 4 <= count; i += 4) {
+        const __m128i px = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(src + 4*i));
+        const __m128i ag = _mm_and_si128(px, agMask);
+        const __m128i r = _mm_slli_epi32(_mm_and_si128(px, byteMask), 16);
+        const __m128i b = _mm_and_si128(_mm_srli_epi32(px, 16), byteMask);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4*i),
+                         _mm_or_si128(ag, _mm_or_si128(r, b)));
+    }
+#elif defined(PIXELKERNELS_NEON)
+    for(; i + 16 <= count; i += 16) {
+        uint8x16x4_t px = vld4q_u8(src + 4*i);
+        const uint8x16_t r = px.val[0];
+        px.val[0] = px.val[2];
+        px.val[2] = r;
+        vst4q_u8(dst + 4*i, px);
+    }
+#endif
+    swapRedBlueScalar(src + 4*i, dst + 4*i, count - i);
+}
+
+static inline uint8_t lumaBT601(const int r, const int g, const int b) {
+    return static_cast<uint8_t>(((66*r + 129*g + 25*b + 128) >> 8) + 16);
+}
+
+static inline uint8_t chromaBT601(const int sum) {
+    return static_cast<uint8_t>(((sum + 128) >> 8) + 128);
+}
+
+// converts pixels [x, width) of a pair of rows, x has to be even
+static void yuv420pRowsScalar(const uint8_t* const row0,
+                              const uint8_t* const row1,
+                              uint8_t* const yRow0, uint8_t* const yRow1,
+                              uint8_t* const uRow, uint8_t* const vRow,
+                              int x, const int width) {
+    for(; x < width; x += 2) {
+        const int x1 = x + 1 < width ? x + 1 : x;
+        const uint8_t* const p00 = row0 + 4*x;
+        const uint8_t* const p01 = row0 + 4*x1;
+        const uint8_t* const p10 = row1 + 4*x;
+        const uint8_t* const p11 = row1 + 4*x1;
+        yRow0[x] = lumaBT601(p00[0], p00[1], p00[2]);
+        if(x1 != x) yRow0[x1] = lumaBT601(p01[0], p01[1], p01[2]);
+        if(yRow1) {
+            yRow1[x] = lumaBT601(p10[0], p10[1], p10[2]);
+            if(x1 != x) yRow1[x1] = lumaBT601(p11[0], p11[1], p11[2]);
+        }
+        const int r = (p00[0] + p01[0] + p10[0] + p11[0] + 2) >> 2;
+        const int g = (p00[1] + p01[1] + p10[1] + p11[1] + 2) >> 2;
+        const int b = (p00[2] + p01[2] + p10[2] + p11[2] + 2) >> 2;
+        uRow[x/2] = chromaBT601(-38*r - 74*g + 112*b);
+        vRow[x/2] = chromaBT601(112*r - 94*g - 18*b);
+    }
+}
+
+#if defined(PIXELKERNELS_SSE2)
+// sums the two 32 bit halves of every pixel produced by _mm_madd_epi16
+static inline __m128i sumPixelHalves(const __m128i lo, const __m128i hi) {
+    const __m128 loF = _mm_castsi128_ps(lo);
+    const __m128 hiF = _mm_castsi128_ps(hi);
+    const __m128i even = _mm_castps_si128(
+                _mm_shuffle_ps(loF, hiF, _MM_SHUFFLE(2, 0, 2, 0)));
+    const __m128i odd = _mm_castps_si128(
+                _mm_shuffle_ps(loF, hiF, _MM_SHUFFLE(3, 1, 3, 1)));
+    return _mm_add_epi32(even, odd);
+}
+
+// 4 RGBA pixels -> 4 luma values in 32 bit lanes
+static inline __m128i lumaSSE2(const __m128i px) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i coeffs = _mm_set_epi16(0, 25, 129, 66, 0, 25, 129, 66);
+    const __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(px, zero), coeffs);
+    const __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(px, zero), coeffs);
+    const __m128i sum = _mm_add_epi32(sumPixelHalves(lo, hi),
+                                      _mm_set1_epi32(128));
+    return _mm_add_epi32(_mm_srai_epi32(sum, 8), _mm_set1_epi32(16));
+}
+
+// 4 averaged RGBA samples (16 bit) -> 4 chroma values in 32 bit lanes
+static inline __m128i chromaSSE2(const __m128i avg01, const __m128i avg23,
+                                 const __m128i coeffs) {
+    const __m128i sum = _mm_add_epi32(
+                sumPixelHalves(_mm_madd_epi16(avg01, coeffs),
+                               _mm_madd_epi16(avg23, coeffs)),
+                _mm_set1_epi32(128));
+    return _mm_add_epi32(_mm_srai_epi32(sum, 8), _mm_set1_epi32(128));
+}
+
+static inline void storeLumaSSE2(uint8_t* const dst,
+                                 const __m128i px0, const __m128i px1) {
+    const __m128i luma = _mm_packs_epi32(lumaSSE2(px0), lumaSSE2(px1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst),
+                     _mm_packus_epi16(luma, luma));
+}
+
+static int yuv420pRowsSSE2(const uint8_t* const row0,
+                           const uint8_t* const row1,
+                           uint8_t* const yRow0, uint8_t* const yRow1,
+                           uint8_t* const uRow, uint8_t* const vRow,
+                           const int width) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i two = _mm_set1_epi16(2);
+    const __m128i uCoeffs = _mm_set_epi16(0, 112, -74, -38, 0, 112, -74, -38);
+    const __m128i vCoeffs = _mm_set_epi16(0, -18, -94, 112, 0, -18, -94, 112);
+    // 2x2 block sums of 2 chroma samples, rounded to their average
+    const auto average = [&](const __m128i a, const __m128i b) {
+        const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero),
+                                         _mm_unpacklo_epi8(b, zero));
+        const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero),
+                                         _mm_unpackhi_epi8(b, zero));
+        const __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(lo, hi),
+                                          _mm_unpackhi_epi64(lo, hi));
+        return _mm_srli_epi16(_mm_add_epi16(sum, two), 2);
+    };
+    int x = 0;
+    for(; x + 8 <= width; x += 8) {
+        const __m128i a0 = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(row0 + 4*x));
+        const __m128i a1 = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(row0 + 4*x + 16));
+        const __m128i b0 = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(row1 + 4*x));
+        const __m128i b1 = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(row1 + 4*x + 16));
+        storeLumaSSE2(yRow0 + x, a0, a1);
+        if(yRow1) storeLumaSSE2(yRow1 + x, b0, b1);
+        const __m128i avg01 = average(a0, b0);
+        const __m128i avg23 = average(a1, b1);
+        const __m128i u = chromaSSE2(avg01, avg23, uCoeffs);
+        const __m128i v = chromaSSE2(avg01, avg23, vCoeffs);
+        const __m128i uv = _mm_packus_epi16(_mm_packs_epi32(u, v), zero);
+        uint8_t packed[8];
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(packed), uv);
+        std::memcpy(uRow + x/2, packed, 4);
+        std::memcpy(vRow + x/2, packed + 4, 4);
+    }
+    return x;
+}
+#elif defined(PIXELKERNELS_NEON)
+static int yuv420pRowsNEON(const uint8_t* const row0,
+                           const uint8_t* const row1,
+                           uint8_t* const yRow0, uint8_t* const yRow1,
+                           uint8_t* const uRow, uint8_t* const vRow,
+                           const int width) {
+    const auto luma = [](const uint8x8x4_t& px) {
+        uint16x8_t sum = vmull_u8(px.val[0], vdup_n_u8(66));
+        sum = vmlal_u8(sum, px.val[1], vdup_n_u8(129));
+        sum = vmlal_u8(sum, px.val[2], vdup_n_u8(25));
+        sum = vaddq_u16(sum, vdupq_n_u16(128));
+        return vadd_u8(vshrn_n_u16(sum, 8), vdup_n_u8(16));
+    };
+    // rounded average of every 2x2 block of one channel
+    const auto average = [](const uint8x8_t a, const uint8x8_t b) {
+        const uint16x8_t sum = vaddl_u8(a, b);
+        const uint16x4_t pairs = vpadd_u16(vget_low_u16(sum),
+                                           vget_high_u16(sum));
+        return vreinterpret_s16_u16(vrshr_n_u16(pairs, 2));
+    };
+    const auto chroma = [](const int16x4_t r, const int16x4_t g,
+                           const int16x4_t b, const int16_t cr,
+                           const int16_t cg, const int16_t cb) {
+        int32x4_t sum = vmull_n_s16(r, cr);
+        sum = vmlal_n_s16(sum, g, cg);
+        sum = vmlal_n_s16(sum, b, cb);
+        sum = vaddq_s32(sum, vdupq_n_s32(128));
+        return vmovn_s32(vaddq_s32(vshrq_n_s32(sum, 8), vdupq_n_s32(128)));
+    };
+    int x = 0;
+    for(; x + 8 <= width; x += 8) {
+        const uint8x8x4_t a = vld4_u8(row0 + 4*x);
+        const uint8x8x4_t b = vld4_u8(row1 + 4*x);
+        vst1_u8(yRow0 + x, luma(a));
+        if(yRow1) vst1_u8(yRow1 + x, luma(b));
+        const int16x4_t r = average(a.val[0], b.val[0]);
+        const int16x4_t g = average(a.val[1], b.val[1]);
+        const int16x4_t bl = average(a.val[2], b.val[2]);
+        const uint8x8_t uv = vqmovun_s16(
+                    vcombine_s16(chroma(r, g, bl, -38, -74, 112),
+                                 chroma(r, g, bl, 112, -94, -18)));
+        uint8_t packed[8];
+        vst1_u8(packed, uv);
+        std::memcpy(uRow + x/2, packed, 4);
+        std::memcpy(vRow + x/2, packed + 4, 4);
+    }
+    return x;
+}
+#endif
+
+void PixelKernels::rgbaToYuv420p(const uint8_t* src, const int srcStride,
+                                 const int width, const int height,
+                                 uint8_t* const planes[3],
+                                 const int strides[3]) {
+    for(int y = 0; y < height; y += 2) {
+        const uint8_t* const row0 = src + y*srcStride;
+        const uint8_t* const row1 = y + 1 < height ? row0 + srcStride : row0;
+        uint8_t* const yRow0 = planes[0] + y*strides[0];
+        uint8_t* const yRow1 = y + 1 < height ? yRow0 + strides[0] : nullptr;
+        uint8_t* const uRow = planes[1] + (y/2)*strides[1];
+        uint8_t* const vRow = planes[2] + (y/2)*strides[2];
+#if defined(PIXELKERNELS_SSE2)
+        const int x = yuv420pRowsSSE2(row0, row1, yRow0, yRow1,
+                                      uRow, vRow, width);
+#elif defined(PIXELKERNELS_NEON)
+        const int x = yuv420pRowsNEON(row0, row1, yRow0, yRow1,
+                                      uRow, vRow, width);
+#else
+        const int x = 0;
+#endif
+        yuv420pRowsScalar(row0, row1, yRow0, yRow1, uRow, vRow, x, width);
+    }
+}
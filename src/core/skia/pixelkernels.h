@@ -0,0 +1,55 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef PIXELKERNELS_H
+#define PIXELKERNELS_H
+
+#include "../core_global.h"
+
+#include <cstdint>
+
+// Per-pixel conversions of 8 bit RGBA (byte order R, G, B, A) rows.
+// Every kernel accepts src == dst. Uses SSE2 or NEON when the target
+// has them, the scalar versions produce the same result within 1.
+namespace PixelKernels {
+    //! @brief Vector instruction set the kernels were built with
+    CORE_EXPORT
+    const char* instructionSet();
+
+    CORE_EXPORT
+    void premultiply(const uint8_t* src, uint8_t* dst, const int count);
+    CORE_EXPORT
+    void unpremultiply(const uint8_t* src, uint8_t* dst, const int count);
+    //! @brief RGBA <-> BGRA
+    CORE_EXPORT
+    void swapRedBlue(const uint8_t* src, uint8_t* dst, const int count);
+
+    //! @brief Converts a RGBA image to planar BT.601 limited range
+    //! YUV 4:2:0, chroma is the average of each 2x2 block
+    CORE_EXPORT
+    void rgbaToYuv420p(const uint8_t* src, const int srcStride,
+                       const int width, const int height,
+                       uint8_t* const planes[3], const int strides[3]);
+}
+
+#endif // PIXELKERNELS_H
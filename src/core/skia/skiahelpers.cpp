@@ -25,6 +25,14 @@
 
 #include "skiahelpers.h"
 #include "exceptions.h"
+#include "pixelkernels.h"
+#include "pixelbufferpool.h"
+
+#include <cstring>
+#include <vector>
+
+// bytes converted before each write of a non RGBA premul pixmap
+#define WRITE_CHUNK_BYTES (256*1024)
 
 sk_sp<SkImage> SkiaHelpers::makeCopy(const sk_sp<SkImage>& img) {
     if(!img) return nullptr;
@@ -80,10 +88,14 @@ sk_sp<SkImage> SkiaHelpers::transferDataToSkImage(SkBitmap &bitmap) {
 void SkiaHelpers::writeImg(const sk_sp<SkImage> &img,
                            eWriteStream& dst) {
     SkPixmap pix;
-    if(!img->peekPixels(&pix)) {
-        if(!img->makeRasterImage()->peekPixels(&pix)) {
-            RuntimeThrow("Could not peek image pixels");
-        }
+    if(img->peekPixels(&pix)) {
+        writePixmap(pix, dst);
+        return;
+    }
+    // keep the raster copy alive while its pixels are written
+    const auto raster = img->makeRasterImage();
+    if(!raster || !raster->peekPixels(&pix)) {
+        RuntimeThrow("Could not peek image pixels");
     }
     writePixmap(pix, dst);
 }
@@ -99,9 +111,33 @@ void SkiaHelpers::writePixmap(const SkPixmap &pix,
     const int height = pix.height();
     dst << width;
     dst << height;
-    const qint64 writeBytes = width*height*4*
-            static_cast<qint64>(sizeof(uchar));
-    dst.write(pix.addr(), writeBytes);
+    const size_t rowBytes = static_cast<size_t>(width)*4;
+    const bool rgba = pix.colorType() == kRGBA_8888_SkColorType;
+    const bool premul = pix.alphaType() != kUnpremul_SkAlphaType;
+    if(rgba && premul && pix.rowBytes() == rowBytes) {
+        dst.write(pix.addr(), static_cast<qint64>(rowBytes)*height);
+        return;
+    }
+    if(!rgba && pix.colorType() != kBGRA_8888_SkColorType) {
+        RuntimeThrow("Unsupported pixel format");
+    }
+    // stored as premultiplied RGBA, convert a few rows at a time
+    static thread_local std::vector<uint8_t> tBuffer;
+    const int chunkRows = qBound(1, int(WRITE_CHUNK_BYTES/qMax(rowBytes,
+                                                              size_t(1))),
+                                 qMax(height, 1));
+    tBuffer.resize(rowBytes*chunkRows);
+    for(int y = 0; y < height; y += chunkRows) {
+        const int rows = qMin(chunkRows, height - y);
+        for(int i = 0; i < rows; i++) {
+            const auto src = static_cast<const uint8_t*>(pix.addr(0, y + i));
+            const auto row = tBuffer.data() + i*rowBytes;
+            if(rgba) std::memcpy(row, src, rowBytes);
+            else PixelKernels::swapRedBlue(src, row, width);
+            if(!premul) PixelKernels::premultiply(row, row, width);
+        }
+        dst.write(tBuffer.data(), static_cast<qint64>(rowBytes)*rows);
+    }
 }
 
 SkBitmap SkiaHelpers::readBitmap(eReadStream &src) {
@@ -109,10 +145,12 @@ SkBitmap SkiaHelpers::readBitmap(eReadStream &src) {
     src >> width;
     src >> height;
     SkBitmap btmp;
+    if(width <= 0 || height <= 0) return btmp;
     const auto info = SkiaHelpers::getPremulRGBAInfo(width, height);
-    btmp.allocPixels(info);
-    const qint64 readBytes = width*height*4*
-            static_cast<qint64>(sizeof(uchar));
+    if(!PixelBufferPool::sAllocPixels(btmp, info)) {
+        RuntimeThrow("Could not allocate image pixels");
+    }
+    const qint64 readBytes = static_cast<qint64>(width)*height*4;
     src.read(btmp.getPixels(), readBytes);
     return btmp;
 }
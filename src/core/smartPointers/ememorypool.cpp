@@ -0,0 +1,142 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "ememorypool.h"
+
+#include <cstdlib>
+
+// size classes are multiples of POOL_GRANULARITY up to POOL_MAX_SIZE
+#define POOL_GRANULARITY 16
+#define POOL_MAX_SIZE 2048
+#define POOL_CLASS_COUNT (POOL_MAX_SIZE/POOL_GRANULARITY)
+// free blocks kept per size class, the rest goes back to malloc
+#define POOL_MAX_FREE 1024
+
+eMemoryPool::eMemoryPool(const QString& name) :
+    mName(name), mClasses(new SizeClass[POOL_CLASS_COUNT]) {
+    static std::mutex sPoolsMutex;
+    std::lock_guard<std::mutex> lock(sPoolsMutex);
+    sPoolList() << this;
+}
+
+eMemoryPool::~eMemoryPool() {
+    trim();
+    delete[] mClasses;
+}
+
+int eMemoryPool::sSizeClass(const size_t size) {
+    if(size == 0 || size > POOL_MAX_SIZE) return -1;
+    return int((size - 1)/POOL_GRANULARITY);
+}
+
+void* eMemoryPool::allocate(const size_t size) {
+    mAllocations++;
+    mLive++;
+    const int id = sSizeClass(size);
+    if(id >= 0) {
+        auto& sizeClass = mClasses[id];
+        const size_t blockSize = size_t(id + 1)*POOL_GRANULARITY;
+        void* ptr = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(sizeClass.fMutex);
+            if(!sizeClass.fFree.empty()) {
+                ptr = sizeClass.fFree.back();
+                sizeClass.fFree.pop_back();
+            }
+        }
+        if(ptr) {
+            mReused++;
+            mCachedBytes -= blockSize;
+            return ptr;
+        }
+        ptr = std::malloc(blockSize);
+        if(!ptr) throw std::bad_alloc();
+        return ptr;
+    }
+    const auto ptr = std::malloc(size);
+    if(!ptr) throw std::bad_alloc();
+    return ptr;
+}
+
+void eMemoryPool::deallocate(void* const ptr, const size_t size) {
+    if(!ptr) return;
+    mLive--;
+    const int id = sSizeClass(size);
+    if(id >= 0) {
+        auto& sizeClass = mClasses[id];
+        std::lock_guard<std::mutex> lock(sizeClass.fMutex);
+        if(sizeClass.fFree.size() < POOL_MAX_FREE) {
+            sizeClass.fFree.push_back(ptr);
+            mCachedBytes += size_t(id + 1)*POOL_GRANULARITY;
+            return;
+        }
+    }
+    std::free(ptr);
+}
+
+void eMemoryPool::trim() {
+    for(int i = 0; i < POOL_CLASS_COUNT; i++) {
+        auto& sizeClass = mClasses[i];
+        std::vector<void*> blocks;
+        {
+            std::lock_guard<std::mutex> lock(sizeClass.fMutex);
+            blocks.swap(sizeClass.fFree);
+        }
+        mCachedBytes -= blocks.size()*size_t(i + 1)*POOL_GRANULARITY;
+        for(const auto block : blocks) std::free(block);
+    }
+}
+
+eMemoryPool::Stats eMemoryPool::stats() const {
+    Stats result;
+    result.fAllocations = mAllocations;
+    result.fReused = mReused;
+    result.fLive = mLive;
+    result.fCachedBytes = mCachedBytes;
+    return result;
+}
+
+// pools are never destroyed, objects may still be released
+// from static destructors after main returns
+eMemoryPool& eMemoryPool::sTasks() {
+    static const auto sInstance = new eMemoryPool("tasks");
+    return *sInstance;
+}
+
+eMemoryPool& eMemoryPool::sEffectCallers() {
+    static const auto sInstance = new eMemoryPool("effect callers");
+    return *sInstance;
+}
+
+QList<eMemoryPool*>& eMemoryPool::sPoolList() {
+    static QList<eMemoryPool*> sInstances;
+    return sInstances;
+}
+
+const QList<eMemoryPool*>& eMemoryPool::sPools() {
+    return sPoolList();
+}
+
+void eMemoryPool::sTrimAll() {
+    for(const auto pool : sPools()) pool->trim();
+}
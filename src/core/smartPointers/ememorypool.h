@@ -0,0 +1,85 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef EMEMORYPOOL_H
+#define EMEMORYPOOL_H
+
+#include "../core_global.h"
+
+#include <QList>
+#include <QString>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+// Recycles the short-lived objects created for every rendered frame
+// (render data, tasks, effect callers). Freed blocks are kept in
+// per-size free lists and handed out again instead of going back to
+// the system allocator. Blocks larger than the biggest size class are
+// passed straight to malloc/free.
+class CORE_EXPORT eMemoryPool {
+public:
+    struct Stats {
+        quint64 fAllocations = 0;
+        quint64 fReused = 0;
+        quint64 fLive = 0;
+        quint64 fCachedBytes = 0;
+    };
+
+    eMemoryPool(const QString& name);
+    eMemoryPool(const eMemoryPool&) = delete;
+    eMemoryPool& operator=(const eMemoryPool&) = delete;
+    ~eMemoryPool();
+
+    void* allocate(const size_t size);
+    void deallocate(void* const ptr, const size_t size);
+
+    //! @brief Returns all cached blocks to the system allocator
+    void trim();
+
+    const QString& name() const { return mName; }
+    Stats stats() const;
+
+    static eMemoryPool& sTasks();
+    static eMemoryPool& sEffectCallers();
+
+    static const QList<eMemoryPool*>& sPools();
+    static void sTrimAll();
+private:
+    struct SizeClass {
+        std::mutex fMutex;
+        std::vector<void*> fFree;
+    };
+
+    static int sSizeClass(const size_t size);
+    static QList<eMemoryPool*>& sPoolList();
+
+    const QString mName;
+    SizeClass* const mClasses;
+    std::atomic<quint64> mAllocations{0};
+    std::atomic<quint64> mReused{0};
+    std::atomic<quint64> mLive{0};
+    std::atomic<quint64> mCachedBytes{0};
+};
+
+#endif // EMEMORYPOOL_H
@@ -28,10 +28,37 @@
 
 #include "../core_global.h"
 
+#include <cstdlib>
+
+// allocation goes through sAllocate/sDeallocate found in the class
+// scope, base classes can redirect them to a memory pool
 #define e_PROHIBIT_HEAP \
+public: \
+    static void operator delete (void *ptr, size_t sz) { \
+        sDeallocate(ptr, sz); \
+    } \
 private: \
     static void *operator new (size_t sz) { \
+        return sAllocate(sz); \
+    }
+
+#define e_DEFAULT_ALLOCATOR \
+protected: \
+    static void *sAllocate(const size_t sz) { \
         return std::malloc(sz); \
+    } \
+    static void sDeallocate(void * const ptr, const size_t sz) { \
+        Q_UNUSED(sz) \
+        std::free(ptr); \
+    }
+
+#define e_POOLED_ALLOCATOR(pool) \
+protected: \
+    static void *sAllocate(const size_t sz) { \
+        return pool.allocate(sz); \
+    } \
+    static void sDeallocate(void * const ptr, const size_t sz) { \
+        pool.deallocate(ptr, sz); \
     }
 
 #define e_OBJECT \
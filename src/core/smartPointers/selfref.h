@@ -36,6 +36,7 @@ template <class T> using qptr = QPointer<T>;
 
 class CORE_EXPORT SelfRef : public QObject {
     e_PROHIBIT_HEAP
+    e_DEFAULT_ALLOCATOR
 public:
     template <class T, typename... Args>
     static inline QSharedPointer<T> sCreate(Args && ...args) {
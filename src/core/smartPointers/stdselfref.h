@@ -37,6 +37,7 @@ template <class T> using stdptr = StdPointer<T>;
 class CORE_EXPORT StdSelfRef {
     template <class T> friend class StdPointer;
     e_PROHIBIT_HEAP
+    e_DEFAULT_ALLOCATOR
 public:
     virtual ~StdSelfRef();
 
@@ -25,6 +25,8 @@
 #include "appsupport.h"
 #include "svgo.h"
 
+#include <QXmlStreamWriter>
+
 using namespace Friction;
 
 SvgExporter::SvgExporter(const QString& path,
@@ -65,13 +67,18 @@ void SvgExporter::nextStep()
 {
     if (!mOpen) {
         if (mFile.open(QIODevice::WriteOnly)) {
-            mStream.setDevice(&mFile);
+            // svgo works on the whole document
+            if (fOptimize && !mHtml) { mStream.setString(&mOptimizeContent); }
+            else { mStream.setDevice(&mFile); }
+            fScene->loadDeferredContent();
             fScene->saveSceneSVG(*this);
+            writeStart();
         } else {
             RuntimeThrow("Could not open:\n\"" + mFile.fileName() + "\"");
         }
         mOpen = true;
     }
+    writeFinished();
     if (mWaitingTasks.isEmpty()) { return finish(); }
     const auto task = mWaitingTasks.takeFirst();
     addTask(task);
@@ -82,42 +89,88 @@ void SvgExporter::addNextTask(const stdsptr<eTask>& task)
     mWaitingTasks << task;
 }
 
+QDomNode SvgExporter::reserveChild(QDomElement& parent)
+{
+    const auto slot = parent.appendChild(createElement("g"));
+    mReserved << slot;
+    return slot;
+}
+
+void SvgExporter::releaseChild(const QDomNode& slot)
+{
+    mReserved.removeOne(slot);
+}
+
+void SvgExporter::writeStart()
+{
+    mStream.setCodec("UTF-8");
+    if (mHtml) {
+        mStream << "<!DOCTYPE html>";
+        mStream << "<html>";
+        mStream << "<head>";
+        mStream << "<meta charset=\"utf-8\" />";
+        mStream << QString("<title>%1</title>").arg(tr("Preview"));
+        mStream << "<style>html, body { width: 100%; height: 100%; margin: 0; padding: 0; overflow: hidden; } html { background: repeating-conic-gradient(#b0b0b0 0% 25%, transparent 0% 50%) 50% / 40px 40px; } svg { margin: auto; width: 100%; height: 100%; object-fit: contain; overflow: hidden; }</style>";
+        mStream << "</head>";
+        mStream << "<body>";
+        mStream << "\n";
+    }
+    if (!mHtml && !fOptimize) {
+        mStream << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>";
+        mStream << "\n";
+    }
+
+    mStream << QString("<!-- Created with %1 - %2 -->").arg(AppSupport::getAppDisplayName(),
+                                                           AppSupport::getAppUrl());
+    mStream << "\n";
+
+    // the svg attributes are final once the scene is saved
+    QString startTag;
+    QXmlStreamWriter writer(&startTag);
+    writer.writeStartElement("svg");
+    const auto attributes = mSvg.attributes();
+    for (int i = 0; i < attributes.count(); i++) {
+        const auto attr = attributes.item(i).toAttr();
+        writer.writeAttribute(attr.name(), attr.value());
+    }
+    writer.writeCharacters(QString()); // closes the start tag
+    mStream << startTag << "\n";
+}
+
+void SvgExporter::writeFinished()
+{
+    // children in front of the first reserved one are done,
+    // write them out and drop them from the tree
+    for (auto child = mSvg.firstChild();
+         !child.isNull() && !mReserved.contains(child);
+         child = mSvg.firstChild()) {
+        child.save(mStream, 1);
+        mSvg.removeChild(child);
+    }
+}
+
 void SvgExporter::finish()
 {
     if (mOpen) {
         mSvg.appendChild(mDefs);
-        mDoc.appendChild(mSvg);
+        writeFinished();
+        mStream << "</svg>";
 
-        QString result;
         if (mHtml) {
-            result.append("<!DOCTYPE html>");
-            result.append("<html>");
-            result.append("<head>");
-            result.append("<meta charset=\"utf-8\" />");
-            result.append(QString("<title>%1</title>").arg(tr("Preview")));
-            result.append("<style>html, body { width: 100%; height: 100%; margin: 0; padding: 0; overflow: hidden; } html { background: repeating-conic-gradient(#b0b0b0 0% 25%, transparent 0% 50%) 50% / 40px 40px; } svg { margin: auto; width: 100%; height: 100%; object-fit: contain; overflow: hidden; }</style>");
-            result.append("</head>");
-            result.append("<body>");
-            result.append("\n");
-        }
-        if (!mHtml && !fOptimize) {
-            result.append("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>");
-            result.append("\n");
+            mStream << "\n";
+            mStream << "</body>";
+            mStream << "</html>";
         }
 
-        QString content = QString("<!-- Created with %1 - %2 -->").arg(AppSupport::getAppDisplayName(),
-                                                                       AppSupport::getAppUrl());
-        content.append("\n");
-        content.append(mDoc.toString());
-        result.append(fOptimize && !mHtml ? Core::SVGO::optimize(content) : content);
-
-        if (mHtml) {
-            result.append("</body>");
-            result.append("</html>");
+        if (fOptimize && !mHtml) {
+            QTextStream file(&mFile);
+            file.setCodec("UTF-8");
+            file << Core::SVGO::optimize(mOptimizeContent) << Qt::endl;
+            file.flush();
+        } else {
+            mStream << Qt::endl;
+            mStream.flush();
         }
-
-        mStream << result.toUtf8() << Qt::endl;
-        mStream.flush();
         mFile.close();
     }
     setValue(INT_MAX);
@@ -82,7 +82,14 @@ public:
         return mSvg;
     }
 
+    // reserves the place of an element finished later, the content
+    // in front of it is written to the file as soon as it is done
+    QDomNode reserveChild(QDomElement& parent);
+    void releaseChild(const QDomNode& slot);
+
 private:
+    void writeStart();
+    void writeFinished();
     void finish();
     bool mHtml;
     bool mOpen;
@@ -91,6 +98,8 @@ private:
     QDomDocument mDoc;
     QDomElement mSvg;
     QDomElement mDefs;
+    QList<QDomNode> mReserved;
+    QString mOptimizeContent;
     QList<stdsptr<eTask>> mWaitingTasks;
 };
 
@@ -91,22 +91,36 @@ sk_sp<SkData> asDataUri(SkImage* image,
     return dataUri;
 }
 
-void SvgExportHelpers::defImage(SvgExporter& exp,
-                                const sk_sp<SkImage>& image,
-                                const QString id)
+eTask* SvgExportHelpers::defImage(SvgExporter& exp,
+                                  const sk_sp<SkImage>& image,
+                                  const QString id)
 {
-    if (!image) { return; }
+    if (!image) { return nullptr; }
     auto def = exp.createElement("image");
     def.setAttribute("id", id);
     def.setAttribute("x", 0);
     def.setAttribute("y", 0);
     def.setAttribute("width", image->width());
     def.setAttribute("height", image->height());
-    const auto dataUri = asDataUri(image.get(),
-                                   exp.fImageFormat,
-                                   exp.fImageQuality);
-    def.setAttribute("xlink:href", static_cast<const char*>(dataUri->data()));
     exp.addToDefs(def);
+
+    // encode on a cpu thread, the element keeps its place in defs
+    const auto format = exp.fImageFormat;
+    const int quality = exp.fImageQuality;
+    const auto dataUri = std::make_shared<sk_sp<SkData>>();
+    const auto encode = [image, format, quality, dataUri]() {
+        *dataUri = asDataUri(image.get(), format, quality);
+    };
+    const auto assign = [def, dataUri]() mutable {
+        if (!*dataUri) { return; }
+        def.setAttribute("xlink:href",
+                         static_cast<const char*>((*dataUri)->data()));
+    };
+    const auto task = enve::make_shared<eCustomCpuTask>(nullptr, encode,
+                                                        assign, nullptr);
+    exp.addNextTask(task);
+    task->queTask();
+    return task.get();
 }
 
 void SvgExportHelpers::assignVisibility(SvgExporter& exp,
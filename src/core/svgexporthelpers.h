@@ -39,10 +39,11 @@ namespace SvgExportHelpers {
     QString ptrToStr(const void* const ptr);
     CORE_EXPORT
     void assignLoop(QDomElement& ele, const bool loop);
+    //! @brief Returns the task encoding the image data, or nullptr
     CORE_EXPORT
-    void defImage(SvgExporter& exp,
-                  const sk_sp<SkImage>& image,
-                  const QString id);
+    eTask* defImage(SvgExporter& exp,
+                    const sk_sp<SkImage>& image,
+                    const QString id);
     CORE_EXPORT
     void assignVisibility(SvgExporter& exp,
                           QDomElement& ele,
@@ -26,7 +26,10 @@
 #include "svgimporter.h"
 
 #include <QtXml/QDomDocument>
+#include <QXmlStreamReader>
 #include <QRegularExpression>
+#include <QThread>
+#include <QSet>
 
 #include "Boxes/containerbox.h"
 #include "colorhelpers.h"
@@ -44,8 +47,11 @@
 #include "matrixdecomposition.h"
 #include "transformvalues.h"
 #include "regexhelpers.h"
+#include "Tasks/paralleljobs.h"
 
 #define RGXS REGEX_SPACES
+// minimum number of path elements worth a separate parsing thread
+#define PATHS_PER_THREAD 64
 
 static qreal parseSvgUnit(const QString &str,
                           qreal relativeTo)
@@ -58,6 +64,38 @@ static qreal parseSvgUnit(const QString &str,
     return trimmed.toDouble();
 }
 
+// Tag name and attributes of an element, without its content,
+// so that elements can be loaded while streaming the file
+class SvgElement {
+public:
+    SvgElement() {}
+    explicit SvgElement(const QXmlStreamReader& reader) :
+        mTagName(reader.qualifiedName().toString()),
+        mAttributes(reader.attributes()) {}
+    explicit SvgElement(const QDomElement& element) :
+        mTagName(element.tagName()) {
+        const auto attributes = element.attributes();
+        for(int i = 0; i < attributes.count(); i++) {
+            const auto attr = attributes.item(i).toAttr();
+            mAttributes.append(attr.name(), attr.value());
+        }
+    }
+
+    const QString& tagName() const { return mTagName; }
+
+    bool hasAttribute(const QString& name) const
+    { return mAttributes.hasAttribute(name); }
+
+    QString attribute(const QString& name,
+                      const QString& defValue = QString()) const {
+        if(!mAttributes.hasAttribute(name)) return defValue;
+        return mAttributes.value(name).toString();
+    }
+private:
+    QString mTagName;
+    QXmlStreamAttributes mAttributes;
+};
+
 class TextSvgAttributes {
 public:
     TextSvgAttributes() {}
@@ -167,7 +205,7 @@ public:
     const StrokeSvgAttributes &getStrokeAttributes() const;
     const TextSvgAttributes &getTextAttributes() const;
 
-    void loadBoundingBoxAttributes(const QDomElement &element);
+    void loadBoundingBoxAttributes(const SvgElement &element);
 
     bool hasTransform() const;
 
@@ -295,78 +333,72 @@ static bool isDigit(ushort ch) {
     return ((ch >> 4) == 3) && (magic >> (ch & 15));
 }
 
-static qreal toDouble(const QChar *&str) {
-    const int maxLen = 255;//technically doubles can go til 308+ but whatever
-    char temp[maxLen+1];
-    int pos = 0;
+static const double gPow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
 
+static qreal toDouble(const QChar *&str) {
+    const QChar * const begin = str;
+    bool neg = false;
     if(*str == QLatin1Char('-')) {
-        temp[pos++] = '-';
+        neg = true;
         ++str;
     } else if(*str == QLatin1Char('+')) {
         ++str;
     }
-    while(isDigit(str->unicode()) && pos < maxLen) {
-        temp[pos++] = str->toLatin1();
-        ++str;
-    }
-    if(*str == QLatin1Char('.') && pos < maxLen) {
-        temp[pos++] = '.';
+    quint64 mantissa = 0;
+    int digits = 0;
+    int exp10 = 0;
+    bool exact = true;
+    while(isDigit(str->unicode())) {
+        if(digits < 19) {
+            mantissa = mantissa*10 + (str->unicode() - '0');
+            if(mantissa) digits++;
+        } else {
+            exp10++;
+            exact = false;
+        }
         ++str;
     }
-    while(isDigit(str->unicode()) && pos < maxLen) {
-        temp[pos++] = str->toLatin1();
+    if(*str == QLatin1Char('.')) {
         ++str;
+        while(isDigit(str->unicode())) {
+            if(digits < 19) {
+                mantissa = mantissa*10 + (str->unicode() - '0');
+                if(mantissa) digits++;
+                exp10--;
+            } else exact = false;
+            ++str;
+        }
     }
-    bool exponent = false;
-    if((*str == QLatin1Char('e') || *str == QLatin1Char('E')) && pos < maxLen) {
-        exponent = true;
-        temp[pos++] = 'e';
+    if(*str == QLatin1Char('e') || *str == QLatin1Char('E')) {
+        const QChar * const expBegin = str;
         ++str;
-        if((*str == QLatin1Char('-') || *str == QLatin1Char('+')) && pos < maxLen) {
-            temp[pos++] = str->toLatin1();
+        bool expNeg = false;
+        if(*str == QLatin1Char('-')) {
+            expNeg = true;
             ++str;
-        }
-        while(isDigit(str->unicode()) && pos < maxLen) {
-            temp[pos++] = str->toLatin1();
+        } else if(*str == QLatin1Char('+')) {
             ++str;
         }
+        if(isDigit(str->unicode())) {
+            int exp = 0;
+            while(isDigit(str->unicode())) {
+                if(exp < 10000) exp = exp*10 + (str->unicode() - '0');
+                ++str;
+            }
+            exp10 += expNeg ? -exp : exp;
+        } else str = expBegin;
     }
 
-    temp[pos] = '\0';
-
-    qreal val;
-    if(!exponent && pos < 10) {
-        int ival = 0;
-        const char *t = temp;
-        bool neg = false;
-        if(*t == '-') {
-            neg = true;
-            ++t;
-        }
-        while(*t && *t != '.') {
-            ival *= 10;
-            ival += (*t) - '0';
-            ++t;
-        }
-        if(*t == '.') {
-            ++t;
-            int div = 1;
-            while(*t) {
-                ival *= 10;
-                ival += (*t) - '0';
-                div *= 10;
-                ++t;
-            }
-            val = static_cast<qreal>(ival)/div;
-        } else {
-            val = ival;
-        }
-        if(neg) val = -val;
-    } else {
-        val = QByteArray::fromRawData(temp, pos).toDouble();
+    // exact mantissa and power of ten give a correctly rounded result
+    if(exact && mantissa < (quint64(1) << 53) && qAbs(exp10) <= 22) {
+        const qreal val = exp10 < 0 ? mantissa/gPow10[-exp10] :
+                                      mantissa*gPow10[exp10];
+        return neg ? -val : val;
     }
-    return val;
+    return QString(begin, int(str - begin)).toLatin1().toDouble();
 }
 
 static qreal toDouble(const QString &str, bool *ok = nullptr) {
@@ -448,41 +480,117 @@ bool parsePolylineData(const QString &dataStr,
     return true;
 }
 
-void loadElement(const QDomElement &element, ContainerBox *parentGroup,
+void loadElement(QXmlStreamReader& reader, ContainerBox *parentGroup,
                  const BoxSvgAttributes &parentGroupAttributes,
                  const GradientCreator& gradientCreator);
 
-qsptr<ContainerBox> loadBoxesGroup(const QDomElement &groupElement,
+// Loads the content of the group element the reader is at, the reader
+// is left at its end element. A group is only kept if it has more than
+// one child node, a transform or no parent, which is known only at the
+// end, so the loaded boxes are moved to the parent group when it is not.
+qsptr<ContainerBox> loadBoxesGroup(QXmlStreamReader& reader,
                                    ContainerBox *parentGroup,
                                    const BoxSvgAttributes &attributes,
                                    const GradientCreator& gradientCreator) {
-    const QDomNodeList allRootChildNodes = groupElement.childNodes();
-    qsptr<ContainerBox> boxesGroup;
-    const bool hasTransform = attributes.hasTransform();
-    if(allRootChildNodes.count() > 1 || hasTransform || !parentGroup) {
-        boxesGroup = enve::make_shared<ContainerBox>(eBoxType::group);
-        boxesGroup->planCenterPivotPosition();
-        attributes.apply(boxesGroup.get());
-        if(parentGroup) parentGroup->addContained(boxesGroup);
-    } else {
-        boxesGroup = parentGroup->ref<ContainerBox>();
+    const auto boxesGroup = enve::make_shared<ContainerBox>(eBoxType::group);
+    boxesGroup->planCenterPivotPosition();
+    attributes.apply(boxesGroup.get());
+    if(parentGroup) parentGroup->addContained(boxesGroup);
+
+    int childNodes = 0;
+    while(!reader.atEnd()) {
+        const auto token = reader.readNext();
+        if(token == QXmlStreamReader::EndElement) break;
+        if(token == QXmlStreamReader::StartElement) {
+            childNodes++;
+            loadElement(reader, boxesGroup.get(),
+                        attributes, gradientCreator);
+        } else if(token == QXmlStreamReader::Comment ||
+                  (token == QXmlStreamReader::Characters &&
+                   !reader.isWhitespace())) {
+            childNodes++;
+        }
+    }
+    if(childNodes > 1 || attributes.hasTransform() || !parentGroup) {
+        return boxesGroup;
     }
 
-    for(int i = 0; i < allRootChildNodes.count(); i++) {
-        const QDomNode iNode = allRootChildNodes.at(i);
-        if(iNode.isElement()) {
-            loadElement(iNode.toElement(), boxesGroup.get(),
-                        attributes, gradientCreator);
+    const int id = parentGroup->getContainedIndex(boxesGroup.get());
+    boxesGroup->removeFromParent_k();
+    const int count = boxesGroup->getContainedBoxesCount();
+    for(int i = 0; i < count; i++) {
+        parentGroup->insertContained(id + i, boxesGroup->takeContained_k(0));
+    }
+    return nullptr;
+}
+
+// Builds the element the reader is at, including its content, the reader
+// is left at its end element. Used for the few elements (gradients, text)
+// whose loading needs their children.
+QDomElement readElement(QXmlStreamReader& reader, QDomDocument& document) {
+    const auto createElement = [&reader, &document]() {
+        QDomElement element = document.createElement(
+                    reader.qualifiedName().toString());
+        const auto attributes = reader.attributes();
+        for(const auto& attr : attributes) {
+            element.setAttribute(attr.qualifiedName().toString(),
+                                 attr.value().toString());
+        }
+        return element;
+    };
+    const QDomElement result = createElement();
+    QDomNode parent = result;
+    int depth = 1;
+    while(depth > 0 && !reader.atEnd()) {
+        switch(reader.readNext()) {
+        case QXmlStreamReader::StartElement:
+            parent = parent.appendChild(createElement());
+            depth++;
+            break;
+        case QXmlStreamReader::EndElement:
+            parent = parent.parentNode();
+            depth--;
+            break;
+        case QXmlStreamReader::Characters:
+            if(reader.isWhitespace()) break;
+            parent.appendChild(document.createTextNode(reader.text().toString()));
+            break;
+        case QXmlStreamReader::Comment:
+            parent.appendChild(document.createComment(reader.text().toString()));
+            break;
+        default: break;
         }
     }
-    return boxesGroup;
+    return result;
 }
 
-void loadVectorPath(const QDomElement &pathElement,
+//  path data    parsed
+static QHash<QString, SkPath> gParsedPaths;
+
+void parsePathsData(const QVector<QString>& data) {
+    QVector<SkPath> parsed(data.count());
+    const int nThreads = qBound(1, data.count()/PATHS_PER_THREAD,
+                                QThread::idealThreadCount());
+    ParallelJobs::sRun(data.count(), nThreads,
+                       [&data, &parsed](const int id) {
+        const auto pathStr = data.at(id).toStdString();
+        SkParsePath::FromSVGString(pathStr.data(), &parsed[id]);
+    });
+
+    for(int i = 0; i < data.count(); i++) {
+        gParsedPaths.insert(data.at(i), parsed.at(i));
+    }
+}
+
+void loadVectorPath(const SvgElement &pathElement,
                     ContainerBox *parentGroup,
                     VectorPathSvgAttributes& attributes) {
     const QString pathStr = pathElement.attribute("d");
-    SkParsePath::FromSVGString(pathStr.toStdString().data(), &attributes.path());
+    const auto parsed = gParsedPaths.constFind(pathStr);
+    if(parsed == gParsedPaths.constEnd()) {
+        SkParsePath::FromSVGString(pathStr.toStdString().data(),
+                                   &attributes.path());
+    } else attributes.path() = parsed.value();
     if(attributes.isEmpty()) return;
     const auto vectorPath = enve::make_shared<SmartVectorPath>();
     vectorPath->planCenterPivotPosition();
@@ -490,7 +598,7 @@ void loadVectorPath(const QDomElement &pathElement,
     parentGroup->addContained(vectorPath);
 }
 
-void loadPolyline(const QDomElement &pathElement,
+void loadPolyline(const SvgElement &pathElement,
                   ContainerBox *parentGroup,
                   VectorPathSvgAttributes &attributes,
                   const bool isPolygon) {
@@ -503,7 +611,7 @@ void loadPolyline(const QDomElement &pathElement,
     parentGroup->addContained(vectorPath);
 }
 
-void loadCircle(const QDomElement &pathElement,
+void loadCircle(const SvgElement &pathElement,
                 ContainerBox *parentGroup,
                 const BoxSvgAttributes &attributes) {
 
@@ -537,7 +645,7 @@ void loadCircle(const QDomElement &pathElement,
     parentGroup->addContained(circle);
 }
 
-void loadRect(const QDomElement &pathElement,
+void loadRect(const SvgElement &pathElement,
               ContainerBox *parentGroup,
               const BoxSvgAttributes &attributes) {
 
@@ -569,7 +677,7 @@ void loadRect(const QDomElement &pathElement,
     parentGroup->addContained(rect);
 }
 
-void loadLine(const QDomElement &pathElement,
+void loadLine(const SvgElement &pathElement,
                   ContainerBox *parentGroup,
                   VectorPathSvgAttributes &attributes) {
 
@@ -705,7 +813,7 @@ static QMap<QString, SvgGradient> gGradients;
 //            to       from
 static QMap<QString, QStringList> gUnresolvedGradientLinks;
 
-void applyGradientToAttributes(const QDomElement &element,
+void applyGradientToAttributes(const SvgElement &element,
                                BoxSvgAttributes &attributes,
                                const GradientCreator& gradientCreator,
                                const QPointF &offset = QPointF(0,0),
@@ -836,7 +944,8 @@ void loadText(const QDomElement &textElement,
             if (content.trimmed().isEmpty()) { continue; }
 
             BoxSvgAttributes lineAttributes = attributes;
-            lineAttributes.loadBoundingBoxAttributes(tspan);
+            const SvgElement tspanElement(tspan);
+            lineAttributes.loadBoundingBoxAttributes(tspanElement);
 
             QString xStr = tspan.attribute("x", textElement.attribute("x"))
                                .split(QRegularExpression("\\s+")).first().remove("px");
@@ -844,12 +953,12 @@ void loadText(const QDomElement &textElement,
                                .split(QRegularExpression("\\s+")).first().remove("px");
             QPointF pos(xStr.toDouble(), yStr.toDouble());
 
-            applyGradientToAttributes(tspan,
+            applyGradientToAttributes(tspanElement,
                                       lineAttributes,
                                       gradientCreator,
                                       pos,
                                       true); // fill
-            applyGradientToAttributes(tspan,
+            applyGradientToAttributes(tspanElement,
                                       lineAttributes,
                                       gradientCreator,
                                       pos,
@@ -891,11 +1000,12 @@ void loadText(const QDomElement &textElement,
 
         BoxSvgAttributes textAttributes = attributes;
 
-        applyGradientToAttributes(textElement,
+        const SvgElement element(textElement);
+        applyGradientToAttributes(element,
                                   textAttributes,
                                   gradientCreator,
                                   pos, true); // fill
-        applyGradientToAttributes(textElement,
+        applyGradientToAttributes(element,
                                   textAttributes,
                                   gradientCreator,
                                   pos, false); // stroke
@@ -910,158 +1020,163 @@ void loadText(const QDomElement &textElement,
     }
 }
 
-void loadElement(const QDomElement &element,
-                 ContainerBox *parentGroup,
-                 const BoxSvgAttributes &parentGroupAttributes,
-                 const GradientCreator& gradientCreator)
+// Loads a gradient element read together with its stops,
+// svgRoot provides the view box for percentage coordinates
+void loadGradient(const QDomElement &element,
+                  const SvgElement &svgRoot,
+                  const GradientCreator& gradientCreator)
 {
     const QString tagName = element.tagName();
-    if ((tagName == "linearGradient" || tagName == "radialGradient") &&
-        gGradients.contains(element.attribute("id"))) {
+    if(gGradients.contains(element.attribute("id"))) {
         qDebug() << "gradient already added, ignore" << tagName;
         return;
     }
 
-    if(tagName == "defs") {
+    GradientType type;
+    if(tagName == "linearGradient") {
+        type = GradientType::LINEAR;
+    } else { //if(tagName == "radialGradient") {
+        type = GradientType::RADIAL;
+    }
+    const QString id = element.attribute("id");
+    qDebug() << "found gradient id" << id;
+    QString linkId = element.attribute("xlink:href");
+    Gradient* gradient = nullptr;
+    if(linkId.isEmpty()) {
+        gradient = gradientCreator();
         const QDomNodeList allRootChildNodes = element.childNodes();
         for(int i = 0; i < allRootChildNodes.count(); i++) {
             const QDomNode iNode = allRootChildNodes.at(i);
-            if(iNode.isElement()) {
-                loadElement(iNode.toElement(), parentGroup,
-                            parentGroupAttributes, gradientCreator);
-            }
-        }
-        return;
-    } else if(tagName == "linearGradient" || tagName == "radialGradient") {
-        GradientType type;
-        if(tagName == "linearGradient") {
-            type = GradientType::LINEAR;
-        } else { //if(tagName == "radialGradient") {
-            type = GradientType::RADIAL;
-        }
-        const QString id = element.attribute("id");
-        qDebug() << "found gradient id" << id;
-        QString linkId = element.attribute("xlink:href");
-        Gradient* gradient = nullptr;
-        if(linkId.isEmpty()) {
-            gradient = gradientCreator();
-            const QDomNodeList allRootChildNodes = element.childNodes();
-            for(int i = 0; i < allRootChildNodes.count(); i++) {
-                const QDomNode iNode = allRootChildNodes.at(i);
-                if(!iNode.isElement()) continue;
-                const QDomElement elem = iNode.toElement();
-                if(elem.tagName() != "stop") continue;
-                QString stopColorS;
-                QString stopOpacityS;
-                const QString stopStyle = elem.attribute("style");
-                QList<SvgAttribute> attributesList;
-                extractSvgAttributes(stopStyle, &attributesList);
-                for(const auto& attr : attributesList) {
-                    if(attr.fName == "stop-color") {
-                        stopColorS = attr.fValue;
-
-                    } else if(attr.fName == "stop-opacity") {
-                        stopOpacityS = attr.fValue;
-                    }
-                }
-                if(stopColorS.isEmpty()) {
-                    stopColorS = elem.attribute("stop-color");
-                }
-                if(stopOpacityS.isEmpty()) {
-                    stopOpacityS = elem.attribute("stop-opacity");
-                }
-
-                QColor stopColor;
-                toColor(stopColorS, stopColor);
-                if(!stopOpacityS.isEmpty()) {
-                    stopColor.setAlphaF(toDouble(stopOpacityS));
+            if(!iNode.isElement()) continue;
+            const QDomElement elem = iNode.toElement();
+            if(elem.tagName() != "stop") continue;
+            QString stopColorS;
+            QString stopOpacityS;
+            const QString stopStyle = elem.attribute("style");
+            QList<SvgAttribute> attributesList;
+            extractSvgAttributes(stopStyle, &attributesList);
+            for(const auto& attr : attributesList) {
+                if(attr.fName == "stop-color") {
+                    stopColorS = attr.fValue;
+
+                } else if(attr.fName == "stop-opacity") {
+                    stopOpacityS = attr.fValue;
                 }
+            }
+            if(stopColorS.isEmpty()) {
+                stopColorS = elem.attribute("stop-color");
+            }
+            if(stopOpacityS.isEmpty()) {
+                stopOpacityS = elem.attribute("stop-opacity");
+            }
 
-                gradient->addColor(stopColor);
+            QColor stopColor;
+            toColor(stopColorS, stopColor);
+            if(!stopOpacityS.isEmpty()) {
+                stopColor.setAlphaF(toDouble(stopOpacityS));
             }
+
+            gradient->addColor(stopColor);
+        }
+    } else {
+        if(linkId.at(0) == "#") linkId.remove(0, 1);
+        const auto it = gGradients.find(linkId);
+        if(it == gGradients.end()) {
+            gUnresolvedGradientLinks[linkId].append(id);
+            gradient = nullptr;
         } else {
-            if(linkId.at(0) == "#") linkId.remove(0, 1);
-            const auto it = gGradients.find(linkId);
-            if(it == gGradients.end()) {
-                gUnresolvedGradientLinks[linkId].append(id);
-                gradient = nullptr;
-            } else {
-                gradient = it.value().fGradient;
-            }
+            gradient = it.value().fGradient;
         }
-        const auto it = gUnresolvedGradientLinks.find(id);
-        if(it != gUnresolvedGradientLinks.end()) {
-            if(gradient) {
-                for(const auto& linking : it.value()) {
-                    auto& grad = gGradients[linking];
-                    grad.fGradient = gradient;
-                    grad.fType = type;
-                }
-            } else {
-                gUnresolvedGradientLinks[linkId] = it.value();
+    }
+    const auto it = gUnresolvedGradientLinks.find(id);
+    if(it != gUnresolvedGradientLinks.end()) {
+        if(gradient) {
+            for(const auto& linking : it.value()) {
+                auto& grad = gGradients[linking];
+                grad.fGradient = gradient;
+                grad.fType = type;
             }
+        } else {
+            gUnresolvedGradientLinks[linkId] = it.value();
         }
+    }
+
+    switch(type) {
+    case GradientType::LINEAR:
+    case GradientType::RADIAL:
+    {
+        QStringList viewBox = svgRoot.attribute("viewBox").split(QRegularExpression("\\s+"),
+                                                                 Qt::SkipEmptyParts);
+        qreal viewW = 1.0;
+        qreal viewH = 1.0;
+
+        if (viewBox.size() >= 4) {
+            viewW = viewBox.at(2).toDouble();
+            viewH = viewBox.at(3).toDouble();
+        } else {
+            viewW = svgRoot.attribute("width", "1").toDouble();
+            viewH = svgRoot.attribute("height", "1").toDouble();
+        }
+        if (viewW <= 0) { viewW = 1.0; }
+        if (viewH <= 0) { viewH = 1.0; }
 
-        switch(type) {
-        case GradientType::LINEAR:
-        case GradientType::RADIAL:
-        {
-            QDomElement svgRoot = element.ownerDocument().documentElement();
-            QStringList viewBox = svgRoot.attribute("viewBox").split(QRegularExpression("\\s+"),
-                                                                     Qt::SkipEmptyParts);
-            qreal viewW = 1.0;
-            qreal viewH = 1.0;
-
-            if (viewBox.size() >= 4) {
-                viewW = viewBox.at(2).toDouble();
-                viewH = viewBox.at(3).toDouble();
+        QPointF p1, p2;
+        const QString units = element.attribute("gradientUnits");
+        const QString gradTrans = element.attribute("gradientTransform");
+        QMatrix trans = getMatrixFromString(gradTrans);
+
+        if (units == "userSpaceOnUse") {
+            if (type == GradientType::LINEAR) {
+                p1 = QPointF(element.attribute("x1", "0").toDouble(),
+                             element.attribute("y1", "0").toDouble());
+                p2 = QPointF(element.attribute("x2", "1").toDouble(),
+                             element.attribute("y2", "1").toDouble());
             } else {
-                viewW = svgRoot.attribute("width", "1").toDouble();
-                viewH = svgRoot.attribute("height", "1").toDouble();
+                qreal cx = element.attribute("cx", "0").toDouble();
+                qreal cy = element.attribute("cy", "0").toDouble();
+                qreal r  = element.attribute("r", "1").toDouble();
+                p1 = QPointF(cx, cy);
+                p2 = QPointF(cx + r, cy + r);
             }
-            if (viewW <= 0) { viewW = 1.0; }
-            if (viewH <= 0) { viewH = 1.0; }
-
-            QPointF p1, p2;
-            const QString units = element.attribute("gradientUnits");
-            const QString gradTrans = element.attribute("gradientTransform");
-            QMatrix trans = getMatrixFromString(gradTrans);
-
-            if (units == "userSpaceOnUse") {
-                if (type == GradientType::LINEAR) {
-                    p1 = QPointF(element.attribute("x1", "0").toDouble(),
-                                 element.attribute("y1", "0").toDouble());
-                    p2 = QPointF(element.attribute("x2", "1").toDouble(),
-                                 element.attribute("y2", "1").toDouble());
-                } else {
-                    qreal cx = element.attribute("cx", "0").toDouble();
-                    qreal cy = element.attribute("cy", "0").toDouble();
-                    qreal r  = element.attribute("r", "1").toDouble();
-                    p1 = QPointF(cx, cy);
-                    p2 = QPointF(cx + r, cy + r);
-                }
-            } else { // objectBoundingBox:
-                if (type == GradientType::LINEAR) {
-                    p1 = QPointF(parseSvgUnit(element.attribute("x1"), viewW),
-                                 parseSvgUnit(element.attribute("y1"), viewH));
-                    p2 = QPointF(parseSvgUnit(element.attribute("x2"), viewW),
-                                 parseSvgUnit(element.attribute("y2"), viewH));
-                } else {
-                    const qreal cx = parseSvgUnit(element.attribute("cx"), viewW);
-                    const qreal cy = parseSvgUnit(element.attribute("cy"), viewH);
-                    const qreal r = parseSvgUnit(element.attribute("r"),
-                                                 (viewW + viewH) * 0.5);
-                    p1 = QPointF(cx, cy);
-                    p2 = QPointF(cx + r, cy + r);
-                }
+        } else { // objectBoundingBox:
+            if (type == GradientType::LINEAR) {
+                p1 = QPointF(parseSvgUnit(element.attribute("x1"), viewW),
+                             parseSvgUnit(element.attribute("y1"), viewH));
+                p2 = QPointF(parseSvgUnit(element.attribute("x2"), viewW),
+                             parseSvgUnit(element.attribute("y2"), viewH));
+            } else {
+                const qreal cx = parseSvgUnit(element.attribute("cx"), viewW);
+                const qreal cy = parseSvgUnit(element.attribute("cy"), viewH);
+                const qreal r = parseSvgUnit(element.attribute("r"),
+                                             (viewW + viewH) * 0.5);
+                p1 = QPointF(cx, cy);
+                p2 = QPointF(cx + r, cy + r);
             }
-            gGradients.insert(id, {gradient,
-                                   p1.x(), p1.y(),
-                                   p2.x(), p2.y(),
-                                   trans, type, units});
-            break;
         }
+        gGradients.insert(id, {gradient,
+                               p1.x(), p1.y(),
+                               p2.x(), p2.y(),
+                               trans, type, units});
+        break;
+    }
+    }
+}
+
+void loadElement(QXmlStreamReader& reader,
+                 ContainerBox *parentGroup,
+                 const BoxSvgAttributes &parentGroupAttributes,
+                 const GradientCreator& gradientCreator)
+{
+    const SvgElement element(reader);
+    const QString& tagName = element.tagName();
+    if(tagName == "defs") {
+        while(reader.readNextStartElement()) {
+            loadElement(reader, parentGroup,
+                        parentGroupAttributes, gradientCreator);
         }
+        return;
+    } else if(tagName == "linearGradient" || tagName == "radialGradient") {
+        // gradients are loaded before the boxes
     } else if(tagName == "path" || tagName == "polyline" || tagName == "polygon" || tagName == "line") {
         VectorPathSvgAttributes attributes;
         attributes.setParent(parentGroupAttributes);
@@ -1084,18 +1199,23 @@ void loadElement(const QDomElement &element,
         attributes.loadBoundingBoxAttributes(element);
         applyGradientToAttributes(element, attributes, gradientCreator);
         if(tagName == "g") {
-            const auto group = loadBoxesGroup(element, parentGroup,
+            const auto group = loadBoxesGroup(reader, parentGroup,
                                               attributes, gradientCreator);
-            if(group->getContainedBoxesCount() == 0)
+            if(group && group->getContainedBoxesCount() == 0)
                 group->removeFromParent_k();
+            return;
         } else if(tagName == "circle" || tagName == "ellipse") {
             loadCircle(element, parentGroup, attributes);
         } else if(tagName == "rect") {
             loadRect(element, parentGroup, attributes);
         } else if(tagName == "text") {
-            loadText(element, parentGroup, attributes, gradientCreator);
+            QDomDocument document;
+            const auto textElement = readElement(reader, document);
+            loadText(textElement, parentGroup, attributes, gradientCreator);
+            return;
         }
     } else qDebug() << "Unrecognized tagName \"" + tagName + "\"";
+    reader.skipCurrentElement();
 }
 
 bool getUrlId(const QString &urlStr, QString *id) {
@@ -1136,32 +1256,82 @@ bool getFlatColorFromString(const QString &colorStr, FillSvgAttributes *target)
     return true;
 }
 
+// Definitions needed before any box can be loaded,
+// collected in a first pass over the file
+struct SvgDefinitions {
+    SvgElement fRoot;
+    // gradient elements with their stops, the only
+    // elements kept in a document tree
+    QDomDocument fDocument;
+    QList<QDomElement> fLinearGradients;
+    QList<QDomElement> fRadialGradients;
+    QVector<QString> fPathsData;
+};
+
+void readDefinitions(const QByteArray& src, SvgDefinitions& defs) {
+    QXmlStreamReader reader(src);
+    reader.setNamespaceProcessing(false);
+    if(!reader.readNextStartElement() || reader.qualifiedName() != "svg") {
+        if(reader.hasError()) {
+            RuntimeThrow("Cannot read svg content\n" + reader.errorString());
+        }
+        RuntimeThrow("File does not have svg root element");
+    }
+    defs.fRoot = SvgElement(reader);
+    QSet<QString> pathsData;
+    while(!reader.atEnd()) {
+        if(reader.readNext() != QXmlStreamReader::StartElement) continue;
+        const auto tagName = reader.qualifiedName();
+        if(tagName == "linearGradient") {
+            defs.fLinearGradients << readElement(reader, defs.fDocument);
+        } else if(tagName == "radialGradient") {
+            defs.fRadialGradients << readElement(reader, defs.fDocument);
+        } else if(tagName == "path") {
+            const QString pathStr = reader.attributes().value("d").toString();
+            if(pathStr.isEmpty() || pathsData.contains(pathStr)) continue;
+            pathsData.insert(pathStr);
+            defs.fPathsData << pathStr;
+        }
+    }
+    if(reader.hasError()) {
+        RuntimeThrow("Cannot read svg content\n" + reader.errorString());
+    }
+}
+
 qsptr<BoundingBox> ImportSVG::loadSVGFile(const QDomDocument& src,
                                           const GradientCreator& gradientCreator)
 {
-    const QDomElement rootElement = src.firstChildElement("svg");
-    if(rootElement.isNull()) RuntimeThrow("File does not have svg root element");
+    return loadSVGFile(src.toByteArray(), gradientCreator);
+}
+
+qsptr<BoundingBox> ImportSVG::loadSVGFile(
+        const QByteArray& src,
+        const GradientCreator& gradientCreator) {
+    // parsed paths must not carry over to the next import, even on errors
+    struct ParsedPathsGuard {
+        ~ParsedPathsGuard() { gParsedPaths.clear(); }
+    } parsedPathsGuard;
+
+    SvgDefinitions defs;
+    readDefinitions(src, defs);
+    parsePathsData(defs.fPathsData);
 
     // Pre-load gradients
-    QDomNodeList gradients = src.elementsByTagName("linearGradient");
-    qDebug() << "found linearGradients:" << gradients.count();
-    for (int i = 0; i < gradients.count(); i++) {
-        loadElement(gradients.at(i).toElement(),
-                    nullptr,
-                    BoxSvgAttributes(),
-                    gradientCreator);
+    qDebug() << "found linearGradients:" << defs.fLinearGradients.count();
+    for(const auto& gradient : defs.fLinearGradients) {
+        loadGradient(gradient, defs.fRoot, gradientCreator);
     }
-    gradients = src.elementsByTagName("radialGradient");
-    qDebug() << "found radialGradients:" << gradients.count();
-    for (int i = 0; i < gradients.count(); i++) {
-        loadElement(gradients.at(i).toElement(),
-                    nullptr,
-                    BoxSvgAttributes(),
-                    gradientCreator);
+    qDebug() << "found radialGradients:" << defs.fRadialGradients.count();
+    for(const auto& gradient : defs.fRadialGradients) {
+        loadGradient(gradient, defs.fRoot, gradientCreator);
     }
 
+    // boxes are created while streaming the file for the second time
+    QXmlStreamReader reader(src);
+    reader.setNamespaceProcessing(false);
+    reader.readNextStartElement();
     BoxSvgAttributes attributes;
-    const auto result = loadBoxesGroup(rootElement, nullptr,
+    const auto result = loadBoxesGroup(reader, nullptr,
                                        attributes, gradientCreator);
     gGradients.clear();
     auto it = gUnresolvedGradientLinks.begin();
@@ -1180,22 +1350,10 @@ qsptr<BoundingBox> ImportSVG::loadSVGFile(const QDomDocument& src,
     return result;
 }
 
-qsptr<BoundingBox> ImportSVG::loadSVGFile(
-        const QByteArray& src,
-        const GradientCreator& gradientCreator) {
-    QDomDocument document;
-    if(!document.setContent(src))
-        RuntimeThrow("Cannot set file as QDomDocument content");
-    return loadSVGFile(document, gradientCreator);
-}
-
 qsptr<BoundingBox> ImportSVG::loadSVGFile(
         QIODevice* const src,
         const GradientCreator& gradientCreator) {
-    QDomDocument document;
-    if(!document.setContent(src))
-        RuntimeThrow("Cannot set file as QDomDocument content");
-    return loadSVGFile(document, gradientCreator);
+    return loadSVGFile(src->readAll(), gradientCreator);
 }
 
 qsptr<BoundingBox> ImportSVG::loadSVGFile(
@@ -1260,7 +1418,7 @@ QString stripPx(const QString& val) {
     return res.remove("px").remove("pt").remove("em").trimmed();
 }
 
-void BoxSvgAttributes::loadBoundingBoxAttributes(const QDomElement &element) {
+void BoxSvgAttributes::loadBoundingBoxAttributes(const SvgElement &element) {
     QList<SvgAttribute> styleAttributes;
     const QString styleAttributesStr = element.attribute("style");
     extractSvgAttributes(styleAttributesStr, &styleAttributes);
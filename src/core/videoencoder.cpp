@@ -28,6 +28,8 @@
 #include "Boxes/boxrendercontainer.h"
 #include "CacheHandlers/sceneframecontainer.h"
 #include "canvas.h"
+#include "skia/pixelkernels.h"
+#include "Tasks/renderprofiler.h"
 
 #define AV_RuntimeThrow(errId, message) \
 { \
@@ -284,24 +286,16 @@ static AVFrame *getVideoFrame(OutputStream * const ost,
         RuntimeThrow("Image size don't match codec size");
     }
 
-    /* rely on cache manager to produce fSwsCtx if it hasn't already
-     * been produced. */
-    ost->fSwsCtx = sws_getCachedContext(ost->fSwsCtx,
-                                        c->width, c->height,
-                                        AV_PIX_FMT_RGBA,
-                                        c->width, c->height,
-                                        c->pix_fmt, SWS_BICUBIC,
-                                        nullptr, nullptr, nullptr);
-    if (!ost->fSwsCtx) {
-        RuntimeThrow("Cannot initialize the conversion context");
-    }
-
     SkPixmap pixmap;
-    SkBitmap unpremulBitmap;
-
     if (!image->peekPixels(&pixmap)) {
         RuntimeThrow("Could not peek image pixels");
     }
+    const bool bgra = pixmap.colorType() == kBGRA_8888_SkColorType;
+    if (!bgra && pixmap.colorType() != kRGBA_8888_SkColorType) {
+        RuntimeThrow("Unsupported image color type");
+    }
+    const int width = pixmap.width();
+    const int height = pixmap.height();
 
     // check if we need to convert to "unpremultiplied"
     const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(c->pix_fmt);
@@ -309,34 +303,61 @@ static AVFrame *getVideoFrame(OutputStream * const ost,
     const bool unpremul = hasAlpha && (c->codec_id == AV_CODEC_ID_PNG ||
                                        c->codec_id == AV_CODEC_ID_VP9 ||
                                        c->codec_id == AV_CODEC_ID_VP8);
-    if (unpremul) {
-        SkImageInfo unpremulInfo = SkImageInfo::Make(pixmap.width(),
-                                                     pixmap.height(),
-                                                     kRGBA_8888_SkColorType,
-                                                     kUnpremul_SkAlphaType,
-                                                     pixmap.info().refColorSpace());
-        if (unpremulBitmap.tryAllocPixels(unpremulInfo)) {
-            const bool converted = image->readPixels(unpremulInfo,
-                                                     unpremulBitmap.getPixels(),
-                                                     unpremulBitmap.rowBytes(),
-                                                     0, 0);
-            if (converted) { unpremulBitmap.peekPixels(&pixmap); }
+    if (unpremul || bgra) {
+        // reuse the same buffer for every frame of the stream
+        auto& buffer = ost->fConvertBuffer;
+        const size_t rowBytes = static_cast<size_t>(width)*4;
+        buffer.resize(rowBytes*static_cast<size_t>(height));
+        for (int y = 0; y < height; y++) {
+            const uint8_t* src = static_cast<const uint8_t*>(pixmap.addr(0, y));
+            uint8_t * const dst = buffer.data() + y*rowBytes;
+            if (bgra) {
+                PixelKernels::swapRedBlue(src, dst, width);
+                src = dst;
+            }
+            if (unpremul) { PixelKernels::unpremultiply(src, dst, width); }
         }
+        const auto alphaType = unpremul ? kUnpremul_SkAlphaType :
+                                          pixmap.alphaType();
+        const auto info = SkImageInfo::Make(width, height,
+                                            kRGBA_8888_SkColorType, alphaType,
+                                            pixmap.info().refColorSpace());
+        pixmap.reset(info, buffer.data(), rowBytes);
     }
 
-    const uint8_t * const dstSk[] = {static_cast<uint8_t*>(pixmap.writable_addr())};
-    int linesizesSk[4];
-
-    av_image_fill_linesizes(linesizesSk, AV_PIX_FMT_RGBA, pixmap.width());
-    linesizesSk[0] = static_cast<int>(pixmap.rowBytes());
-
     const int ret = av_frame_make_writable(ost->fDstFrame) ;
     if (ret < 0) { AV_RuntimeThrow(ret, "Could not make AVFrame writable") }
 
-    sws_scale(ost->fSwsCtx, dstSk,
-              linesizesSk, 0, pixmap.height(),
-              ost->fDstFrame->data,
-              ost->fDstFrame->linesize);
+    if (c->pix_fmt == AV_PIX_FMT_YUV420P) {
+        PixelKernels::rgbaToYuv420p(static_cast<const uint8_t*>(pixmap.addr()),
+                                    static_cast<int>(pixmap.rowBytes()),
+                                    width, height,
+                                    ost->fDstFrame->data,
+                                    ost->fDstFrame->linesize);
+    } else {
+        /* rely on cache manager to produce fSwsCtx if it hasn't already
+         * been produced. */
+        ost->fSwsCtx = sws_getCachedContext(ost->fSwsCtx,
+                                            c->width, c->height,
+                                            AV_PIX_FMT_RGBA,
+                                            c->width, c->height,
+                                            c->pix_fmt, SWS_BICUBIC,
+                                            nullptr, nullptr, nullptr);
+        if (!ost->fSwsCtx) {
+            RuntimeThrow("Cannot initialize the conversion context");
+        }
+
+        const uint8_t * const dstSk[] = {static_cast<const uint8_t*>(pixmap.addr())};
+        int linesizesSk[4];
+
+        av_image_fill_linesizes(linesizesSk, AV_PIX_FMT_RGBA, width);
+        linesizesSk[0] = static_cast<int>(pixmap.rowBytes());
+
+        sws_scale(ost->fSwsCtx, dstSk,
+                  linesizesSk, 0, height,
+                  ost->fDstFrame->data,
+                  ost->fDstFrame->linesize);
+    }
 
     ost->fDstFrame->pts = ost->fNextPts++;
 
@@ -820,6 +841,7 @@ void VideoEncoder::process() {
             const auto contRange = cacheCont->getRange()*_mRenderRange;
             const int nFrames = contRange.span();
             const sk_sp<SkImage> image = cacheCont->getImage();
+            RenderProfiler::Scope scope("hdd", "encode video frame");
             try {
                 writeVideoFrame(mFormatContext, &mVideoStream,
                                 image, &hasVideo);
@@ -842,6 +864,7 @@ void VideoEncoder::process() {
         }
         const bool encodeAudio = mEncodeAudio && hasAudio && audioAligned;
         if(encodeAudio) {
+            RenderProfiler::Scope scope("hdd", "encode audio");
             try {
                 processAudioStream(mFormatContext, &mAudioStream,
                                    mSoundIterator, &hasAudio);
@@ -30,6 +30,7 @@
 
 #include <QString>
 #include <QList>
+#include <vector>
 #include "skia/skiaincludes.h"
 #include "Tasks/updatable.h"
 #include "renderinstancesettings.h"
@@ -170,6 +171,8 @@ typedef struct CORE_EXPORT OutputStream {
     struct SwrContext *fSwrCtx = nullptr;
     // Cached per-frame duration in stream time_base ticks
     int64_t fFrameDuration = 0;
+    // RGBA (unpremultiplied if needed) copy of the frame being encoded
+    std::vector<uint8_t> fConvertBuffer;
 } OutputStream;
 
 class CORE_EXPORT VideoEncoderEmitter : public QObject {
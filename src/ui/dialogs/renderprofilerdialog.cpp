@@ -0,0 +1,198 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#include "renderprofilerdialog.h"
+
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QDir>
+#include <QIcon>
+
+#include "Tasks/renderprofiler.h"
+#include "appsupport.h"
+
+using namespace Friction::Ui;
+
+enum ProfilerColumn {
+    ColumnCategory,
+    ColumnName,
+    ColumnBox,
+    ColumnCount,
+    ColumnTotal,
+    ColumnAverage,
+    ColumnMax,
+    ColumnWait,
+    ColumnMemory
+};
+
+RenderProfilerDialog::RenderProfilerDialog(QWidget *parent)
+    : Dialog{parent}
+    , mTree(nullptr)
+    , mRecordButton(nullptr)
+    , mStatus(nullptr)
+    , mTimer(nullptr)
+{
+    setWindowTitle(tr("Render Profiler"));
+    setMinimumSize(800, 400);
+
+    const auto lay = new QVBoxLayout(this);
+    const auto footer = new QHBoxLayout();
+
+    mTree = new QTreeWidget(this);
+    mTree->setRootIsDecorated(false);
+    mTree->setAlternatingRowColors(true);
+    mTree->setSortingEnabled(true);
+    mTree->setHeaderLabels({tr("Type"),
+                            tr("Name"),
+                            tr("Layer"),
+                            tr("Count"),
+                            tr("Total (ms)"),
+                            tr("Average (ms)"),
+                            tr("Max (ms)"),
+                            tr("Queued (ms)"),
+                            tr("Memory (MB)")});
+    mTree->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    mTree->sortByColumn(ColumnTotal, Qt::DescendingOrder);
+
+    mRecordButton = new QPushButton(QIcon::fromTheme("play"),
+                                    tr("Record"),
+                                    this);
+    mRecordButton->setCheckable(true);
+    mRecordButton->setChecked(RenderProfiler::sEnabled());
+    mRecordButton->setToolTip(tr("Record render timings of the tasks, "
+                                 "effects and encoding"));
+
+    const auto clearButton = new QPushButton(QIcon::fromTheme("trash"),
+                                             QString(),
+                                             this);
+    clearButton->setToolTip(tr("Clear recorded timings"));
+
+    const auto exportButton = new QPushButton(QIcon::fromTheme("output"),
+                                              tr("Export"),
+                                              this);
+    exportButton->setToolTip(tr("Export timings as a Chrome trace, "
+                                "viewable in chrome://tracing or Perfetto"));
+
+    const auto closeButton = new QPushButton(QIcon::fromTheme("close"),
+                                             tr("Close"),
+                                             this);
+
+    mStatus = new QLabel(this);
+
+    mTimer = new QTimer(this);
+    mTimer->setInterval(1000);
+
+    connect(mRecordButton, &QPushButton::toggled,
+            this, &RenderProfilerDialog::setRecording);
+    connect(clearButton, &QPushButton::clicked,
+            this, [this]() {
+        RenderProfiler::sClear();
+        updateSummary();
+    });
+    connect(exportButton, &QPushButton::clicked,
+            this, &RenderProfilerDialog::exportTrace);
+    connect(closeButton, &QPushButton::clicked,
+            this, &QDialog::close);
+    connect(mTimer, &QTimer::timeout,
+            this, &RenderProfilerDialog::updateSummary);
+
+    footer->addWidget(mRecordButton);
+    footer->addWidget(clearButton);
+    footer->addWidget(exportButton);
+    footer->addWidget(mStatus);
+    footer->addStretch();
+    footer->addWidget(closeButton);
+
+    lay->addWidget(mTree);
+    lay->addLayout(footer);
+
+    if (RenderProfiler::sEnabled()) { mTimer->start(); }
+    updateSummary();
+}
+
+void RenderProfilerDialog::setRecording(const bool record)
+{
+    if (record) {
+        RenderProfiler::sStart();
+        mTimer->start();
+    } else {
+        RenderProfiler::sStop();
+        mTimer->stop();
+    }
+    updateSummary();
+}
+
+void RenderProfilerDialog::updateSummary()
+{
+    const auto summary = RenderProfiler::sSummary();
+
+    mTree->setSortingEnabled(false);
+    mTree->clear();
+    for (const auto& entry : summary) {
+        const auto item = new QTreeWidgetItem(mTree);
+        item->setText(ColumnCategory, QString::fromLatin1(entry.fCategory));
+        item->setText(ColumnName, QString::fromUtf8(entry.fName));
+        item->setText(ColumnBox, entry.fBox);
+        item->setData(ColumnCount, Qt::DisplayRole, entry.fCount);
+        if (entry.fTotal > 0) {
+            item->setData(ColumnTotal, Qt::DisplayRole,
+                          entry.fTotal/1000.);
+            item->setData(ColumnAverage, Qt::DisplayRole,
+                          entry.fTotal/1000./entry.fCount);
+            item->setData(ColumnMax, Qt::DisplayRole,
+                          entry.fMax/1000.);
+        }
+        if (entry.fWait > 0) {
+            item->setData(ColumnWait, Qt::DisplayRole,
+                          entry.fWait/1000./entry.fCount);
+        }
+        if (entry.fBytes > 0) {
+            item->setData(ColumnMemory, Qt::DisplayRole,
+                          entry.fBytes/1048576.);
+        }
+    }
+    mTree->setSortingEnabled(true);
+
+    const int dropped = RenderProfiler::sDroppedCount();
+    QString status = tr("%1 events").arg(RenderProfiler::sEventCount());
+    if (dropped > 0) { status += tr(", %1 dropped").arg(dropped); }
+    mStatus->setText(status);
+}
+
+void RenderProfilerDialog::exportTrace()
+{
+    const QString path = AppSupport::getSaveFile(this,
+                                                 tr("Export Render Trace"),
+                                                 QDir::homePath() +
+                                                 "/friction-trace.json",
+                                                 tr("Chrome Trace (*.json)"),
+                                                 "json");
+    if (path.isEmpty()) { return; }
+    if (!RenderProfiler::sExportChromeTrace(path)) {
+        QMessageBox::warning(this,
+                             tr("Export failed"),
+                             tr("Could not write %1").arg(path));
+    }
+}
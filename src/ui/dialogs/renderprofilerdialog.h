@@ -0,0 +1,59 @@
+/*
+#
+# Friction - https://friction.graphics
+#
+# Copyright (c) Ole-André Rodlie and contributors
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# See 'README.md' for more information.
+#
+*/
+
+#ifndef FRICTION_RENDER_PROFILER_DIALOG_H
+#define FRICTION_RENDER_PROFILER_DIALOG_H
+
+#include "ui_global.h"
+
+#include <QLabel>
+#include <QPushButton>
+#include <QTimer>
+#include <QTreeWidget>
+
+#include "dialog.h"
+
+namespace Friction
+{
+    namespace Ui
+    {
+        class UI_EXPORT RenderProfilerDialog : public Dialog
+        {
+            Q_OBJECT
+        public:
+            explicit RenderProfilerDialog(QWidget *parent = nullptr);
+
+        private:
+            void setRecording(const bool record);
+            void updateSummary();
+            void exportTrace();
+
+            QTreeWidget *mTree;
+            QPushButton *mRecordButton;
+            QLabel *mStatus;
+            QTimer *mTimer;
+        };
+    }
+}
+
+#endif // FRICTION_RENDER_PROFILER_DIALOG_H